@@ -11,17 +11,31 @@
 
 import os
 import sys
+import math
 import struct
+from StringIO import StringIO
 from optparse import OptionParser
 
 ##	The version value should be changed whenever the Animation format changes
 __version__ = 1
 
+##	Packs are .ani files whose frames are already decoded onto one sprite sheet
+PACK_VERSION = 2
+PACK_MAGIC = 0x4B415045 # "EPAK"
+PACK_HEADER = "<BBBBIHHI"
+PACK_FRAME = "<HHHH"
+PACK_RAW = 0
+PACK_LZ4 = 1
+
 USAGE = """
 pass .ani files to unpack into folders:
 	%prog [ANIMATION ...]
 or pass folders fo construct .ani files:
 	%prog [FOLDER ..]
+or turn .ani files, folders and .png files into packs, which load faster:
+	%prog --pack [ANIMATION|FOLDER|PNG ...]
+
+Packs need the Python Imaging Library; --lz4 also needs the lz4 module.
 
 Animation Folders should contain:
 	*.png files
@@ -42,6 +56,8 @@ def Parse():
 	# Printing
 	parser.add_option("-p", "--packed", dest='format', action='store_const', const='file', help="Create packed .ani files")
 	parser.add_option("-u", "--unpacked", dest='format', action='store_const', const='folder', help="Create unpacked Animation folders")
+	parser.add_option("-k", "--pack", dest='format', action='store_const', const='pack', help="Create .ani packs of pre-decoded frames")
+	parser.add_option("--lz4", default=False, action="store_true", help="Compress the frames of packs")
 	# Printing
 	parser.add_option("-v", "--verbose", default=False, action="store_true", help="Lots of output")
 	parser.add_option("-q", "--quiet", dest='verbose', action="store_true", help="No output")
@@ -79,6 +95,10 @@ class Animation:
 				self.fromFolder(source)
 				# into a .ani file (by default)
 				self.save = self.toFile
+			elif source.lower().endswith(".png"):
+				# A single image is a one frame Animation
+				self.fromPNG(source)
+				self.save = self.toPack
 			else:
 				# Unpack a .ani file
 				self.fromFile(source)
@@ -120,6 +140,11 @@ class Animation:
 		file = open(filename,'rb')
 		# Get header
 		self.version = ord( file.read(1) )
+		if self.version == PACK_VERSION:
+			file.seek(0)
+			self.fromPack(file)
+			file.close()
+			return
 		if self.version != __version__:
 			print "WARNING: version %d is unknown!" % self.version
 		self.count = ord( file.read(1) )
@@ -134,6 +159,43 @@ class Animation:
 			self.order.append(framename)
 			self.frames[framename] = data
 
+	##	Collect Animation data from a pack
+	def fromPack(self, file):
+		from PIL import Image
+		size = struct.calcsize(PACK_HEADER)
+		version, self.count, self.delay, compression, magic, sheetW, sheetH, dataSize = struct.unpack(PACK_HEADER, file.read(size))
+		if magic != PACK_MAGIC:
+			print "ERROR: %s is not an animation pack." % self.name
+			sys.exit(6)
+		self.version = __version__
+		regions = []
+		for i in range(self.count):
+			regions.append( struct.unpack(PACK_FRAME, file.read(struct.calcsize(PACK_FRAME))) )
+		data = file.read(dataSize)
+		if compression == PACK_LZ4:
+			import lz4.block
+			data = lz4.block.decompress(data, uncompressed_size=sheetW*sheetH*4)
+		sheet = Image.frombytes("RGBA", (sheetW, sheetH), data)
+		self.order = []
+		self.frames = {}
+		for i,(x,y,w,h) in enumerate(regions):
+			framename = "%s_%03d.png" % (self.name, i)
+			png = StringIO()
+			sheet.crop((x, y, x+w, y+h)).save(png, "PNG")
+			self.order.append(framename)
+			self.frames[framename] = png.getvalue()
+
+	##	Collect Animation data from a single image
+	def fromPNG(self, filename):
+		self.name = os.path.splitext( os.path.basename( filename ) )[0]
+		self.version = __version__
+		self.delay = 0
+		file = open(filename, 'rb')
+		self.order = [ os.path.basename( filename ) ]
+		self.frames = { self.order[0]: file.read() }
+		file.close()
+		self.count = 1
+
 	##	Collect Animation data from an unpacked folder
 	def fromFolder(self, foldername ):
 		if not os.path.exists(foldername):
@@ -180,7 +242,7 @@ class Animation:
 				print "Unknown file '%s'" % filename
 				continue
 			filepath = os.path.join(foldername,filename)
-			file = open(filepath)
+			file = open(filepath, 'rb')
 			data = file.read()
 			file . close()
 			self.frames[filename] = data
@@ -209,6 +271,51 @@ class Animation:
 			file . write( frame ) 
 		file.close()
 
+	##	Create a pack
+	#
+	#	The frames are decoded and laid out in a grid on one RGBA sprite
+	#	sheet, so that Epiar can upload them as a single texture.
+	def toPack(self, verbose=False, force=False, lz4=False):
+		""" Save an animation as a pack of decoded frames """
+		from PIL import Image
+		filename = self.name
+		filename += ".ani"
+		if os.path.exists( filename ):
+			if force:
+				forceRemove( filename )
+			else:
+				print "ERROR: File %s already exists. Use '--force' to overwrite." % filename
+				sys.exit(4)
+		if verbose:
+			print "Creating Animation pack: %s" % filename
+		images = [ Image.open( StringIO( self.frames[framename] ) ).convert("RGBA") for framename in self.order ]
+		cellW = max( [ image.size[0] for image in images ] )
+		cellH = max( [ image.size[1] for image in images ] )
+		columns = int( math.ceil( math.sqrt( len(images) ) ) )
+		rows = int( math.ceil( len(images) / float(columns) ) )
+		sheetW, sheetH = columns * cellW, rows * cellH
+		if sheetW > 65535 or sheetH > 65535:
+			print "ERROR: The frames of %s don't fit on one sprite sheet." % self.name
+			sys.exit(7)
+		sheet = Image.new("RGBA", (sheetW, sheetH), (0, 0, 0, 0))
+		regions = []
+		for i,image in enumerate(images):
+			x, y = (i % columns) * cellW, (i / columns) * cellH
+			sheet.paste(image, (x, y))
+			regions.append( (x, y, image.size[0], image.size[1]) )
+		data = sheet.tobytes()
+		compression = PACK_RAW
+		if lz4:
+			import lz4.block
+			data = lz4.block.compress(data, store_size=False)
+			compression = PACK_LZ4
+		file = open( filename, "wb")
+		file . write( struct.pack(PACK_HEADER, PACK_VERSION, len(images), self.delay, compression, PACK_MAGIC, sheetW, sheetH, len(data)) )
+		for region in regions:
+			file . write( struct.pack(PACK_FRAME, *region) )
+		file . write( data )
+		file.close()
+
 	##	Create an unpacked folder
 	def toFolder(self, verbose=False, force=False):
 		""" Save an animation as a folder """
@@ -286,6 +393,10 @@ def main():
 				if opts.verbose:
 					print "Using the Animation folder format..."
 				ani.toFolder(verbose=opts.verbose, force=opts.force)
+			elif opts.format == 'pack':
+				if opts.verbose:
+					print "Using the Animation pack format..."
+				ani.toPack(verbose=opts.verbose, force=opts.force, lz4=opts.lz4)
 			else:
 				ani.save(verbose=opts.verbose, force=opts.force)
 
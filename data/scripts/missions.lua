@@ -15,18 +15,19 @@ MissionType = {
 	end,
 	Accept = function( missionTable ) end, --- Call this when the Mission is accepted.
 	Reject = function( missionTable ) end, --- Call this when the Mission is rejected after being accepted.
-	Update = function( missionTable ) --- Call this each time that the Mission should be checked.
-		return nil --- Return nil when the mission isn't over yet.
-		return true --- Return true when the mission has succeded.
-		return false --- Return false when the mission has failed.
-	end,
-	Land = function( missionTable ) --- Call this each time that player lands
-		return nil --- Return nil when the mission isn't over yet.
-		return true --- Return true when the mission has succeded.
-		return false --- Return false when the mission has failed.
-	end,
 	Success = function( missionTable ) end, --- Call this if the Mission is a Success.
 	Failure = function( missionTable ) end, --- Call this if the Mission is a failure.
+
+	--- Everything below is optional. Only define the events that the Mission cares about.
+	--- Each of these returns nil while the mission isn't over, true on success and false on failure.
+	UpdateInterval = 1000, --- Milliseconds between Update calls. Without it Update runs every tick.
+	Update = function( missionTable ) end, --- Call this each time that the Mission should be checked.
+	Land = function( missionTable ) end, --- Call this each time that player lands
+	Jump = function( missionTable, sectorName ) end, --- Call this when the player arrives in a new sector.
+	Kill = function( missionTable, spriteID ) end, --- Call this when a ship is destroyed or leaves the sector.
+	NewDay = function( missionTable ) end, --- Call this when the Calendar period changes.
+	Arrive = function( missionTable ) end, --- Call this when the player enters missionTable.Watch,
+	                                       --- either { id = spriteID, radius = r } or { x = x, y = y, radius = r }.
 }
 
 --]]
@@ -110,8 +111,6 @@ ReturnAmbassador = {
 		--for i=1,#rejections do print(rejections[i]) end
 		UI.newAlert( "The "..missionTable.profession..", "..f('"%s"',choose(rejections)) )
 	end,
-	Update = function( missionTable )
-	end,
 	Land = function( missionTable )
 		local x,y = PLAYER:GetPosition()
 		local p = Planet.Get( missionTable.planet )
@@ -185,6 +184,7 @@ DestroyPirate = {
 	Reject = function( missionTable )
 		
 	end,
+	UpdateInterval = 5000,
 	Update = function( missionTable )
 		if missionTable.ship == nil then
 			return false -- Error
@@ -197,7 +197,10 @@ DestroyPirate = {
 			end
 		end
 	end,
-	Land = function(missionTable)
+	Kill = function( missionTable, id )
+		if id == missionTable.ship then
+			return true
+		end
 	end,
 	Success = function( missionTable )
 		UI.newAlert(string.format("Thank you for destroying %s!", missionTable.piratename) )
@@ -286,8 +289,6 @@ CollectArtifacts = {
 		rejectMessage = rejectMessage:format( missionTable.EnemyAlliance, missionTable.Actors )
 		UI.newAlert( rejectMessage  )
 	end,
-	Update = function( missionTable )
-	end,
 	Land = function( missionTable )
 		local totalFound = 0
 		local x,y = PLAYER:GetPosition()
@@ -376,6 +377,7 @@ ShippingRoutes = {
 		message = message:format( missionTable.Tonnage, missionTable.Commodity, missionTable.Planet )
 		UI.newAlert( message )
 	end,
+	UpdateInterval = 1000,
 	Update = function( missionTable )
 		-- Check if the Player still has all the cargo
 		local currentCargo, stored, storable = PLAYER:GetCargo()
@@ -453,17 +455,16 @@ DestroyGaryTheGold = {
 		UI.newAlert( "Gary may never be stopped" )
 		local p = Planet.Get( missionTable.planet )
 	end,
-	Update = function( missionTable )
+	Kill = function( missionTable, id )
+		if id ~= missionTable.garyID and id ~= missionTable.escortID then
+			return nil
+		end
 		local gary = Epiar.getSprite( missionTable.garyID )
 		local escort = Epiar.getSprite( missionTable.escortID )
-		if gary == nil and escort == nil then
+		if (gary == nil or id == missionTable.garyID) and (escort == nil or id == missionTable.escortID) then
 			return true
-		else
-			-- do nothing
 		end
 	end,
-	Land = function( missionTable )
-	end,
 	Success = function( missionTable )
 		UI.newAlert("Thank you for destroying Gary the Gold!")
 		addcredits(missionTable.reward)
@@ -546,10 +547,10 @@ ProtectFreighter = {
 		Fleets:unjoin( PLAYER:GetID(), missionTable.freighter )
 		local p = Planet.Get( missionTable.planet )
 	end,
-	Update = function( missionTable )
-		local freighter = Epiar.getSprite( missionTable.freighter )
+	Kill = function( missionTable, id )
 		-- Check that the Freighter is still alive
-		if freighter ~= nil then
+		if id == missionTable.freighter then
+			UI.newAlert( (string.format("%s was destroyed! Mission failed.", missionTable.freighterName) ) )
 			return false
 		end
 	end,
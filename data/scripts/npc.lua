@@ -4,7 +4,7 @@
 An AI StateMachine must have the form:
 
 StateMachine = {
-	State = function(id,x,y,angle,speed,vector) ... end,
+	State = function(id,x,y,angle,speed,vector,ai,ship) ... end,
 	...
 }
 
@@ -12,24 +12,77 @@ All StateMachines must have a "default" state.  This is their initial state.
 States transition by returning a string of the new State's name.
 States that do not return new state names will stay in the same state.
 
+Each NPC runs its StateMachine inside its own coroutine (see RunStateMachine).
+The 'ai' argument is that NPC's entry in AIData and 'ship' is the NPC itself,
+so States should use these rather than looking them up by id every tick.
+A State may call coroutine.yield() to wait for the next tick, which returns
+the fresh x, y, angle, speed and vector.
+
+Routine movement should be delegated to the native ship behaviors rather than
+being built out of Rotate and Accelerate calls:
+
+	ship:TravelTo(id or x,y, radius)    -- true once within radius
+	ship:DockAndWait()                  -- true once stopped and done docking
+	ship:Orbit(id or x,y, near, far)    -- returns the distance to the center
+	ship:Attack(targetID, standoff, fire) -- returns the distance, nil if the target is gone
+	ship:Flee(id or x,y, radius)        -- true once beyond radius
+
 --]]
 
 -- Table which stores data about each NPC indexed by ID, e.g. AIData[npc_id] = { data specific to AI behavior goes here}
 -- This table is not stored to disk on game save.
 AIData = {}
 
-function FindADestination(id, x, y, angle, speed, vector)
-	-- Choose a planet
-	local cur_ship = Epiar.getSprite(id)
+--- Drives the StateMachine of a single NPC.
+-- The engine runs this as a coroutine, one per NPC, and resumes it once per
+-- tick with the NPC's position.  It yields the name of the current State
+-- whenever it changes so that the engine can display it.
+function RunStateMachine(id, machineName, stateName)
+	local machine = _G[machineName]
+	if type(machine) ~= "table" then
+		error( string.format("There is no State Machine named '%s'!", machineName) )
+	end
+	if machine[stateName] == nil then
+		stateName = "default"
+	end
+	local state = machine[stateName]
+	if state == nil then
+		error( string.format("The State Machine '%s' has no default state.", machineName) )
+	end
+
+	local ship = Epiar.getSprite(id)
+	local ai = AIData[id]
+	if ai == nil then
+		ai = {}
+		AIData[id] = ai
+	end
 
-	--if AIData[id].destinationName ~= nil and AIData[id].alwaysGateTravel == true then
-	--	return GateTraveler.ComputingRoute(id,x,y,angle,speed,vector)
+	local x, y, angle, speed, vector = coroutine.yield(stateName)
+	while true do
+		local nextName = state(id, x, y, angle, speed, vector, ai, ship)
+		if nextName ~= nil and nextName ~= stateName then
+			state = machine[nextName]
+			if state == nil then
+				error( string.format("The State Machine '%s' has no state '%s'. Could not transition from '%s'.", machineName, nextName, stateName) )
+			end
+			stateName = nextName
+			x, y, angle, speed, vector = coroutine.yield(stateName)
+		else
+			x, y, angle, speed, vector = coroutine.yield()
+		end
+	end
+end
+
+function FindADestination(id, x, y, angle, speed, vector, ai, cur_ship)
+	-- Choose a planet
+	--if ai.destinationName ~= nil and ai.alwaysGateTravel == true then
+	--	return GateTraveler.ComputingRoute(id, x, y, angle, speed, vector, ai, cur_ship)
 	--end
 
 	local planetNames = Epiar.planetNames()
 	local destination = Planet.Get(planetNames[ math.random(#planetNames) ])
-	AIData[id].destination = destination:GetID()
-	AIData[id].destinationName = destination:GetName()
+	ai.destination = destination:GetID()
+	ai.destinationName = destination:GetName()
 
 	return "Travelling"
 end
@@ -91,77 +144,44 @@ end
 
 --- Hunter AI
 Hunter = {
-	default = function(id, x, y, angle, speed, vector)
-		if AIData[id] == nil then
-			AIData[id] = { }
-		end
-		if AIData[id].foundTarget == 1 then
-			AIData[id].hostile = 0
-			AIData[id].foundTarget = 0
+	default = function(id, x, y, angle, speed, vector, ai, cur_ship)
+		if ai.foundTarget == 1 then
+			ai.hostile = 0
+			ai.foundTarget = 0
 		end
 		return "New_Planet"
 	end,
 	New_Planet = FindADestination,
 
-	Hunting = function(id, x, y, angle, speed, vector)
+	Hunting = function(id, x, y, angle, speed, vector, ai, cur_ship)
 		-- Approach the target
-		local cur_ship = Epiar.getSprite(id)
-		local tx, ty, dist
-		local target = Epiar.getSprite( AIData[id].target )
-		if target ~= nil then
-			tx,ty = target:GetPosition()
-			dist = distfrom(tx, ty, x, y)
-		else
-			AIData[id].hostile = 0
+		local dist = cur_ship:Attack( ai.target, 0, false )
+		if dist == nil then
+			ai.hostile = 0
 			return "default"
 		end
 
-		cur_ship:Rotate( cur_ship:directionTowards(tx, ty) )
-
-		if math.abs(cur_ship:directionTowards(tx, ty)) == 0 then
-			cur_ship:Accelerate()
-		end
-
 		if dist < 400 then
 			return "Killing"
 		end
-		if dist > 1000 and AIData[id].hostile == 0 then
+		if dist > 1000 and ai.hostile == 0 then
 			return "default"
 		end
 
 		return "Hunting"
 	end,
-	Killing = function(id,x,y,angle,speed,vector)
+	Killing = function(id, x, y, angle, speed, vector, ai, cur_ship)
 		-- Attack the target
-		local cur_ship = Epiar.getSprite(id)
-		local tx,ty,dist
-		local target = Epiar.getSprite( AIData[id].target )
-		if target==nil or target:GetHull()==0 then
+		local dist = cur_ship:Attack( ai.target, 200, true )
+		if dist == nil then
 			--The AI has destroyed the enemy.
 			return "default"
-		else
-			tx,ty = target:GetPosition()
-			dist = distfrom(tx,ty,x,y)
 		end
 
-		if AIData[id].hostile == 1 and AIData[id].foundTarget == 0 then
-			AIData[id].foundTarget = 1
-			local machine, state = cur_ship:GetState()
+		if ai.hostile == 1 and ai.foundTarget == 0 then
+			ai.foundTarget = 1
 		end
 
-		cur_ship:Rotate( cur_ship:directionTowards(tx,ty) )
-		local fireResult = cur_ship:FirePrimary( AIData[id].target )
-
-		-- if this firing group isn't doing anything, switch
-		if fireResult == 3 or fireResult == 4 then -- FireNoAmmo or FireEmptyGroup
-			cur_ship:FireSecondary()
-		end
-		
-		if dist>200 then
-			if cur_ship:directionTowards(tx,ty) == 0 then
-				cur_ship:Accelerate()
-			end
-		end
 		if dist>300 then
 			return "Hunting"
 		end
@@ -169,31 +189,26 @@ Hunter = {
 
 	--ComputingRoute = GateTraveler.ComputingRoute,
 	--GateTravelling = GateTraveler.GateTravelling,
-	Travelling = function(id,x,y,angle,speed,vector)
+	Travelling = function(id, x, y, angle, speed, vector, ai, cur_ship)
 		-- Find a new target
-		local cur_ship = Epiar.getSprite(id)
 		local closeShip= Epiar.nearestShip(cur_ship,1000)
 		local targetShip= nil
-		if AIData[id].target ~= nil then targetShip = Epiar.getSprite(AIData[id].target) end
+		if ai.target ~= nil then targetShip = Epiar.getSprite(ai.target) end
 
-		if targetShip~=nil and okayTarget(cur_ship, targetShip) and AIData[id].hostile == 1 then
+		if targetShip~=nil and okayTarget(cur_ship, targetShip) and ai.hostile == 1 then
 			return "Hunting"
 		elseif closeShip~=nil and okayTarget(cur_ship, closeShip) then
-			AIData[id].hostile = 0
-			AIData[id].target = closeShip:GetID()
+			ai.hostile = 0
+			ai.target = closeShip:GetID()
 			return "Hunting"
 		end
 
 
-		--print (string.format ("%s %s not hunting anything target %d\n", cur_ship:GetState(), AIData[id].target))
+		--print (string.format ("%s %s not hunting anything target %d\n", cur_ship:GetState(), ai.target))
 
-		AIData[id].hostile = 0
+		ai.hostile = 0
 
-		local p = Epiar.getSprite( AIData[id].destination )
-		local px,py = p:GetPosition()
-		cur_ship:Rotate( cur_ship:directionTowards(px,py) )
-		cur_ship:Accelerate()
-		if distfrom(px,py,x,y) < 800 then
+		if cur_ship:TravelTo( ai.destination, 800 ) ~= false then
 			return "New_Planet"
 		end
 	end,
@@ -201,15 +216,10 @@ Hunter = {
 
 --- Trader AI
 Trader = {
-	default = function(id, x, y, angle, speed, vector, state)
+	default = function(id, x, y, angle, speed, vector, ai, cur_ship)
 		--io.write("Trader.default running ...")
 		--io.flush()
-		if AIData[id] == nil then AIData[id] = { } end
-
-		AIData[id].dockingCompleteTimestamp = 0
-		AIData[id].jumping = 0
-
-		local cur_ship = Epiar.getSprite(id)
+		ai.jumping = 0
 
 		local traderNames = { "S.S. Epiar", "S.S. Honorable", "S.S. Marvelous", "S.S. Delight",
 					"S.S. Honeycomb", "S.S. Woodpecker", "S.S. Crow", "S.S. Condor",
@@ -224,12 +234,12 @@ Trader = {
 	end,
 	Hunting = Hunter.Hunting,
 	Killing = Hunter.Killing,
-	-- Docking = function(id, x, y, angle, speed, vector)
-	-- 	if AIData[id].hostile == 1 then return "Hunting" end
+	-- Docking = function(id, x, y, angle, speed, vector, ai, cur_ship)
+	-- 	if ai.hostile == 1 then return "Hunting" end
 
 	-- 	-- Stop on this planet
 	-- 	local cur_ship = Epiar.getSprite(id)
-	-- 	local p = Epiar.getSprite( AIData[id].destination )
+	-- 	local p = Epiar.getSprite( ai.destination )
 
 	-- 	local px,py = p:GetPosition()
 	-- 	local dist = distfrom(px, py, x, y)
@@ -246,98 +256,57 @@ Trader = {
 	-- end,
 	--ComputingRoute = GateTraveler.ComputingRoute,
 	--GateTravelling = GateTraveler.GateTravelling,
-	Travelling = function(id, x, y, angle, speed, vector)
-		if AIData[id].hostile == 1 then return "Hunting" end
+	Travelling = function(id, x, y, angle, speed, vector, ai, cur_ship)
+		if ai.hostile == 1 then return "Hunting" end
 
 		-- Get to the planet
-		local cur_ship = Epiar.getSprite(id)
-
-		local s = Epiar.getSprite( AIData[id].destination )
-		if s == nil then return "New_Planet" end
+		local arrived = cur_ship:TravelTo( ai.destination, 300 )
 
-		local sx, sy = s:GetPosition()
-
-		cur_ship:Rotate( cur_ship:directionTowards(sx, sy) )
-		cur_ship:Accelerate()
-
-		--if id == 6 then
-		--	io.write("Trader["..id.."] at ("..x..","..y..") heading toward ("..sx..","..sy..")\n")
-		--	io.flush()
-		--end
-
-		if distfrom(sx, sy, x, y) < 300 then
+		if arrived == nil then return "New_Planet" end
+		if arrived then
 			return "Docking"
 		end
 	end,
-	Docking = function(id, x, y, angle, speed, vector, state)
-		local cur_ship = Epiar.getSprite(id)
-
-		if cur_ship:GetMomentumSpeed() ~= 0 then
-			-- if id == 6 then
-			-- 	io.write("Trader["..id.."] slowing down...\n")
-			-- 	io.flush()
-			-- end
-			-- Need to slow down ...
-			cur_ship:Decelerate()
-		elseif AIData[id].dockingCompleteTimestamp == 0 then
-			-- if id == 6 then
-			-- 	io.write("Trader["..id.."] setting dock duration...\n")
-			-- 	io.flush()
-			-- end
-			-- No longer moving, time to dock
-			AIData[id].dockingCompleteTimestamp = cur_ship:Dock()
-		else
-			-- io.write("Trader["..id.."] waiting dock duration...\n")
-			-- io.flush()
-			local ticks = Timer.GetTicks()
-			-- io.write("ticks is "..ticks.."\n")
-			-- io.flush()
-			if ticks > AIData[id].dockingCompleteTimestamp then
-				-- Done waiting, change state
-				AIData[id].dockingCompleteTimestamp = 0
-				return "Jump_Away"
-			end
-			-- Wait the docking duration, then change state from 'Docking'
+	Docking = function(id, x, y, angle, speed, vector, ai, cur_ship)
+		-- Slow down, then wait the docking duration
+		if cur_ship:DockAndWait() then
+			return "Jump_Away"
 		end
 
 	end,
 	New_Planet = FindADestination,
-	Jump_Away = function(id, x, y, angle, speed, vector, state)
+	Jump_Away = function(id, x, y, angle, speed, vector, ai, cur_ship)
 		-- If we're not already jumping ...
-		if AIData[id].jumping == 0 then
-			local cur_ship = Epiar.getSprite(id)
-
+		if ai.jumping == 0 then
 			-- Ensure we have jumpable coordinates to travel to
-			if AIData[id].jumpableCoordX == nil then
+			if ai.jumpableCoordX == nil then
 				local jx, jy = cur_ship:GetJumpableCoordinates()
-				AIData[id].jumpableCoordX = jx
-				AIData[id].jumpableCoordY = jy
+				ai.jumpableCoordX = jx
+				ai.jumpableCoordY = jy
 			end
 
 			-- Head toward the jumpable coordinates ...
-			cur_ship:Rotate( cur_ship:directionTowards(AIData[id].jumpableCoordX, AIData[id].jumpableCoordY) )
-			cur_ship:Accelerate()
+			cur_ship:TravelTo( ai.jumpableCoordX, ai.jumpableCoordY, 0 )
 
 			-- Constantly try jumping
 			local jumpStarted = cur_ship:Jump()
 			if jumpStarted == 1 then
-				AIData[id].jumping = 1
-				AIData[id].jumpableCoordX = nil
-				AIData[id].jumpableCoordY = nil
+				ai.jumping = 1
+				ai.jumpableCoordX = nil
+				ai.jumpableCoordY = nil
 			end
 		end
 	end
 }
 
 Patrol = {
-	default = function(id,x,y,angle,speed,vector)
-		local cur_ship = Epiar.getSprite(id)
-		AIData[id] = {}
+	default = function(id, x, y, angle, speed, vector, ai, cur_ship)
+		for key in pairs(ai) do ai[key] = nil end
 		destination = Epiar.nearestPlanet(cur_ship, 4096)
 		if destination == nil then
 			return "New_Planet"
 		end
-	  	AIData[id].destination = destination:GetID()
+	  	ai.destination = destination:GetID()
 		return "Travelling"
 	end,
 	New_Planet = FindADestination,
@@ -345,28 +314,19 @@ Patrol = {
 	Killing = Hunter.Killing,
 	--ComputingRoute = GateTraveler.ComputingRoute,
 	--GateTravelling = GateTraveler.GateTravelling,
-	Travelling = function(id,x,y,angle,speed,vector)
-		if AIData[id].hostile == 1 then return "Hunting" end
-		local cur_ship = Epiar.getSprite(id)
-		local p = Epiar.getSprite( AIData[id].destination )
-		if p == nil then return "default" end
-		local px,py = p:GetPosition()
-		cur_ship:Rotate( cur_ship:directionTowards(px,py) )
-		cur_ship:Accelerate()
-		if distfrom(px,py,x,y) < 1000 then
+	Travelling = function(id, x, y, angle, speed, vector, ai, cur_ship)
+		if ai.hostile == 1 then return "Hunting" end
+		local arrived = cur_ship:TravelTo( ai.destination, 1000 )
+		if arrived == nil then return "default" end
+		if arrived then
 			return "Orbiting"
 		end
 	end,
-	Orbiting = function(id, x, y, angle, speed, vector)
-		if AIData[id].hostile == 1 then return "Hunting" end
+	Orbiting = function(id, x, y, angle, speed, vector, ai, cur_ship)
+		if ai.hostile == 1 then return "Hunting" end
 
-		local cur_ship = Epiar.getSprite(id)
-		local p = Epiar.getSprite( AIData[id].destination )
-		local px,py = p:GetPosition()
-		local dist = distfrom(px, py, x, y)
-
-		cur_ship:Accelerate()
-		cur_ship:Rotate( cur_ship:directionTowards(px,py) +90)
+		local dist = cur_ship:Orbit( ai.destination, 500, 1500 )
+		if dist == nil then return "default" end
 
 		if dist > 1500 then
 			return "TooFar"
@@ -383,7 +343,7 @@ Patrol = {
 
 			-- Kill all Agressive Hunters and Pirates
 			if machine == "Hunter" or machine == "Pirate" then
-				AIData[id].target = ship:GetID()
+				ai.target = ship:GetID()
 				return "Hunting"
 			elseif machine == "Escort" then
 				-- If the Escort's leader is a Hunter or Pirate, kill the Escort
@@ -391,31 +351,25 @@ Patrol = {
 				local machine, state = leader:GetState()
 
 				if machine == "Hunter" or machine == "Pirate" then
-					AIData[id].target = ship:GetID()
+					ai.target = ship:GetID()
 					return "Hunting"
 				end
 			end
 		end
 	end,
-	TooClose = function(id,x,y,angle,speed,vector)
-		if AIData[id].hostile == 1 then return "Hunting" end
-		local cur_ship = Epiar.getSprite(id)
-		local p = Epiar.getSprite( AIData[id].destination )
-		local px,py = p:GetPosition()
-		cur_ship:Rotate( - cur_ship:directionTowards(px,py) )
-		cur_ship:Accelerate()
-		if distfrom(px,py,x,y) > 800 then
+	TooClose = function(id, x, y, angle, speed, vector, ai, cur_ship)
+		if ai.hostile == 1 then return "Hunting" end
+		local safe = cur_ship:Flee( ai.destination, 800 )
+		if safe == nil then return "default" end
+		if safe then
 			return "Orbiting"
 		end
 	end,
-	TooFar = function(id,x,y,angle,speed,vector)
-		if AIData[id].hostile == 1 then return "Hunting" end
-		local cur_ship = Epiar.getSprite(id)
-		local p = Epiar.getSprite( AIData[id].destination )
-		local px,py = p:GetPosition()
-		cur_ship:Rotate( cur_ship:directionTowards(px,py) )
-		cur_ship:Accelerate()
-		if distfrom(px,py,x,y) < 1300 then
+	TooFar = function(id, x, y, angle, speed, vector, ai, cur_ship)
+		if ai.hostile == 1 then return "Hunting" end
+		local arrived = cur_ship:TravelTo( ai.destination, 1300 )
+		if arrived == nil then return "default" end
+		if arrived then
 			return "Orbiting"
 		end
 	end,
@@ -433,15 +387,14 @@ Bully = {
 	Hunting = Hunter.Hunting,
 	Killing = Hunter.Killing,
 
-	Orbiting = function(id,x,y,angle,speed,vector)
-		if AIData[id].hostile == 1 then return "Hunting" end
-		local cur_ship = Epiar.getSprite(id)
-		local p = Epiar.getSprite( AIData[id].destination )
+	Orbiting = function(id, x, y, angle, speed, vector, ai, cur_ship)
+		if ai.hostile == 1 then return "Hunting" end
+		local p = Epiar.getSprite( ai.destination )
 		local px,py = p:GetPosition()
 		local dist = distfrom(px,py,x,y)
 		local ship= Epiar.nearestShip(cur_ship,900)
 		if (ship~=nil) and (ship:GetID() ~= id) and (ship:GetHull() <= 0.9) and (okayTarget(cur_ship, ship)) then
-			AIData[id].target = ship:GetID()
+			ai.target = ship:GetID()
 			return "Hunting"
 		end
 
@@ -451,97 +404,91 @@ Bully = {
 		if dist < 500 then
 			return "TooClose"
 		end
-		cur_ship:Rotate( cur_ship:directionTowards(px,py) +90)
-		cur_ship:Accelerate()
+		cur_ship:Orbit( ai.destination, 500, 1500 )
 	end,
 }
 
 Pirate = Hunter
 
 Escort = {
-	default = function(id,x,y,angle,speed,vector)
-		if AIData[id] == nil then
-			AIData[id] = { }
-			AIData[id].accompany = -1
+	default = function(id, x, y, angle, speed, vector, ai, cur_ship)
+		if ai.accompany == nil then
+			ai.accompany = -1
 		end
-		AIData[id].target = -1
-
-		local cur_ship = Epiar.getSprite(id)
+		ai.target = -1
 
-		if AIData[id].initFor ~= nil then
+		if ai.initFor ~= nil then
 			-- -1 in the pay field means "don't check / don't alter"
-			Epiar.getSprite(AIData[id].initFor):AddHiredEscort(cur_ship:GetModelName(), -1, id)
+			Epiar.getSprite(ai.initFor):AddHiredEscort(cur_ship:GetModelName(), -1, id)
 		end
 
 		-- Create some variation in how escort pilots behave
-		local mass = Epiar.getSprite(id):GetMass()
-		AIData[id].farThreshold = 225 * mass + math.random(50)
-		AIData[id].nearThreshold = 100 * mass + math.random(40)
+		local mass = cur_ship:GetMass()
+		ai.farThreshold = 225 * mass + math.random(50)
+		ai.nearThreshold = 100 * mass + math.random(40)
 
 		local myFleet = Fleets:getShipFleet(id)
 		if myFleet ~= nil then setAccompany(id, myFleet:getLeader() ) end
 
-		if AIData[id].accompany >= 0 then return "Accompanying" end
+		if ai.accompany >= 0 then return "Accompanying" end
 		return "New_Planet"
 	end,
 	--ComputingRoute = GateTraveler.ComputingRoute,
 	--GateTravelling = GateTraveler.GateTravelling,
-	Travelling = function(id,x,y,angle,speed,vector)
-		if AIData[id].accompany > -1 then return "Accompanying" end
-		return Patrol.Travelling(id,x,y,angle,speed,vector)
+	Travelling = function(id, x, y, angle, speed, vector, ai, cur_ship)
+		if ai.accompany > -1 then return "Accompanying" end
+		return Patrol.Travelling(id, x, y, angle, speed, vector, ai, cur_ship)
 	end,
 	New_Planet = FindADestination,
-	Orbiting = function(id,x,y,angle,speed,vector)
-		if AIData[id].accompany > -1 then return "Accompanying" end
-		return Patrol.Orbiting(id,x,y,angle,speed,vector)
+	Orbiting = function(id, x, y, angle, speed, vector, ai, cur_ship)
+		if ai.accompany > -1 then return "Accompanying" end
+		return Patrol.Orbiting(id, x, y, angle, speed, vector, ai, cur_ship)
 	end,
-	TooClose = function(id,x,y,angle,speed,vector)
-		if AIData[id].accompany > -1 then return "Accompanying" end
-		return Patrol.TooClose(id,x,y,angle,speed,vector)
+	TooClose = function(id, x, y, angle, speed, vector, ai, cur_ship)
+		if ai.accompany > -1 then return "Accompanying" end
+		return Patrol.TooClose(id, x, y, angle, speed, vector, ai, cur_ship)
 	end,
-	TooFar = function(id,x,y,angle,speed,vector)
-		if AIData[id].accompany > -1 then return "Accompanying" end
-		return Patrol.TooFar(id,x,y,angle,speed,vector)
+	TooFar = function(id, x, y, angle, speed, vector, ai, cur_ship)
+		if ai.accompany > -1 then return "Accompanying" end
+		return Patrol.TooFar(id, x, y, angle, speed, vector, ai, cur_ship)
 	end,
-	Hunting = function(id,x,y,angle,speed,vector)
+	Hunting = function(id, x, y, angle, speed, vector, ai, cur_ship)
 		local myFleet = Fleets:getShipFleet(id)
 		if myFleet ~= nil then
 			local prox = myFleet:fleetmateProx(id)
 			if prox ~= nil and prox < 45 then return "NewPattern" end
 		end
-		return Hunter.Hunting(id,x,y,angle,speed,vector)
+		return Hunter.Hunting(id, x, y, angle, speed, vector, ai, cur_ship)
 	end,
-	Killing = function(id,x,y,angle,speed,vector)
+	Killing = function(id, x, y, angle, speed, vector, ai, cur_ship)
 		local myFleet = Fleets:getShipFleet(id)
 		if myFleet ~= nil then
 			local prox = myFleet:fleetmateProx(id)
 			if prox ~= nil and prox < 45 then return "NewPattern" end
 		end
-		return Hunter.Killing(id,x,y,angle,speed,vector)
+		return Hunter.Killing(id, x, y, angle, speed, vector, ai, cur_ship)
 	end,
-	NewPattern = function(id,x,y,angle,speed,vector)
-		local cur_ship = Epiar.getSprite(id)
+	NewPattern = function(id, x, y, angle, speed, vector, ai, cur_ship)
 		local momentumAngle = cur_ship:GetMomentumAngle()
-		if AIData[id].correctAgainst == nil then
-			AIData[id].correctAgainst = momentumAngle
-			AIData[id].correctOffset = math.random(-90,90)
+		if ai.correctAgainst == nil then
+			ai.correctAgainst = momentumAngle
+			ai.correctOffset = math.random(-90,90)
 		end
-		cur_ship:Rotate( cur_ship:directionTowards( AIData[id].correctAgainst + AIData[id].correctOffset ) )
+		cur_ship:Rotate( cur_ship:directionTowards( ai.correctAgainst + ai.correctOffset ) )
 		cur_ship:Accelerate()
-		if cur_ship:directionTowards( AIData[id].correctAgainst + AIData[id].correctOffset ) == 0 then
-			AIData[id].correctAgainst = nil
-			AIData[id].correctOffset = nil
+		if cur_ship:directionTowards( ai.correctAgainst + ai.correctOffset ) == 0 then
+			ai.correctAgainst = nil
+			ai.correctOffset = nil
 			return "Hunting"
 		end
 	end,
-	HoldingPosition = function(id,x,y,angle,speed,vector)
-		local ns = AIData[id].nextState
+	HoldingPosition = function(id, x, y, angle, speed, vector, ai, cur_ship)
+		local ns = ai.nextState
 		if ns ~= nil then
-			AIData[id].nextState = nil
+			ai.nextState = nil
 			return ns
 		end
 
-		local cur_ship = Epiar.getSprite(id)
 		local inverseMomentumOffset = - cur_ship:directionTowards( cur_ship:GetMomentumAngle() )
 		cur_ship:Rotate( inverseMomentumOffset )
 		if math.abs( cur_ship:directionTowards( cur_ship:GetMomentumAngle() ) ) >= 176 and speed > 0.1 then
@@ -549,21 +496,20 @@ Escort = {
 		end
 		return "HoldingPosition"
 	end,
-	Accompanying = function(id,x,y,angle,speed,vector)
-		local cur_ship = Epiar.getSprite(id)
-		local acc = AIData[id].accompany
+	Accompanying = function(id, x, y, angle, speed, vector, ai, cur_ship)
+		local acc = ai.accompany
 		local accompanySprite
 
 		if acc > -1 then
-			accompanySprite = Epiar.getSprite(AIData[id].accompany)
-			if AIData[id].hostile == 1 then return "Hunting" end
-			local ns = AIData[id].nextState
+			accompanySprite = Epiar.getSprite(ai.accompany)
+			if ai.hostile == 1 then return "Hunting" end
+			local ns = ai.nextState
 			if ns ~= nil then
-				AIData[id].nextState = nil
+				ai.nextState = nil
 				return ns
 			end
 		else
-			if AIData[id].destination ~= nil and AIData[id].destination > -1 then
+			if ai.destination ~= nil and ai.destination > -1 then
 				return "Travelling"
 			else
 				return "New_Planet"
@@ -579,12 +525,12 @@ Escort = {
 
 			local aitype, aitask = accompanySprite:GetState()
 			if aitask == "Hunting" or aitask == "Killing" then
-				AIData[id].target = AIData[AIData[id].accompany].target
+				ai.target = AIData[ai.accompany].target
 				return "Hunting"
 			end
 		else
-			AIData[id].accompany = -1
-			AIData[id].hostile = -1
+			ai.accompany = -1
+			ai.hostile = -1
 			return "default"
 		end
 
@@ -593,15 +539,15 @@ Escort = {
 		local accelDir = cur_ship:directionTowards(ax,ay)
 		local inverseMomentumDir = - cur_ship:directionTowards( cur_ship:GetMomentumAngle() )
 
-		if distance > AIData[id].farThreshold then
+		if distance > ai.farThreshold then
 			cur_ship:Rotate( accelDir )
 			if accelDir == 0 then
 				cur_ship:Accelerate()
 			end
 		else
-			if distance > AIData[id].nearThreshold then
+			if distance > ai.nearThreshold then
 				cur_ship:Rotate( accelDir )
-				if distance % (math.sqrt(AIData[id].farThreshold - distance) + 1) < 2 and
+				if distance % (math.sqrt(ai.farThreshold - distance) + 1) < 2 and
 				   accelDir == 0 then
 					cur_ship:Accelerate()
 				end
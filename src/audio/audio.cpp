@@ -1,7 +1,7 @@
 /**\file			audio.cpp
  * \author			Maoserr
  * \date			Created: Saturday, February 06, 2010
- * \date			Modified: Sunday, February 21, 2016
+ * \date			Modified: Monday, October 19, 2026
  * \brief			Abstraction to SDL_mixer interface.
  * \details
  * This files is responsible for overall Audio system configuration.  To play
@@ -10,6 +10,7 @@
 
 #include "includes.h"
 #include "audio/audio.h"
+#include "audio/soundbank.h"
 #include "utilities/log.h"
 #include "utilities/options.h"
 
@@ -67,6 +68,8 @@ bool Audio::Initialize( void ) {
 
 	assert( this->max_chan == static_cast<unsigned int>(this->GetTotalChannels()) );
 
+	SoundBank::Initialize();
+
 	return true;
 }
 
@@ -80,6 +83,8 @@ bool Audio::Shutdown( void ) {
 	/* Halt all currently playing sounds */
 	Mix_HaltChannel( -1 );
 
+	SoundBank::Shutdown();
+
 	// Free every library loaded
 	while(Mix_Init(0)) {
 		Mix_Quit();
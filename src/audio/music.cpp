@@ -25,7 +25,12 @@ Song *Song::Get( const string& filename ){
 
 	if( (value == NULL) && filename != "" ) {
 		value = new Song( filename );
-		Resource::Store( filename, (Resource*) value );
+
+		Song* stored = (Song*) Resource::Store( filename, (Resource*) value );
+		if( stored != value ) {
+			delete value;
+			value = stored;
+		}
 	}
 
 	return value;
@@ -11,8 +11,9 @@
 
 #include "includes.h"
 #include "audio/audio.h"
+#include "utilities/resource.h"
 
-class Song {
+class Song : public Resource {
 	public:
 		static Song *Get( const string& filename );
 		Song( const string& filename );
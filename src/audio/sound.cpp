@@ -1,7 +1,7 @@
 /**\file			sound.cpp
  * \author			Maoserr
  * \date			Created: Saturday, February 06, 2010
- * \date			Modified: Saturday, February 06, 2010
+ * \date			Modified: Monday, October 19, 2026
  * \brief			Implements sound playing abilities.
  * \details
  */
@@ -9,6 +9,8 @@
 #include "includes.h"
 #include "audio/audio.h"
 #include "audio/sound.h"
+#include "audio/soundbank.h"
+#include "utilities/loader.h"
 #include "utilities/log.h"
 #include "utilities/options.h"
 #include "utilities/resource.h"
@@ -17,7 +19,30 @@
  * \brief This represents a sound object.
  */
 
+/**\class SoundJob
+ * \brief Decodes a Sound for the Loader. */
+class SoundJob : public LoadJob {
+	public:
+		SoundJob( Sound *_sound, const string& _path )
+			:sound(_sound), path(_path), buffer(NULL) {}
+
+		void Run( void ) {
+			buffer = SoundBank::Get( path );
+		}
+
+		void Finish( void ) {
+			sound->loading = NULL;
+			sound->Use( buffer );
+		}
+
+	private:
+		Sound *sound;
+		string path;
+		SoundBuffer *buffer;
+};
+
 /**\brief Gets the sound or loads it.
+ * \details The sound is decoded by the Loader, and doesn't play until then.
  * \param filename Sound file
  */
 Sound *Sound::Get( const string& filename ) {
@@ -25,9 +50,40 @@ Sound *Sound::Get( const string& filename ) {
 	value = (Sound*) Resource::Get( filename );
 
 	if( value == NULL ) {
-		value = new Sound( filename );
+		value = new Sound( filename, SOUND_QUEUED );
 		// Store audio even if we get NULL. Many parts of the code simply call "Play". It needs to fail gracefully.
-		Resource::Store( filename, (Resource*) value );
+		Sound* stored = (Sound*) Resource::Store( filename, (Resource*) value );
+		if( stored != value ) {
+			// Another thread loaded it meanwhile
+			delete value;
+			value = stored;
+		}
+	}
+
+	return value;
+}
+
+/**\brief Gets the sound without decoding it until it is first played.
+ * \details With "options/memory/lazy-assets" off, this is the same as Get.
+ * \param filename Sound file
+ */
+Sound *Sound::Defer( const string& filename ) {
+	Sound* value;
+
+	if( !OPTION( bool, "options/memory/lazy-assets" ) ) {
+		return Get( filename );
+	}
+
+	value = (Sound*) Resource::Get( filename );
+
+	if( value == NULL ) {
+		value = new Sound( filename, SOUND_DEFERRED );
+
+		Sound* stored = (Sound*) Resource::Store( filename, (Resource*) value );
+		if( stored != value ) {
+			delete value;
+			value = stored;
+		}
 	}
 
 	return value;
@@ -35,9 +91,14 @@ Sound *Sound::Get( const string& filename ) {
 
 /**\brief Loads the sound based on filename
  * \param filename Sound file
+ * \param when Whether to decode the sound right away, on the Loader's threads, or not until it is played
  */
-Sound::Sound( const string& filename ):
-	sound( NULL ),
+Sound::Sound( const string& filename, SoundLoading when ):
+	buffer( NULL ),
+	loading( NULL ),
+	evicted( false ),
+	deferred( false ),
+	path( filename ),
 	channel( -1 ),
 	fadefactor( 0.03 ),
 	panfactor( 0.1f ),
@@ -49,29 +110,43 @@ Sound::Sound( const string& filename ):
 
 	if( pathName.OpenRead( filename ) == false ) {
 		LogMsg(ERR, "Could not load sound file: '%s'", filename.c_str() );
-		sound = NULL;
 		return;
 	}
 
-	this->sound = Mix_LoadWAV( pathName.GetAbsolutePath().c_str() );
-	if( this->sound == NULL ) {
-		LogMsg(ERR, "Could not load sound file: '%s', Mixer error: %s",
-				filename.c_str(), Mix_GetError() );
-		sound = NULL;
+	if( when == SOUND_DEFERRED ) {
+		deferred = true;
+		return;
 	}
+
+	if( when == SOUND_QUEUED ) {
+		loading = new SoundJob( this, pathName.GetAbsolutePath() );
+		Loader::Queue( loading );
+		return;
+	}
+
+	Use( SoundBank::Get( pathName.GetAbsolutePath() ) );
 }
 
 /**\brief Destructor to free the sound file.
+ * \details The SoundBank stops the sound if this was the last Sound of it.
  */
 Sound::~Sound() {
-	// Halts any channel this sound is playing on
-	for ( int i = 0; i < Audio::Instance()->GetTotalChannels(); i++ ) {
-		if ( Mix_GetChunk( i ) == this->sound) {
-			Mix_HaltChannel( i );
-		}
+	if( loading ) {
+		Loader::Wait( loading );
 	}
 
-	if(this->sound) Mix_FreeChunk( this->sound );
+	if( buffer ) {
+		SoundBank::Release( buffer );
+	}
+}
+
+/**\brief Starts using a decoded buffer from the SoundBank.
+ * \details The SoundBank counts the buffer once, however many Sounds use it.
+ */
+void Sound::Use( SoundBuffer *_buffer ) {
+	buffer = _buffer;
+	SetShare( RESOURCE_PCM, buffer ? buffer->chunk->alen : 0 );
+	SetTransient( buffer && buffer->streamed );
 }
 
 /**\brief Plays the sound.
@@ -81,7 +156,7 @@ bool Sound::Play( void ) {
 		return true; // audio is disabled
 	}
 
-	if ( this->sound == NULL ) {
+	if ( !Ready() ) {
 		return false;
 	}
 
@@ -92,7 +167,7 @@ bool Sound::Play( void ) {
 	Mix_SetPanning( freechan, 127, 127 );
 	Mix_Volume( freechan, this->volume );
 
-	this->channel = Audio::Instance()->PlayChannel( freechan, this->sound, 0 );
+	this->channel = SoundBank::Play( buffer, freechan );
 
 	if ( channel == -1 ) {
 		return false;
@@ -108,7 +183,7 @@ bool Sound::Play( Coordinate offset ) {
 		return true; // audio is disabled
 	}
 
-	if ( this->sound == NULL ) {
+	if ( !Ready() ) {
 		return false;
 	}
 
@@ -146,7 +221,7 @@ bool Sound::Play( Coordinate offset ) {
 	}
 
 	Mix_Volume( freechan, this->volume );
-	this->channel = Audio::Instance()->PlayChannel( freechan, this->sound, 0 );
+	this->channel = SoundBank::Play( buffer, freechan );
 
 	if( channel == -1 ) {
 		return false;
@@ -164,13 +239,13 @@ bool Sound::PlayNoRestart( Coordinate offset ) {
 		return true; // audio is disabled
 	}
 
-	if( this->sound == NULL ) {
+	if( !Ready() ) {
 		return false;
 	}
 
 	if( (this->channel != -1) &&
 			Mix_Playing( this->channel ) &&
-			(Mix_GetChunk( this->channel ) == this->sound ) ) {
+			(Mix_GetChunk( this->channel ) == buffer->chunk ) ) {
 		return false;
 	}
 
@@ -182,7 +257,7 @@ bool Sound::PlayNoRestart( Coordinate offset ) {
 /**\brief Sets the volume for this sound only (for next time it is played).
  */
 bool Sound::SetVolume( float volume ) {
-	if( this->sound == NULL ) {
+	if( buffer == NULL ) {
 		return false;
 	}
 
@@ -201,3 +276,59 @@ void Sound::SetFactors( double fade, float pan ) {
 	this->panfactor = pan;
 }
 
+/**\brief Starts decoding the sound, if it was deferred or evicted.
+ * \details Call this from the logic thread, which is the one that plays Sounds.
+ */
+void Sound::Prefetch( void ) {
+	if( buffer != NULL || loading != NULL ) {
+		return;
+	}
+
+	if( evicted ) {
+		evicted = false;
+		CountReload();
+	} else if( deferred ) {
+		deferred = false;
+	} else {
+		return;
+	}
+
+	loading = new SoundJob( this, pathName.GetAbsolutePath() );
+	Loader::Queue( loading );
+}
+
+/**\brief Checks that the sound can be played.
+ * \details A deferred sound starts loading now, and is played the next time
+ *          that it is asked for once it has loaded. A sound that was evicted
+ *          has been heard before, so it is loaded again right away instead
+ *          of going silent.
+ */
+bool Sound::Ready( void ) {
+	bool reload = evicted;
+
+	Touch();
+	Prefetch();
+
+	if( reload && loading != NULL ) {
+		Loader::Wait( loading );
+	}
+
+	return( buffer != NULL );
+}
+
+/**\brief Lets go of the decoded sound, unless it is playing.
+ * \details The SoundBank keeps the buffer while another Sound still uses it.
+ * \sa Resource::Trim
+ */
+bool Sound::Evict( void ) {
+	if( buffer == NULL || loading != NULL || SoundBank::IsPlaying( buffer ) ) {
+		return false;
+	}
+
+	SoundBank::Release( buffer );
+	buffer = NULL;
+	evicted = true;
+	SetShare( RESOURCE_PCM, 0 );
+
+	return true;
+}
@@ -1,7 +1,7 @@
 /**\file			sound.h
  * \author			Maoserr
  * \date			Created: Monday, February 08, 2010
- * \date			Modified: Monday, February 08, 2010
+ * \date			Modified: Monday, October 19, 2026
  * \brief			Implements sound playing abilities.
  * \details
  */
@@ -9,29 +9,54 @@
 #ifndef __H_SOUND__
 #define __H_SOUND__
 
+#include "audio/soundbank.h"
 #include "utilities/coordinate.h"
 #include "utilities/file.h"
 #include "utilities/resource.h"
 
+class LoadJob;
+
+// When a Sound is decoded
+typedef enum {
+	SOUND_NOW,      ///< Right away, on this thread
+	SOUND_QUEUED,   ///< On the Loader's threads
+	SOUND_DEFERRED  ///< On the Loader's threads, once it is first played or prefetched
+} SoundLoading;
+
 class Sound : public Resource {
 	public:
 		static Sound *Get( const string& filename );
-		Sound( const string& filename );
+		static Sound *Defer( const string& filename );
+		Sound( const string& filename, SoundLoading when = SOUND_NOW );
 		~Sound( void );
 		bool Play( void );
 		bool Play( Coordinate offset );
 		bool PlayNoRestart( Coordinate offset );
 		bool SetVolume( float volume );
 		void SetFactors( double fade, float pan );
-		string GetPath( void ) { return pathName.GetRelativePath(); }
+		string GetPath( void ) { return path; }
+
+		void Prefetch( void );
+
+	protected:
+		bool Evict( void );
 
 	private:
-		Mix_Chunk *sound;
+		bool Ready( void );
+		void Use( SoundBuffer *_buffer );
+
+		SoundBuffer *buffer; // shared with every other Sound of the same file
+		LoadJob *loading; // the Loader's job for this sound, until it is finished
+		bool evicted; // the sound was let go by Resource::Trim, and is loaded again when played
+		bool deferred; // the sound hasn't been decoded yet, as nothing has played it
 		File pathName;
+		string path;		// As it was asked for, even if audio is disabled
 		int channel;		// Last channel the sound is playing on.
 		double fadefactor;	// Scale factor to fade by as distance drops off
 		float panfactor;	// Scale factor to pan by, higher = more sensitive
 		int volume;		// Volume for this sound
+
+		friend class SoundJob;
 };
 
 
@@ -0,0 +1,226 @@
+/**\file			soundbank.cpp
+ * \author			Christopher Thielen (chris@epiar.net)
+ * \date			Created: Monday, October 19, 2026
+ * \date			Modified: Monday, October 19, 2026
+ * \brief			Decoded sound effects, shared by every Sound of the same file
+ * \details
+ */
+
+#include "includes.h"
+#include "audio/audio.h"
+#include "audio/soundbank.h"
+#include "utilities/log.h"
+#include "utilities/options.h"
+#include "utilities/resource.h"
+
+/**\class SoundBank
+ * \brief Holds the decoded PCM of every sound effect, once per file.
+ * \details Sounds that play the same file share one buffer, which is freed
+ *          when the last of them lets go of it. The bank also keeps track of
+ *          which buffer each mixing channel is playing, so that a Sound can
+ *          tell whether it is playing without asking every channel.
+ *
+ *          Each buffer is counted against the RESOURCE_PCM budget once, from
+ *          when it is decoded until the last Sound lets go of it.
+ *
+ *          Streaming long effects is impossible with SDL_mixer, which can
+ *          only stream its one music track, so that is only partly done
+ *          here: every effect is decoded whole. Effects longer than
+ *          "options/memory/sound-stream-size" are marked "streamed" instead.
+ *          Once a budget is exceeded, Resource::Trim evicts them before
+ *          anything else that isn't playing, however recently they were
+ *          used. Until then they stay decoded like any other effect.
+ * \sa Sound
+ */
+
+map<string,SoundBuffer*> SoundBank::buffers;
+vector<SoundBuffer*> SoundBank::channels;
+SDL_SpinLock SoundBank::lock = 0;
+SoundBankStats SoundBank::stats;
+Uint32 SoundBank::streamSize = 0;
+
+/**\brief Starts tracking the mixing channels.
+ * \details Call this once the channels have been allocated.
+ */
+void SoundBank::Initialize( void ) {
+	streamSize = static_cast<Uint32>( OPTION( int, "options/memory/sound-stream-size" ) ) * 1024;
+
+	channels.assign( Audio::Instance()->GetTotalChannels(), NULL );
+	Mix_ChannelFinished( SoundBank::ChannelFinished );
+}
+
+/**\brief Stops tracking the mixing channels.
+ * \details Call this once every channel has been halted.
+ */
+void SoundBank::Shutdown( void ) {
+	Mix_ChannelFinished( NULL );
+	channels.clear();
+
+	if( stats.buffers > 0 ) {
+		LogMsg(DEBUG, "The sound bank still holds %d buffers.", stats.buffers );
+	}
+}
+
+/**\brief Gets the decoded sound of a file.
+ * \details The file is only decoded if no other Sound has it already. The
+ *          decoding is done without holding the lock, so two threads may
+ *          decode the same file at once; the first one to finish is kept.
+ * \param path The file
+ * \param shared Set to whether the buffer was already decoded
+ * \return The buffer, to be Released, or NULL if the file couldn't be decoded
+ */
+SoundBuffer* SoundBank::Get( const string& path, bool *shared ) {
+	map<string,SoundBuffer*>::iterator i;
+	SoundBuffer *buffer = NULL;
+	Mix_Chunk *chunk;
+
+	SDL_AtomicLock( &lock );
+	i = buffers.find( path );
+	if( i != buffers.end() ) {
+		buffer = i->second;
+		buffer->users++;
+		stats.shared++;
+	}
+	SDL_AtomicUnlock( &lock );
+
+	if( buffer != NULL ) {
+		if( shared ) {
+			*shared = true;
+		}
+		return buffer;
+	}
+
+	chunk = Mix_LoadWAV( path.c_str() );
+	if( chunk == NULL ) {
+		LogMsg(ERR, "Could not load sound file: '%s', Mixer error: %s",
+				path.c_str(), Mix_GetError() );
+		return NULL;
+	}
+
+	SDL_AtomicLock( &lock );
+	i = buffers.find( path );
+	if( i != buffers.end() ) {
+		// Another thread decoded it meanwhile
+		buffer = i->second;
+		buffer->users++;
+		stats.shared++;
+	} else {
+		buffer = new SoundBuffer;
+		buffer->path = path;
+		buffer->chunk = chunk;
+		buffer->users = 1;
+		SDL_AtomicSet( &buffer->playing, 0 );
+		buffer->streamed = ( streamSize > 0 ) && ( chunk->alen > streamSize );
+		buffers[path] = buffer;
+
+		stats.buffers++;
+		stats.decodes++;
+		if( buffer->streamed ) {
+			stats.streamedBytes += chunk->alen;
+		} else {
+			stats.bytes += chunk->alen;
+		}
+		if( stats.bytes + stats.streamedBytes > stats.peak ) {
+			stats.peak = stats.bytes + stats.streamedBytes;
+		}
+		chunk = NULL;
+	}
+	SDL_AtomicUnlock( &lock );
+
+	if( chunk != NULL ) {
+		Mix_FreeChunk( chunk );
+	} else {
+		Resource::Account( RESOURCE_PCM, buffer->chunk->alen );
+	}
+
+	if( shared ) {
+		*shared = ( chunk != NULL );
+	}
+
+	return buffer;
+}
+
+/**\brief Lets go of a buffer from Get.
+ * \details The last Sound to let go of a buffer frees it, and stops it
+ *          wherever it is still playing.
+ */
+void SoundBank::Release( SoundBuffer *buffer ) {
+	SDL_AtomicLock( &lock );
+	assert( buffer->users > 0 );
+	buffer->users--;
+	if( buffer->users > 0 ) {
+		SDL_AtomicUnlock( &lock );
+		return;
+	}
+
+	buffers.erase( buffer->path );
+	stats.buffers--;
+	if( buffer->streamed ) {
+		stats.streamedBytes -= buffer->chunk->alen;
+	} else {
+		stats.bytes -= buffer->chunk->alen;
+	}
+	SDL_AtomicUnlock( &lock );
+
+	Resource::Account( RESOURCE_PCM, -static_cast<Sint64>( buffer->chunk->alen ) );
+
+	if( IsPlaying( buffer ) ) {
+		Halt( buffer );
+	}
+
+	Mix_FreeChunk( buffer->chunk );
+	delete buffer;
+}
+
+/**\brief Plays a buffer on a channel.
+ * \return The channel that it is playing on, or -1
+ */
+int SoundBank::Play( SoundBuffer *buffer, int channel ) {
+	channel = Audio::Instance()->PlayChannel( channel, buffer->chunk, 0 );
+
+	// Whatever the channel played before has been finished by now
+	if( channel >= 0 && channel < static_cast<int>( channels.size() ) ) {
+		SDL_AtomicAdd( &buffer->playing, 1 );
+		SDL_AtomicSetPtr( (void**)&channels[channel], buffer );
+	}
+
+	return channel;
+}
+
+/**\brief Stops every channel that is playing a buffer.
+ */
+void SoundBank::Halt( SoundBuffer *buffer ) {
+	for( unsigned int c = 0; c < channels.size(); c++ ) {
+		if( SDL_AtomicGetPtr( (void**)&channels[c] ) == buffer ) {
+			Mix_HaltChannel( c );
+		}
+	}
+}
+
+/**\brief Notes that a channel has stopped playing.
+ * \details SDL_mixer calls this from its own thread.
+ */
+void SoundBank::ChannelFinished( int channel ) {
+	SoundBuffer *buffer;
+
+	if( channel < 0 || channel >= static_cast<int>( channels.size() ) ) {
+		return;
+	}
+
+	buffer = static_cast<SoundBuffer*>( SDL_AtomicSetPtr( (void**)&channels[channel], NULL ) );
+	if( buffer != NULL ) {
+		SDL_AtomicAdd( &buffer->playing, -1 );
+	}
+}
+
+/**\brief How many sounds are decoded, and how much memory they hold.
+ */
+SoundBankStats SoundBank::GetStats( void ) {
+	SoundBankStats copy;
+
+	SDL_AtomicLock( &lock );
+	copy = stats;
+	SDL_AtomicUnlock( &lock );
+
+	return copy;
+}
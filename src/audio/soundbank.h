@@ -0,0 +1,56 @@
+/**\file			soundbank.h
+ * \author			Christopher Thielen (chris@epiar.net)
+ * \date			Created: Monday, October 19, 2026
+ * \date			Modified: Monday, October 19, 2026
+ * \brief			Decoded sound effects, shared by every Sound of the same file
+ * \details
+ */
+
+#ifndef __H_SOUNDBANK__
+#define __H_SOUNDBANK__
+
+#include "includes.h"
+
+typedef struct {
+	string path;           ///< The file, as Mix_LoadWAV was given it
+	Mix_Chunk *chunk;
+	int users;             ///< Sounds that hold this buffer
+	SDL_atomic_t playing;  ///< Channels that are playing it right now
+	bool streamed;         ///< Long enough to be evicted first, once a budget is exceeded
+} SoundBuffer;
+
+typedef struct {
+	int buffers;           ///< Decoded buffers held
+	Uint32 decodes;        ///< Files decoded
+	Uint32 shared;         ///< Times that a Sound got a buffer that was already decoded
+	Sint64 bytes;          ///< PCM held by the short effects
+	Sint64 streamedBytes;  ///< PCM held by the long effects
+	Sint64 peak;           ///< Most PCM held at once
+} SoundBankStats;
+
+class SoundBank {
+	public:
+		static void Initialize( void );
+		static void Shutdown( void );
+
+		// Decode a file, or share it if it already is; on any thread
+		static SoundBuffer* Get( const string& path, bool *shared = NULL );
+		static void Release( SoundBuffer *buffer );
+
+		static int Play( SoundBuffer *buffer, int channel );
+		static bool IsPlaying( SoundBuffer *buffer ) { return SDL_AtomicGet( &buffer->playing ) > 0; }
+
+		static SoundBankStats GetStats( void );
+
+	private:
+		static void Halt( SoundBuffer *buffer );
+		static void ChannelFinished( int channel );
+
+		static map<string,SoundBuffer*> buffers;
+		static vector<SoundBuffer*> channels; ///< What each mixing channel is playing
+		static SDL_SpinLock lock; ///< Sounds are decoded on the Loader's threads
+		static SoundBankStats stats;
+		static Uint32 streamSize; ///< Buffers larger than this are streamed
+};
+
+#endif // __H_SOUNDBANK__
@@ -39,7 +39,7 @@ void Calendar::Update(void) {
 	int old_period = period;
 	int old_epoch = epoch;
   
-	ticker++;
+	ticker += Timer::GetTimeScale();
   
 	if(ticker > LOGIC_FRAMES_PER_PERIOD) {
 		ticker = 0;
@@ -36,7 +36,7 @@ class Calendar {
     
 	private:
 		int period, epoch;
-		int ticker;
+		double ticker; // logical frames at LOGIC_FPS since the period started
     
 		void AdjustEpoch();
 };
@@ -48,6 +48,7 @@ Camera::Camera( void ) {
 	cameraShakeXDec = 0;
 	cameraShakeYDec = 0;
 	flashUntil = 0;
+	cut = false;
 }
 
 /**\brief Focus on a specific Location
@@ -86,10 +87,11 @@ Coordinate Camera::GetFocusCoordinate() {
  * \see TranslateScreenToWorld
  */
 void Camera::TranslateWorldToScreen( Coordinate &world, Coordinate &screen ) {
-	int tx, ty;
+	double tx, ty;
 
-	tx = (int)(world.GetX() - x + Video::GetHalfWidth());
-	ty = (int)(y - world.GetY() + Video::GetHalfHeight());
+	// Keep the fractions so that interpolated movement doesn't wobble
+	tx = world.GetX() - x + Video::GetHalfWidth();
+	ty = y - world.GetY() + Video::GetHalfHeight();
 
 	screen.SetX( tx );
 	screen.SetY( ty );
@@ -153,6 +155,9 @@ void Camera::Update( SpriteManager *sprites ) {
 
 		UpdateShake();
 	}
+
+	// Nothing flies a screen in one frame, so the camera must have jumped
+	cut = ( dx * dx + dy * dy ) > ( Video::GetWidth() * Video::GetWidth() + Video::GetHeight() * Video::GetHeight() );
 }
 
 /**\brief "Shakes" the camera based on the duration, intensity, source specified
@@ -29,6 +29,8 @@ class Camera {
 		// gives the most recent change in camera coordinates
 		void GetDelta( double *dx, double *dy );
 		Coordinate GetFocusCoordinate();
+		// whether the last Update jumped rather than moved
+		bool WasCut( void ) { return cut; }
 
 		void Update( SpriteManager *sprites );
 
@@ -62,6 +64,7 @@ class Camera {
 		               // (this is used by Starfield)
 		float zoom; // current zoom, zoom = 1. means no zooming
 		bool hasZoomed;
+		bool cut; // the last Update moved too far to interpolate
 		void UpdateShake();
 
 		// If timestamp < flashUntil, we draw a flash over the display (for the jump animation)
@@ -0,0 +1,748 @@
+/**\file			compiled_scenario.cpp
+ * \author			Christopher Thielen (chris@epiar.net)
+ * \date			Created: Monday, October 19, 2026
+ * \date			Modified: Monday, October 19, 2026
+ * \brief			Scenario Components in a binary file that loads without parsing
+ * \details
+ */
+
+#include "includes.h"
+#include "common.h"
+#include "audio/sound.h"
+#include "engine/compiled_scenario.h"
+#include "engine/manifest.h"
+#include "engine/scenario.h"
+#include "utilities/file.h"
+#include "utilities/log.h"
+#include "version.h"
+
+/**\class CompiledScenario
+ * \brief The Components of a Scenario, as fixed-size records.
+ * \details `epiar --compile-scenario=<name>` loads a Scenario from its XML
+ *          and writes every Component into scenario.bin. Strings are kept
+ *          once each in a string table, and Components refer to each other
+ *          by their index, so nothing has to be parsed or looked up by name
+ *          when the file is loaded. The records are used straight out of
+ *          File::Map.
+ *
+ *          The header remembers how long each XML file was and when it was
+ *          changed. If any of them has changed since, or the file was written
+ *          by another version of Epiar, it is ignored and the XML is loaded
+ *          instead. The editor keeps saving XML; compile again afterwards.
+ * \sa Scenario::Load
+ */
+
+// How big a record of each section is
+static const size_t compiledRecordSize[COMPILED_SECTIONS] = {
+	sizeof(char),
+	sizeof(Uint32),
+	sizeof(CompiledCommodity),
+	sizeof(CompiledAlliance),
+	sizeof(CompiledEngine),
+	sizeof(CompiledWeapon),
+	sizeof(CompiledOutfit),
+	sizeof(CompiledModel),
+	sizeof(CompiledSlot),
+	sizeof(CompiledTechnology),
+	sizeof(CompiledPlanet),
+	sizeof(CompiledSector),
+};
+
+#define COMPILED_EPIAR_VERSION ( (EPIAR_VERSION_MAJOR << 16) | (EPIAR_VERSION_MINOR << 8) | EPIAR_VERSION_MICRO )
+
+/**\brief Stamps an XML file so that changes to it can be noticed.
+ */
+static bool StampSource( const string& filename, CompiledSource *source ) {
+	File file;
+
+	if( !file.OpenRead( filename ) ) {
+		return false;
+	}
+
+	source->length = file.GetLength();
+	source->modified = File::GetModTime( filename );
+
+	return true;
+}
+
+/**\brief Creates an empty CompiledScenario.
+ */
+CompiledScenario::CompiledScenario()
+	:data(NULL)
+	,length(0)
+	,header(NULL)
+{
+}
+
+/**\brief Releases the file.
+ */
+CompiledScenario::~CompiledScenario() {
+	Close();
+}
+
+/**\brief Opens the compiled Scenario in a folder.
+ * \param sources The XML files that the Scenario would be loaded from otherwise
+ * \return false if there is no compiled Scenario, or if it is out of date
+ */
+bool CompiledScenario::Open( const string& folderpath, const vector<string>& sources ) {
+	string filename = folderpath + COMPILED_SCENARIO_FILE;
+
+	Close();
+
+	if( !File::Exists( filename ) || !file.OpenRead( filename ) ) {
+		return false;
+	}
+	length = file.GetLength();
+
+	data = file.Map();
+	if( data == NULL ) {
+		Close();
+		return false;
+	}
+	header = reinterpret_cast<const CompiledHeader*>( data );
+
+	if( !Validate( sources ) ) {
+		LogMsg(INFO, "'%s' is out of date, the Scenario will be loaded from XML.", filename.c_str() );
+		Close();
+		return false;
+	}
+
+	LogMsg(INFO, "Loading the compiled Scenario '%s'.", filename.c_str() );
+
+	return true;
+}
+
+/**\brief Releases the file.
+ */
+void CompiledScenario::Close( void ) {
+	file.Close();
+
+	data = NULL;
+	length = 0;
+	header = NULL;
+}
+
+/**\brief Checks that the file was compiled from the current XML, and that
+ *        every record only refers to things inside of the file.
+ */
+bool CompiledScenario::Validate( const vector<string>& sources ) {
+	unsigned int s;
+	Uint32 i, j;
+
+	if( length < static_cast<long>( sizeof(CompiledHeader) )
+	    || header->magic != COMPILED_SCENARIO_MAGIC
+	    || header->version != COMPILED_SCENARIO_VERSION
+	    || header->epiarVersion != COMPILED_EPIAR_VERSION
+	    || header->byteOrder != COMPILED_SCENARIO_BYTE_ORDER
+	    || header->numSources != sources.size()
+	    || sources.size() > COMPILED_SCENARIO_MAX_SOURCES ) {
+		return false;
+	}
+
+	for( s = 0; s < sources.size(); s++ ) {
+		CompiledSource source;
+		if( !StampSource( sources[s], &source )
+		    || source.length != header->sources[s].length
+		    || source.modified != header->sources[s].modified ) {
+			return false;
+		}
+	}
+
+	for( s = 0; s < COMPILED_SECTIONS; s++ ) {
+		const CompiledSection *section = &header->sections[s];
+		if( section->offset % 8 != 0
+		    || section->offset > static_cast<Uint64>( length )
+		    || section->count > ( length - section->offset ) / compiledRecordSize[s] ) {
+			return false;
+		}
+	}
+
+	// The string table is a list of NUL terminated strings, starting with ""
+	if( Count( COMPILED_STRINGS ) == 0
+	    || String( 0 )[0] != '\0'
+	    || String( Count( COMPILED_STRINGS ) - 1 )[0] != '\0' ) {
+		return false;
+	}
+
+#define CHECK_STRING( s ) if( (s) >= Count( COMPILED_STRINGS ) ) return false
+#define CHECK_INDEX( i, section ) if( (i) >= Count( section ) ) return false
+#define CHECK_OPTIONAL( i, section ) if( (i) != COMPILED_NONE && (i) >= Count( section ) ) return false
+#define CHECK_LIST( first, num, section ) \
+	if( (first) > Count( COMPILED_REFERENCES ) || (num) > Count( COMPILED_REFERENCES ) - (first) ) return false; \
+	for( j = 0; j < (num); j++ ) { CHECK_INDEX( References( first )[j], section ); }
+
+	for( i = 0; i < Count( COMPILED_COMMODITIES ); i++ ) {
+		const CompiledCommodity *r = Records<CompiledCommodity>( COMPILED_COMMODITIES ) + i;
+		CHECK_STRING( r->name );
+	}
+	for( i = 0; i < Count( COMPILED_ALLIANCES ); i++ ) {
+		const CompiledAlliance *r = Records<CompiledAlliance>( COMPILED_ALLIANCES ) + i;
+		CHECK_STRING( r->name );
+		CHECK_STRING( r->currency );
+	}
+	for( i = 0; i < Count( COMPILED_ENGINES ); i++ ) {
+		const CompiledEngine *r = Records<CompiledEngine>( COMPILED_ENGINES ) + i;
+		CHECK_STRING( r->name );
+		CHECK_STRING( r->picture );
+		CHECK_STRING( r->description );
+		CHECK_STRING( r->sound );
+		CHECK_STRING( r->flareAnimation );
+	}
+	for( i = 0; i < Count( COMPILED_WEAPONS ); i++ ) {
+		const CompiledWeapon *r = Records<CompiledWeapon>( COMPILED_WEAPONS ) + i;
+		CHECK_STRING( r->name );
+		CHECK_STRING( r->image );
+		CHECK_STRING( r->picture );
+		CHECK_STRING( r->description );
+		CHECK_STRING( r->sound );
+		if( r->ammoType < 0 || r->ammoType >= max_ammo ) return false;
+	}
+	for( i = 0; i < Count( COMPILED_OUTFITS ); i++ ) {
+		const CompiledOutfit *r = Records<CompiledOutfit>( COMPILED_OUTFITS ) + i;
+		CHECK_STRING( r->name );
+		CHECK_STRING( r->picture );
+		CHECK_STRING( r->description );
+	}
+	for( i = 0; i < Count( COMPILED_SLOTS ); i++ ) {
+		const CompiledSlot *r = Records<CompiledSlot>( COMPILED_SLOTS ) + i;
+		CHECK_STRING( r->name );
+		CHECK_OPTIONAL( r->weapon, COMPILED_WEAPONS );
+	}
+	for( i = 0; i < Count( COMPILED_MODELS ); i++ ) {
+		const CompiledModel *r = Records<CompiledModel>( COMPILED_MODELS ) + i;
+		CHECK_STRING( r->name );
+		CHECK_STRING( r->image );
+		CHECK_STRING( r->description );
+		CHECK_OPTIONAL( r->engine, COMPILED_ENGINES );
+		if( r->firstSlot > Count( COMPILED_SLOTS ) || r->numSlots > Count( COMPILED_SLOTS ) - r->firstSlot ) return false;
+	}
+	for( i = 0; i < Count( COMPILED_TECHNOLOGIES ); i++ ) {
+		const CompiledTechnology *r = Records<CompiledTechnology>( COMPILED_TECHNOLOGIES ) + i;
+		CHECK_STRING( r->name );
+		CHECK_LIST( r->firstModel, r->numModels, COMPILED_MODELS );
+		CHECK_LIST( r->firstEngine, r->numEngines, COMPILED_ENGINES );
+		CHECK_LIST( r->firstWeapon, r->numWeapons, COMPILED_WEAPONS );
+		CHECK_LIST( r->firstOutfit, r->numOutfits, COMPILED_OUTFITS );
+	}
+	for( i = 0; i < Count( COMPILED_PLANETS ); i++ ) {
+		const CompiledPlanet *r = Records<CompiledPlanet>( COMPILED_PLANETS ) + i;
+		CHECK_STRING( r->name );
+		CHECK_STRING( r->image );
+		CHECK_STRING( r->surface );
+		CHECK_STRING( r->summary );
+		CHECK_INDEX( r->alliance, COMPILED_ALLIANCES );
+		CHECK_LIST( r->firstTechnology, r->numTechnologies, COMPILED_TECHNOLOGIES );
+	}
+	for( i = 0; i < Count( COMPILED_SECTORS ); i++ ) {
+		const CompiledSector *r = Records<CompiledSector>( COMPILED_SECTORS ) + i;
+		CHECK_STRING( r->name );
+		CHECK_INDEX( r->alliance, COMPILED_ALLIANCES );
+		CHECK_LIST( r->firstPlanet, r->numPlanets, COMPILED_PLANETS );
+		CHECK_LIST( r->firstNeighbor, r->numNeighbors, COMPILED_SECTORS );
+	}
+
+#undef CHECK_STRING
+#undef CHECK_INDEX
+#undef CHECK_OPTIONAL
+#undef CHECK_LIST
+
+	return true;
+}
+
+/**\brief Adds every Resource that the Components use to a Manifest.
+ */
+void CompiledScenario::AddResources( Manifest *manifest ) {
+	Uint32 i;
+
+	for( i = 0; i < Count( COMPILED_ENGINES ); i++ ) {
+		const CompiledEngine *r = Records<CompiledEngine>( COMPILED_ENGINES ) + i;
+		manifest->Add( MANIFEST_IMAGE, String( r->picture ) );
+		manifest->Add( MANIFEST_ANIMATION, String( r->flareAnimation ) );
+		manifest->Add( MANIFEST_SOUND, String( r->sound ) );
+	}
+	for( i = 0; i < Count( COMPILED_WEAPONS ); i++ ) {
+		const CompiledWeapon *r = Records<CompiledWeapon>( COMPILED_WEAPONS ) + i;
+		manifest->Add( MANIFEST_IMAGE, String( r->image ) );
+		manifest->Add( MANIFEST_IMAGE, String( r->picture ) );
+		manifest->Add( MANIFEST_SOUND, String( r->sound ) );
+	}
+	for( i = 0; i < Count( COMPILED_OUTFITS ); i++ ) {
+		const CompiledOutfit *r = Records<CompiledOutfit>( COMPILED_OUTFITS ) + i;
+		manifest->Add( MANIFEST_IMAGE, String( r->picture ) );
+	}
+	for( i = 0; i < Count( COMPILED_MODELS ); i++ ) {
+		const CompiledModel *r = Records<CompiledModel>( COMPILED_MODELS ) + i;
+		manifest->Add( MANIFEST_IMAGE, String( r->image ) );
+	}
+	for( i = 0; i < Count( COMPILED_PLANETS ); i++ ) {
+		const CompiledPlanet *r = Records<CompiledPlanet>( COMPILED_PLANETS ) + i;
+		manifest->Add( MANIFEST_IMAGE, String( r->image ) );
+		manifest->Add( MANIFEST_IMAGE, String( r->surface ) );
+	}
+}
+
+/**\brief Creates every Component and adds it to the Scenario.
+ * \details The file has already been validated, so every reference is good.
+ */
+bool CompiledScenario::Build( Scenario *scenario ) {
+	vector<Alliance*> alliances( Count( COMPILED_ALLIANCES ) );
+	vector<Engine*> engines( Count( COMPILED_ENGINES ) );
+	vector<Weapon*> weapons( Count( COMPILED_WEAPONS ) );
+	vector<Outfit*> outfits( Count( COMPILED_OUTFITS ) );
+	vector<Model*> models( Count( COMPILED_MODELS ) );
+	vector<Technology*> technologies( Count( COMPILED_TECHNOLOGIES ) );
+	vector<Planet*> planets( Count( COMPILED_PLANETS ), (Planet*)NULL );
+	Uint32 i, j;
+
+	for( i = 0; i < Count( COMPILED_COMMODITIES ); i++ ) {
+		const CompiledCommodity *r = Records<CompiledCommodity>( COMPILED_COMMODITIES ) + i;
+		scenario->GetCommodities()->Add( new Commodity( String( r->name ), r->msrp ) );
+	}
+
+	for( i = 0; i < Count( COMPILED_ALLIANCES ); i++ ) {
+		const CompiledAlliance *r = Records<CompiledAlliance>( COMPILED_ALLIANCES ) + i;
+		alliances[i] = new Alliance( String( r->name ), static_cast<short int>( r->attackSize ),
+		                             r->aggressiveness, String( r->currency ), Color( r->r, r->g, r->b ) );
+		scenario->GetAlliances()->Add( alliances[i] );
+	}
+
+	for( i = 0; i < Count( COMPILED_ENGINES ); i++ ) {
+		const CompiledEngine *r = Records<CompiledEngine>( COMPILED_ENGINES ) + i;
+		Image *picture = Image::Defer( String( r->picture ) );
+		engines[i] = new Engine( String( r->name ), picture, String( r->description ),
+		                         Sound::Defer( String( r->sound ) ), r->forceOutput,
+		                         static_cast<short int>( r->msrp ), r->foldDrive != 0, String( r->flareAnimation ) );
+		Image::Store( engines[i]->GetName(), picture );
+		scenario->GetEngines()->Add( engines[i] );
+	}
+
+	for( i = 0; i < Count( COMPILED_WEAPONS ); i++ ) {
+		const CompiledWeapon *r = Records<CompiledWeapon>( COMPILED_WEAPONS ) + i;
+		Image *picture = Image::Defer( String( r->picture ) );
+		weapons[i] = new Weapon( String( r->name ), Image::Defer( String( r->image ) ), picture,
+		                         String( r->description ), r->weaponType, r->payload, r->velocity,
+		                         r->acceleration, static_cast<AmmoType>( r->ammoType ), r->ammoConsumption,
+		                         r->fireDelay, r->lifetime, Sound::Defer( String( r->sound ) ),
+		                         r->tracking, r->msrp );
+		Image::Store( weapons[i]->GetName(), picture );
+		scenario->GetWeapons()->Add( weapons[i] );
+	}
+
+	for( i = 0; i < Count( COMPILED_OUTFITS ); i++ ) {
+		const CompiledOutfit *r = Records<CompiledOutfit>( COMPILED_OUTFITS ) + i;
+		Image *picture = Image::Defer( String( r->picture ) );
+		outfits[i] = new Outfit( r->msrp, picture, String( r->description ), r->rotPerSecond,
+		                         r->maxSpeed, r->forceOutput, r->mass, r->cargoSpace,
+		                         r->surfaceArea, r->hullStrength, r->shieldStrength );
+		outfits[i]->SetName( String( r->name ) );
+		Image::Store( outfits[i]->GetName(), picture );
+		scenario->GetOutfits()->Add( outfits[i] );
+	}
+
+	for( i = 0; i < Count( COMPILED_MODELS ); i++ ) {
+		const CompiledModel *r = Records<CompiledModel>( COMPILED_MODELS ) + i;
+		const CompiledSlot *slot = Records<CompiledSlot>( COMPILED_SLOTS ) + r->firstSlot;
+		Image *image = Image::Defer( String( r->image ) );
+		vector<WeaponSlot> slots( r->numSlots );
+
+		for( j = 0; j < r->numSlots; j++, slot++ ) {
+			slots[j].name = String( slot->name );
+			slots[j].x = slot->x;
+			slots[j].y = slot->y;
+			slots[j].angle = slot->angle;
+			slots[j].motionAngle = slot->motionAngle;
+			slots[j].content = ( slot->weapon == COMPILED_NONE ) ? NULL : weapons[slot->weapon];
+			slots[j].firingGroup = static_cast<short int>( slot->firingGroup );
+		}
+
+		models[i] = new Model( String( r->name ), image, String( r->description ),
+		                       ( r->engine == COMPILED_NONE ) ? NULL : engines[r->engine],
+		                       r->mass, static_cast<short int>( r->thrustOffset ), r->rotPerSecond,
+		                       r->maxSpeed, r->hullStrength, r->shieldStrength, r->msrp,
+		                       r->cargoSpace, slots );
+		models[i]->SetPicture( image );
+		Image::Store( models[i]->GetName(), image );
+		scenario->GetModels()->Add( models[i] );
+	}
+
+	for( i = 0; i < Count( COMPILED_TECHNOLOGIES ); i++ ) {
+		const CompiledTechnology *r = Records<CompiledTechnology>( COMPILED_TECHNOLOGIES ) + i;
+		list<Model*> techModels;
+		list<Engine*> techEngines;
+		list<Weapon*> techWeapons;
+		list<Outfit*> techOutfits;
+
+		for( j = 0; j < r->numModels; j++ ) {
+			techModels.push_back( models[ References( r->firstModel )[j] ] );
+		}
+		for( j = 0; j < r->numEngines; j++ ) {
+			techEngines.push_back( engines[ References( r->firstEngine )[j] ] );
+		}
+		for( j = 0; j < r->numWeapons; j++ ) {
+			techWeapons.push_back( weapons[ References( r->firstWeapon )[j] ] );
+		}
+		for( j = 0; j < r->numOutfits; j++ ) {
+			techOutfits.push_back( outfits[ References( r->firstOutfit )[j] ] );
+		}
+
+		technologies[i] = new Technology( String( r->name ), techModels, techEngines, techWeapons, techOutfits );
+		scenario->GetTechnologies()->Add( technologies[i] );
+	}
+
+	for( i = 0; i < Count( COMPILED_PLANETS ); i++ ) {
+		const CompiledPlanet *r = Records<CompiledPlanet>( COMPILED_PLANETS ) + i;
+		Image *image = Image::Get( String( r->image ) );
+		list<Technology*> planetTechnologies;
+
+		if( image == NULL ) {
+			LogMsg(ERR, "Could not create Planet '%s'. Missing Image '%s'.", String( r->name ), String( r->image ) );
+			continue;
+		}
+
+		for( j = 0; j < r->numTechnologies; j++ ) {
+			planetTechnologies.push_back( technologies[ References( r->firstTechnology )[j] ] );
+		}
+
+		planets[i] = new Planet( String( r->name ), r->x, r->y, image, alliances[r->alliance],
+		                         r->landable != 0, Image::Defer( String( r->surface ) ),
+		                         String( r->summary ), planetTechnologies );
+		planets[i]->SetForbidden( r->forbidden != 0 );
+		scenario->GetPlanets()->Add( planets[i] );
+	}
+
+	for( i = 0; i < Count( COMPILED_SECTORS ); i++ ) {
+		const CompiledSector *r = Records<CompiledSector>( COMPILED_SECTORS ) + i;
+		const CompiledSector *sectors = Records<CompiledSector>( COMPILED_SECTORS );
+		const CompiledPlanet *planetRecords = Records<CompiledPlanet>( COMPILED_PLANETS );
+		list<string> sectorPlanets, neighbors;
+
+		for( j = 0; j < r->numPlanets; j++ ) {
+			sectorPlanets.push_back( String( planetRecords[ References( r->firstPlanet )[j] ].name ) );
+		}
+		for( j = 0; j < r->numNeighbors; j++ ) {
+			neighbors.push_back( String( sectors[ References( r->firstNeighbor )[j] ].name ) );
+		}
+
+		scenario->GetSectors()->Add( new Sector( String( r->name ), r->x, r->y, alliances[r->alliance],
+		                                         sectorPlanets, neighbors, r->traffic ) );
+	}
+
+	return true;
+}
+
+/**\brief Collects the records while a Scenario is compiled.
+ */
+class CompiledWriter {
+	public:
+		CompiledWriter() {
+			strings.push_back( '\0' ); // String 0 is ""
+		}
+
+		CompiledString Add( const string& s ) {
+			map<string,CompiledString>::iterator i = offsets.find( s );
+			if( i != offsets.end() ) {
+				return i->second;
+			}
+			if( s.empty() ) {
+				return 0;
+			}
+			CompiledString offset = static_cast<CompiledString>( strings.size() );
+			strings.insert( strings.end(), s.begin(), s.end() );
+			strings.push_back( '\0' );
+			offsets[s] = offset;
+			return offset;
+		}
+
+		CompiledString Add( Image *image ) { return Add( image ? image->GetPath() : string("") ); }
+		CompiledString Add( Sound *sound ) { return Add( sound ? sound->GetPath() : string("") ); }
+
+		// Appends the indices of the named Components to the references
+		template<class T> Uint32 Refer( const list<T*>& components, map<string,Uint32>& index, Uint32 *count ) {
+			Uint32 first = static_cast<Uint32>( references.size() );
+			typename list<T*>::const_iterator i;
+			for( i = components.begin(); i != components.end(); ++i ) {
+				map<string,Uint32>::iterator found = index.find( (*i)->GetName() );
+				if( found != index.end() ) {
+					references.push_back( found->second );
+				}
+			}
+			*count = static_cast<Uint32>( references.size() ) - first;
+			return first;
+		}
+
+		vector<char> strings;
+		map<string,CompiledString> offsets;
+		vector<Uint32> references;
+};
+
+/**\brief Indexes the Components of a collection by their names, in file order.
+ */
+static void IndexComponents( Components *components, map<string,Uint32>& index ) {
+	list<string> *names = components->GetNames();
+	list<string>::iterator i;
+	Uint32 n = 0;
+
+	for( i = names->begin(); i != names->end(); ++i ) {
+		index[*i] = n++;
+	}
+}
+
+/**\brief Appends a section to the file.
+ */
+static void WriteSection( vector<char>& file, CompiledHeader *header, CompiledSectionType section, const void *records, size_t count ) {
+	while( file.size() % 8 != 0 ) {
+		file.push_back( '\0' );
+	}
+
+	header->sections[section].offset = static_cast<Uint32>( file.size() );
+	header->sections[section].count = static_cast<Uint32>( count );
+
+	if( count > 0 ) {
+		const char *bytes = static_cast<const char*>( records );
+		file.insert( file.end(), bytes, bytes + count * compiledRecordSize[section] );
+	}
+}
+
+/**\brief Writes the Components of a loaded Scenario into its folder.
+ * \param sources The XML files that the Scenario was loaded from
+ */
+bool CompiledScenario::Compile( Scenario *scenario, const string& folderpath, const vector<string>& sources ) {
+	CompiledWriter writer;
+	CompiledHeader header;
+	map<string,Uint32> allianceIndex, engineIndex, weaponIndex, outfitIndex, modelIndex, technologyIndex, planetIndex, sectorIndex;
+	vector<CompiledCommodity> commodities;
+	vector<CompiledAlliance> alliances;
+	vector<CompiledEngine> engines;
+	vector<CompiledWeapon> weapons;
+	vector<CompiledOutfit> outfits;
+	vector<CompiledModel> models;
+	vector<CompiledSlot> slots;
+	vector<CompiledTechnology> technologies;
+	vector<CompiledPlanet> planets;
+	vector<CompiledSector> sectors;
+	list<string>::iterator n;
+	unsigned int s;
+
+	if( sources.size() > COMPILED_SCENARIO_MAX_SOURCES ) {
+		LogMsg(ERR, "A compiled Scenario can only remember %d source files.", COMPILED_SCENARIO_MAX_SOURCES );
+		return false;
+	}
+
+	memset( &header, 0, sizeof(header) );
+	header.magic = COMPILED_SCENARIO_MAGIC;
+	header.version = COMPILED_SCENARIO_VERSION;
+	header.epiarVersion = COMPILED_EPIAR_VERSION;
+	header.byteOrder = COMPILED_SCENARIO_BYTE_ORDER;
+	header.numSources = static_cast<Uint32>( sources.size() );
+	for( s = 0; s < sources.size(); s++ ) {
+		if( !StampSource( sources[s], &header.sources[s] ) ) {
+			LogMsg(ERR, "Could not find '%s'.", sources[s].c_str() );
+			return false;
+		}
+	}
+
+	IndexComponents( scenario->GetAlliances(), allianceIndex );
+	IndexComponents( scenario->GetEngines(), engineIndex );
+	IndexComponents( scenario->GetWeapons(), weaponIndex );
+	IndexComponents( scenario->GetOutfits(), outfitIndex );
+	IndexComponents( scenario->GetModels(), modelIndex );
+	IndexComponents( scenario->GetTechnologies(), technologyIndex );
+	IndexComponents( scenario->GetPlanets(), planetIndex );
+	IndexComponents( scenario->GetSectors(), sectorIndex );
+
+	for( n = scenario->GetCommodities()->GetNames()->begin(); n != scenario->GetCommodities()->GetNames()->end(); ++n ) {
+		Commodity *commodity = scenario->GetCommodities()->GetCommodity( *n );
+		CompiledCommodity r;
+		r.name = writer.Add( *n );
+		r.msrp = commodity->GetMSRP();
+		commodities.push_back( r );
+	}
+
+	for( n = scenario->GetAlliances()->GetNames()->begin(); n != scenario->GetAlliances()->GetNames()->end(); ++n ) {
+		Alliance *alliance = scenario->GetAlliances()->GetAlliance( *n );
+		CompiledAlliance r;
+		r.name = writer.Add( *n );
+		r.attackSize = alliance->GetAttackSize();
+		r.aggressiveness = alliance->GetAggressiveness();
+		r.currency = writer.Add( alliance->GetCurrency() );
+		r.r = alliance->GetColor().r;
+		r.g = alliance->GetColor().g;
+		r.b = alliance->GetColor().b;
+		alliances.push_back( r );
+	}
+
+	for( n = scenario->GetEngines()->GetNames()->begin(); n != scenario->GetEngines()->GetNames()->end(); ++n ) {
+		Engine *engine = scenario->GetEngines()->GetEngine( *n );
+		CompiledEngine r;
+		r.name = writer.Add( *n );
+		r.picture = writer.Add( engine->GetPicture() );
+		r.description = writer.Add( engine->GetDescription() );
+		r.sound = writer.Add( engine->GetSound() );
+		r.flareAnimation = writer.Add( engine->GetFlareAnimation() );
+		r.forceOutput = engine->GetForceOutput();
+		r.msrp = engine->GetMSRP();
+		r.foldDrive = engine->GetFoldDrive();
+		engines.push_back( r );
+	}
+
+	for( n = scenario->GetWeapons()->GetNames()->begin(); n != scenario->GetWeapons()->GetNames()->end(); ++n ) {
+		Weapon *weapon = scenario->GetWeapons()->GetWeapon( *n );
+		CompiledWeapon r;
+		r.name = writer.Add( *n );
+		r.image = writer.Add( weapon->GetImage() );
+		r.picture = writer.Add( weapon->GetPicture() );
+		r.description = writer.Add( weapon->GetDescription() );
+		r.sound = writer.Add( weapon->GetSound() );
+		r.weaponType = weapon->GetType();
+		r.payload = weapon->GetPayload();
+		r.velocity = weapon->GetVelocity();
+		r.acceleration = weapon->GetAcceleration();
+		r.ammoType = weapon->GetAmmoType();
+		r.ammoConsumption = weapon->GetAmmoConsumption();
+		r.fireDelay = weapon->GetFireDelay();
+		r.lifetime = weapon->GetLifetime();
+		r.tracking = weapon->GetTracking();
+		r.msrp = weapon->GetMSRP();
+		weapons.push_back( r );
+	}
+
+	for( n = scenario->GetOutfits()->GetNames()->begin(); n != scenario->GetOutfits()->GetNames()->end(); ++n ) {
+		Outfit *outfit = scenario->GetOutfits()->GetOutfit( *n );
+		CompiledOutfit r;
+		r.name = writer.Add( *n );
+		r.picture = writer.Add( outfit->GetPicture() );
+		r.description = writer.Add( outfit->GetDescription() );
+		r.msrp = outfit->GetMSRP();
+		r.rotPerSecond = outfit->GetRotationsPerSecond();
+		r.maxSpeed = outfit->GetMaxSpeed();
+		r.forceOutput = outfit->GetForceOutput();
+		r.mass = outfit->GetMass();
+		r.cargoSpace = outfit->GetCargoSpace();
+		r.surfaceArea = outfit->GetSurfaceArea();
+		r.hullStrength = outfit->GetHullStrength();
+		r.shieldStrength = outfit->GetShieldStrength();
+		outfits.push_back( r );
+	}
+
+	for( n = scenario->GetModels()->GetNames()->begin(); n != scenario->GetModels()->GetNames()->end(); ++n ) {
+		Model *model = scenario->GetModels()->GetModel( *n );
+		vector<WeaponSlot> modelSlots = model->GetWeaponSlots();
+		vector<WeaponSlot>::iterator w;
+		CompiledModel r;
+		r.name = writer.Add( *n );
+		r.image = writer.Add( model->GetImage() );
+		r.description = writer.Add( model->GetDescription() );
+		r.engine = model->GetDefaultEngine() ? engineIndex[ model->GetDefaultEngine()->GetName() ] : COMPILED_NONE;
+		r.mass = model->GetMass();
+		r.thrustOffset = model->GetThrustOffset();
+		r.rotPerSecond = model->GetRotationsPerSecond();
+		r.maxSpeed = model->GetMaxSpeed();
+		r.hullStrength = model->GetHullStrength();
+		r.shieldStrength = model->GetShieldStrength();
+		r.msrp = model->GetMSRP();
+		r.cargoSpace = model->GetCargoSpace();
+		r.firstSlot = static_cast<Uint32>( slots.size() );
+		r.numSlots = static_cast<Uint32>( modelSlots.size() );
+		for( w = modelSlots.begin(); w != modelSlots.end(); ++w ) {
+			CompiledSlot slot;
+			slot.name = writer.Add( w->name );
+			slot.x = w->x;
+			slot.y = w->y;
+			slot.angle = static_cast<float>( w->angle );
+			slot.motionAngle = static_cast<float>( w->motionAngle );
+			slot.weapon = w->content ? weaponIndex[ w->content->GetName() ] : COMPILED_NONE;
+			slot.firingGroup = w->firingGroup;
+			slots.push_back( slot );
+		}
+		models.push_back( r );
+	}
+
+	for( n = scenario->GetTechnologies()->GetNames()->begin(); n != scenario->GetTechnologies()->GetNames()->end(); ++n ) {
+		Technology *technology = scenario->GetTechnologies()->GetTechnology( *n );
+		CompiledTechnology r;
+		r.name = writer.Add( *n );
+		r.firstModel = writer.Refer( technology->GetModels(), modelIndex, &r.numModels );
+		r.firstEngine = writer.Refer( technology->GetEngines(), engineIndex, &r.numEngines );
+		r.firstWeapon = writer.Refer( technology->GetWeapons(), weaponIndex, &r.numWeapons );
+		r.firstOutfit = writer.Refer( technology->GetOutfits(), outfitIndex, &r.numOutfits );
+		technologies.push_back( r );
+	}
+
+	for( n = scenario->GetPlanets()->GetNames()->begin(); n != scenario->GetPlanets()->GetNames()->end(); ++n ) {
+		Planet *planet = scenario->GetPlanets()->GetPlanet( *n );
+		CompiledPlanet r;
+		r.name = writer.Add( *n );
+		r.x = static_cast<float>( planet->GetWorldPosition().GetX() );
+		r.y = static_cast<float>( planet->GetWorldPosition().GetY() );
+		r.image = writer.Add( planet->GetImage() );
+		r.surface = writer.Add( planet->GetSurfaceImage() );
+		r.summary = writer.Add( planet->GetSummary() );
+		r.alliance = allianceIndex[ planet->GetAlliance()->GetName() ];
+		r.landable = planet->GetLandable();
+		r.forbidden = planet->GetForbidden();
+		r.firstTechnology = writer.Refer( planet->GetTechnologies(), technologyIndex, &r.numTechnologies );
+		planets.push_back( r );
+	}
+
+	for( n = scenario->GetSectors()->GetNames()->begin(); n != scenario->GetSectors()->GetNames()->end(); ++n ) {
+		Sector *sector = scenario->GetSectors()->GetSector( *n );
+		list<string> names;
+		list<string>::iterator i;
+		CompiledSector r;
+		r.name = writer.Add( *n );
+		r.x = sector->GetX();
+		r.y = sector->GetY();
+		r.alliance = allianceIndex[ sector->GetAlliance()->GetName() ];
+		r.traffic = sector->GetTraffic();
+
+		names = sector->GetPlanets();
+		r.firstPlanet = static_cast<Uint32>( writer.references.size() );
+		for( i = names.begin(); i != names.end(); ++i ) {
+			if( planetIndex.find( *i ) != planetIndex.end() ) {
+				writer.references.push_back( planetIndex[*i] );
+			}
+		}
+		r.numPlanets = static_cast<Uint32>( writer.references.size() ) - r.firstPlanet;
+
+		names = sector->GetNeighbors();
+		r.firstNeighbor = static_cast<Uint32>( writer.references.size() );
+		for( i = names.begin(); i != names.end(); ++i ) {
+			if( sectorIndex.find( *i ) != sectorIndex.end() ) {
+				writer.references.push_back( sectorIndex[*i] );
+			}
+		}
+		r.numNeighbors = static_cast<Uint32>( writer.references.size() ) - r.firstNeighbor;
+
+		sectors.push_back( r );
+	}
+
+	// The header is filled in last, once the sections have been placed
+	vector<char> file( sizeof(CompiledHeader), '\0' );
+	WriteSection( file, &header, COMPILED_STRINGS, &writer.strings[0], writer.strings.size() );
+	WriteSection( file, &header, COMPILED_REFERENCES, writer.references.empty() ? NULL : &writer.references[0], writer.references.size() );
+	WriteSection( file, &header, COMPILED_COMMODITIES, commodities.empty() ? NULL : &commodities[0], commodities.size() );
+	WriteSection( file, &header, COMPILED_ALLIANCES, alliances.empty() ? NULL : &alliances[0], alliances.size() );
+	WriteSection( file, &header, COMPILED_ENGINES, engines.empty() ? NULL : &engines[0], engines.size() );
+	WriteSection( file, &header, COMPILED_WEAPONS, weapons.empty() ? NULL : &weapons[0], weapons.size() );
+	WriteSection( file, &header, COMPILED_OUTFITS, outfits.empty() ? NULL : &outfits[0], outfits.size() );
+	WriteSection( file, &header, COMPILED_MODELS, models.empty() ? NULL : &models[0], models.size() );
+	WriteSection( file, &header, COMPILED_SLOTS, slots.empty() ? NULL : &slots[0], slots.size() );
+	WriteSection( file, &header, COMPILED_TECHNOLOGIES, technologies.empty() ? NULL : &technologies[0], technologies.size() );
+	WriteSection( file, &header, COMPILED_PLANETS, planets.empty() ? NULL : &planets[0], planets.size() );
+	WriteSection( file, &header, COMPILED_SECTORS, sectors.empty() ? NULL : &sectors[0], sectors.size() );
+	memcpy( &file[0], &header, sizeof(header) );
+
+	string filename = folderpath + COMPILED_SCENARIO_FILE;
+	File compiled( filename, true );
+	if( !compiled.Write( &file[0], static_cast<long>( file.size() ) ) ) {
+		LogMsg(ERR, "Could not write the compiled Scenario to '%s'.", filename.c_str() );
+		return false;
+	}
+
+	LogMsg(INFO, "Compiled %d Components into '%s' (%d bytes).",
+		(int)( commodities.size() + alliances.size() + engines.size() + weapons.size() + outfits.size()
+		     + models.size() + technologies.size() + planets.size() + sectors.size() ),
+		filename.c_str(), (int)file.size() );
+
+	return true;
+}
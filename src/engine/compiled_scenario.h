@@ -0,0 +1,211 @@
+/**\file			compiled_scenario.h
+ * \author			Christopher Thielen (chris@epiar.net)
+ * \date			Created: Monday, October 19, 2026
+ * \date			Modified: Monday, October 19, 2026
+ * \brief			Scenario Components in a binary file that loads without parsing
+ * \details
+ */
+
+#ifndef __H_COMPILED_SCENARIO__
+#define __H_COMPILED_SCENARIO__
+
+#include "includes.h"
+#include "utilities/file.h"
+
+class Manifest;
+class Scenario;
+
+// The file is written next to scenario.xml
+#define COMPILED_SCENARIO_FILE "scenario.bin"
+#define COMPILED_SCENARIO_MAGIC 0x43535045 // "EPSC"
+// Change this whenever a record changes
+#define COMPILED_SCENARIO_VERSION 2
+// Written as a number, so that a file from a machine with another byte order looks stale
+#define COMPILED_SCENARIO_BYTE_ORDER 0x01020304
+// The XML files that the Components were compiled from: scenario.xml and one per Components
+#define COMPILED_SCENARIO_MAX_SOURCES 10
+// A record index that refers to nothing
+#define COMPILED_NONE 0xFFFFFFFF
+
+// Strings are kept once each, NUL terminated, in the string table
+typedef Uint32 CompiledString;
+
+typedef enum {
+	COMPILED_STRINGS,      ///< chars
+	COMPILED_REFERENCES,   ///< Uint32 record indices, for the lists in other records
+	COMPILED_COMMODITIES,
+	COMPILED_ALLIANCES,
+	COMPILED_ENGINES,
+	COMPILED_WEAPONS,
+	COMPILED_OUTFITS,
+	COMPILED_MODELS,
+	COMPILED_SLOTS,        ///< Weapon slots, for the Models
+	COMPILED_TECHNOLOGIES,
+	COMPILED_PLANETS,
+	COMPILED_SECTORS,
+	COMPILED_SECTIONS
+} CompiledSectionType;
+
+typedef struct {
+	Uint32 offset; ///< From the start of the file
+	Uint32 count; ///< Records, or bytes for the string table
+} CompiledSection;
+
+typedef struct {
+	Sint64 modified;
+	Sint64 length;
+} CompiledSource;
+
+typedef struct {
+	Uint32 magic;
+	Uint32 version;
+	Uint32 epiarVersion; ///< Major, minor and micro, one byte each
+	Uint32 byteOrder;
+	Uint32 numSources;
+	Uint32 reserved;
+	CompiledSource sources[COMPILED_SCENARIO_MAX_SOURCES];
+	CompiledSection sections[COMPILED_SECTIONS];
+} CompiledHeader;
+
+typedef struct {
+	CompiledString name;
+	Sint32 msrp;
+} CompiledCommodity;
+
+typedef struct {
+	CompiledString name;
+	Sint32 attackSize;
+	float aggressiveness;
+	CompiledString currency;
+	float r, g, b;
+} CompiledAlliance;
+
+typedef struct {
+	CompiledString name;
+	CompiledString picture;
+	CompiledString description;
+	CompiledString sound;
+	CompiledString flareAnimation;
+	float forceOutput;
+	Sint32 msrp;
+	Uint32 foldDrive;
+} CompiledEngine;
+
+typedef struct {
+	CompiledString name;
+	CompiledString image;
+	CompiledString picture;
+	CompiledString description;
+	CompiledString sound;
+	Sint32 weaponType;
+	Sint32 payload;
+	Sint32 velocity;
+	Sint32 acceleration;
+	Sint32 ammoType;
+	Sint32 ammoConsumption;
+	Sint32 fireDelay;
+	Sint32 lifetime;
+	float tracking;
+	Sint32 msrp;
+} CompiledWeapon;
+
+typedef struct {
+	CompiledString name;
+	CompiledString picture;
+	CompiledString description;
+	Sint32 msrp;
+	float rotPerSecond;
+	float maxSpeed;
+	float forceOutput;
+	float mass;
+	Sint32 cargoSpace;
+	Sint32 surfaceArea;
+	Sint32 hullStrength;
+	Sint32 shieldStrength;
+} CompiledOutfit;
+
+typedef struct {
+	CompiledString name;
+	CompiledString image;
+	CompiledString description;
+	Uint32 engine; ///< Index of the default Engine
+	float mass;
+	Sint32 thrustOffset;
+	float rotPerSecond;
+	float maxSpeed;
+	Sint32 hullStrength;
+	Sint32 shieldStrength;
+	Sint32 msrp;
+	Sint32 cargoSpace;
+	Uint32 firstSlot;
+	Uint32 numSlots;
+} CompiledModel;
+
+typedef struct {
+	CompiledString name;
+	Sint32 x, y;
+	float angle;
+	float motionAngle;
+	Uint32 weapon; ///< Index of the Weapon in the slot
+	Sint32 firingGroup;
+} CompiledSlot;
+
+typedef struct {
+	CompiledString name;
+	Uint32 firstModel, numModels;
+	Uint32 firstEngine, numEngines;
+	Uint32 firstWeapon, numWeapons;
+	Uint32 firstOutfit, numOutfits;
+} CompiledTechnology;
+
+typedef struct {
+	CompiledString name;
+	float x, y;
+	CompiledString image;
+	CompiledString surface;
+	CompiledString summary;
+	Uint32 alliance;
+	Uint32 landable;
+	Uint32 forbidden;
+	Uint32 firstTechnology, numTechnologies;
+} CompiledPlanet;
+
+typedef struct {
+	CompiledString name;
+	float x, y;
+	Uint32 alliance;
+	Sint32 traffic;
+	Uint32 firstPlanet, numPlanets;
+	Uint32 firstNeighbor, numNeighbors; ///< Indices of other Sectors
+} CompiledSector;
+
+class CompiledScenario {
+	public:
+		CompiledScenario();
+		~CompiledScenario();
+
+		bool Open( const string& folderpath, const vector<string>& sources );
+		void Close( void );
+
+		void AddResources( Manifest *manifest );
+		bool Build( Scenario *scenario );
+
+		static bool Compile( Scenario *scenario, const string& folderpath, const vector<string>& sources );
+
+	private:
+		template<class T> const T* Records( CompiledSectionType section ) {
+			return reinterpret_cast<const T*>( data + header->sections[section].offset );
+		}
+		Uint32 Count( CompiledSectionType section ) { return header->sections[section].count; }
+		const char* String( CompiledString s ) { return Records<char>( COMPILED_STRINGS ) + s; }
+		const Uint32* References( Uint32 first ) { return Records<Uint32>( COMPILED_REFERENCES ) + first; }
+
+		bool Validate( const vector<string>& sources );
+
+		File file;
+		const char *data; ///< The whole file, as mapped by file
+		long length;
+		const CompiledHeader *header;
+};
+
+#endif // __H_COMPILED_SCENARIO__
@@ -95,11 +95,11 @@ bool Engine::FromXMLNode( xmlDocPtr doc, xmlNodePtr node ) {
 	} else return false;
 
 	if( (attr = FirstChildNamed(node,"thrustSound")) ){
-		thrustsound = Sound::Get( NodeToString(doc,attr) );
+		thrustsound = Sound::Defer( NodeToString(doc,attr) );
 	} else return false;
 
 	if( (attr = FirstChildNamed(node,"picName")) ){
-		Image* pic = Image::Get( NodeToString(doc,attr) );
+		Image* pic = Image::Defer( NodeToString(doc,attr) );
 		// This image can be accessed by either the path or the Engine Name
 		Image::Store(name, pic);
 		SetPicture(pic);
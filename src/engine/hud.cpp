@@ -12,6 +12,7 @@
 #include "engine/scenario.h"
 #include "graphics/video.h"
 #include "graphics/font.h"
+#include "graphics/spritebatch.h"
 #include "sprites/player.h"
 #include "sprites/spritemanager.h"
 #include "ui/ui_navmap.h"
@@ -52,9 +53,21 @@ Sound *Hud::AlertBeep = NULL;
 
 int Radar::visibility = 4096.0f;
 //bool Radar::largeMode = false;
+SDL_Texture *Radar::texture = NULL;
+Uint32 Radar::lastUpdate = 0;
 
 Font *StatusBar::font = NULL;
 
+// The skin is drawn every frame, so it is only looked up once
+static ResourceHandle<Image> barLeft( "data/skin/hud_bar_left.png" );
+static ResourceHandle<Image> barMiddle( "data/skin/hud_bar_middle.png" );
+static ResourceHandle<Image> barRight( "data/skin/hud_bar_right.png" );
+static ResourceHandle<Image> hullLeft( "data/skin/hud_hullstr_leftbar.png" );
+static ResourceHandle<Image> hullMiddle( "data/skin/hud_hullstr_bar.png" );
+static ResourceHandle<Image> hullRight( "data/skin/hud_hullstr_rightbar.png" );
+static ResourceHandle<Image> shieldIntegrity( "data/skin/hud_shieldintegrity.png" );
+static ResourceHandle<Image> radarBackground( "data/skin/hud_radarnav.png" );
+
 /**\class AlertMessage
  * \brief Alert/Info messages
  */
@@ -135,9 +148,9 @@ StatusBar& StatusBar::operator=( StatusBar& object ){
 void StatusBar::Draw(int x, int y) {
 	int widthRemaining = this->width;
 
-	Image *BackgroundLeft = Image::Get( "data/skin/hud_bar_left.png" );
-	Image *BackgroundMiddle = Image::Get( "data/skin/hud_bar_middle.png" );
-	Image *BackgroundRight= Image::Get( "data/skin/hud_bar_right.png" );
+	Image *BackgroundLeft = barLeft;
+	Image *BackgroundMiddle = barMiddle;
+	Image *BackgroundRight = barRight;
 
 	if(pos == SBP_UPPER_RIGHT || pos == SBP_LOWER_RIGHT) {
 		x = Video::GetWidth() - BackgroundLeft->GetWidth() - width - BackgroundRight->GetWidth();
@@ -162,9 +175,9 @@ void StatusBar::Draw(int x, int y) {
 
 	// Draw the Bar
 	if ( (int)(ratio*widthRemaining) > 0 ) {
-		Image *BarLeft = Image::Get( "data/skin/hud_hullstr_leftbar.png" );
-		Image *BarMiddle = Image::Get( "data/skin/hud_hullstr_bar.png" );
-		Image *BarRight = Image::Get( "data/skin/hud_hullstr_rightbar.png" );
+		Image *BarLeft = hullLeft;
+		Image *BarMiddle = hullMiddle;
+		Image *BarRight = hullRight;
 
 		int bar_y = y + BackgroundLeft->GetHalfHeight() - BarLeft->GetHalfHeight();
 		BarLeft->Draw( x, bar_y );
@@ -262,6 +275,8 @@ void Hud::Close( void ) {
 	if(AlertFont != NULL) delete AlertFont;
 
 	AlertFont = NULL;
+
+	Radar::Close();
 }
 
 /**\brief Updates the HUD
@@ -288,14 +303,31 @@ void Hud::Update( lua_State *L ) {
 	}
 }
 
+/**\brief Copies what the Hud shows about the Sprites into a Snapshot
+ */
+void Hud::Capture( Snapshot* snapshot, Camera* camera, SpriteManager* sprites ) {
+	snapshot->numSprites = sprites->GetNumSprites();
+
+	Sprite* target = sprites->GetSpriteByID( targetID );
+	if(target != NULL) {
+		int edge = (target->GetImage())->GetWidth() / 6;
+		if(edge > 25) edge = 25;
+
+		snapshot->SetTarget( target->GetScreenPosition(), target->GetOldScreenPosition(),
+		                     target->GetRadarSize(), edge, target->GetRadarColor() );
+	}
+
+	Radar::Capture( snapshot, camera, sprites );
+}
+
 /**\brief Draws the Hud
  */
-void Hud::Draw( int flags, float fps, Camera* camera, SpriteManager* sprites ) {
-	if(flags & HUD_Target)     Hud::DrawTarget( sprites );
+void Hud::Draw( int flags, float fps, Snapshot* snapshot ) {
+	if(flags & HUD_Target)     Hud::DrawTarget( snapshot );
 	if(flags & HUD_Shield)     Hud::DrawShieldIntegrity();
-	if(flags & HUD_Radar)      Hud::DrawRadarNav( camera, sprites );
+	if(flags & HUD_Radar)      Hud::DrawRadarNav( snapshot );
 	if(flags & HUD_Messages)   Hud::DrawMessages();
-	if(flags & HUD_FPS)        Hud::DrawFPS(fps, sprites);
+	if(flags & HUD_FPS)        Hud::DrawFPS(fps, snapshot);
 	if(flags & HUD_StatusBars) Hud::DrawStatusBars();
 }
 
@@ -309,7 +341,7 @@ void Hud::HandleInput( list<InputEvent> & events, Camera* camera, SpriteManager*
 		// Mouse Clicks
 		if( i->type == MOUSE && i->mstate==MOUSELDOWN) {
 			if( (i->mx > Video::GetWidth() - 129)
-			 && (i->my < Image::Get( "data/skin/hud_radarnav.png" )->GetHeight() + 5) ) {
+			 && (i->my < Radar::GetHeight() + 5) ) {
 				//Radar::StartLargeMode(camera, sprites);
 			} else {
 				Coordinate screenPos(i->mx, i->my), worldPos;
@@ -350,25 +382,34 @@ void Hud::DrawMessages() {
 
 /**\brief Draw the current framerate (calculated in scenario.cpp).
  */
-void Hud::DrawFPS( float fps, SpriteManager* sprites ) {
-	char frameRate[18] = {0};
+void Hud::DrawFPS( float fps, Snapshot* snapshot ) {
+	char frameRate[32] = {0};
 
 	BitType->SetColor( WHITE );
 	snprintf(frameRate, sizeof(frameRate) - 1, "%.2f fps", fps );
 	BitType->Render( Video::GetWidth() - 100, Video::GetHeight() - 15, frameRate );
 
-	snprintf(frameRate, sizeof(frameRate) - 1, "%d Sprites", sprites->GetNumSprites());
+	snprintf(frameRate, sizeof(frameRate) - 1, "%d Sprites", snapshot->numSprites);
 	BitType->Render( Video::GetWidth() - 100, Video::GetHeight() - 30, frameRate );
+
+	snprintf(frameRate, sizeof(frameRate) - 1, "%.2f ms GC", Lua::GetGCTime());
+	BitType->Render( Video::GetWidth() - 100, Video::GetHeight() - 45, frameRate );
+
+	snprintf(frameRate, sizeof(frameRate) - 1, "%d KB Lua", Lua::GetMemoryKB());
+	BitType->Render( Video::GetWidth() - 100, Video::GetHeight() - 60, frameRate );
+
+	snprintf(frameRate, sizeof(frameRate) - 1, "%d Batches", SpriteBatch::GetFlushes());
+	BitType->Render( Video::GetWidth() - 100, Video::GetHeight() - 75, frameRate );
 }
 
 /**\brief Draws the status bar.
  */
 void Hud::DrawStatusBars() {
 	// Initialize the starting Coordinates
-	int barHeight = Image::Get( "data/skin/hud_bar_left.png" )->GetHeight() + 5;
+	int barHeight = barLeft->GetHeight() + 5;
 
 	Coordinate startCoords[4];
-	startCoords[SBP_UPPER_LEFT]  = Coordinate(5, Image::Get( "data/skin/hud_shieldintegrity.png" )->GetHeight() + 9);
+	startCoords[SBP_UPPER_LEFT]  = Coordinate(5, shieldIntegrity->GetHeight() + 9);
 	startCoords[SBP_UPPER_RIGHT] = Coordinate(5, Radar::GetHeight() + 9);
 	startCoords[SBP_LOWER_LEFT]  = Coordinate(5, Video::GetHeight()-barHeight);
 	startCoords[SBP_LOWER_RIGHT] = Coordinate(5, Video::GetHeight()-barHeight);
@@ -394,34 +435,27 @@ void Hud::DrawStatusBars() {
 /**\brief Draw the shield bar.
  */
 void Hud::DrawShieldIntegrity() {
-	Image::Get( "data/skin/hud_shieldintegrity.png" )->Draw( 35, 5 );
+	shieldIntegrity->Draw( 35, 5 );
 }
 
 /**\brief Draw the radar.
  */
-void Hud::DrawRadarNav( Camera* camera, SpriteManager* sprites ) {
-	Image::Get( "data/skin/hud_radarnav.png" )->Draw( Video::GetWidth() - 129, 5 );
-
-	Video::SetCropRect( Video::GetWidth() - 125, 9, RADAR_WIDTH - 8, RADAR_HEIGHT - 8 );
+void Hud::DrawRadarNav( Snapshot* snapshot ) {
+	Radar::GetBackground()->Draw( Video::GetWidth() - 129, 5 );
 
-	Radar::Draw( camera, sprites );
-
-	Video::UnsetCropRect();
+	Radar::Draw( snapshot );
 }
 
 /**\brief Draws the target.
  */
-void Hud::DrawTarget( SpriteManager* sprites ) {
-	Sprite* target = sprites->GetSpriteByID( targetID );
-
-	if(target != NULL) {
-		int edge = (target->GetImage())->GetWidth() / 6;
-		Coordinate targetScreenPosition = target->GetScreenPosition();
-		if(edge > 25) edge = 25;
-		int x = targetScreenPosition.GetX();
-		int y = targetScreenPosition.GetY();
-		int r = target->GetRadarSize();
-		Color c = target->GetRadarColor();
+void Hud::DrawTarget( Snapshot* snapshot ) {
+	if(snapshot->hasTarget) {
+		SnapshotTarget &target = snapshot->target;
+		int edge = target.edge;
+		int x = TO_INT( snapshot->Interpolate( target.ox, target.x ) );
+		int y = TO_INT( snapshot->Interpolate( target.oy, target.y ) );
+		int r = target.radarSize;
+		Color c = target.color;
 
 		if( (Timer::GetTicks() - timeTargeted) < OPTION(Uint32, "options/timing/target-zoom")) {
 			r += Video::GetHalfHeight() - Video::GetHalfHeight()*(Timer::GetTicks()-timeTargeted)/OPTION(Uint32,"options/timing/target-zoom");
@@ -695,6 +729,7 @@ Radar::Radar( void ) {
  */
 void Radar::SetVisibility( int visibility ) {
 	Radar::visibility = visibility;
+	Radar::lastUpdate = 0; // redraw the blips at the new scale
 	//if( largeMode ) {
 	//	Map* map = (Map*)UI::Search("/Map/");
 	//	assert( map );
@@ -722,12 +757,72 @@ void Radar::StopLargeMode() {
 }*/
 
 /**\brief Draws the radar.
+ * \details The blips are drawn into a texture at most options/video/radar-fps
+ *          times per second, and the texture is drawn every frame. If the
+ *          renderer can't draw to textures, the blips are drawn directly.
+ */
+void Radar::Draw( Snapshot* snapshot ) {
+	int x = Video::GetWidth() - 125;
+	int y = 9;
+	int w = RADAR_WIDTH - 8;
+	int h = RADAR_HEIGHT - 8;
+
+	if( texture == NULL && SDL_RenderTargetSupported( Video::GetRenderer() ) ) {
+		texture = SDL_CreateTexture( Video::GetRenderer(), SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, w, h );
+		if( texture != NULL ) {
+			SDL_SetTextureBlendMode( texture, SDL_BLENDMODE_BLEND );
+			lastUpdate = 0;
+		} else {
+			LogMsg(WARN, "Could not create the radar texture: %s", SDL_GetError() );
+		}
+	}
+
+	if( texture == NULL ) {
+		Video::SetCropRect( x, y, w, h );
+		DrawBlips( snapshot, RADAR_MIDDLE_X + Video::GetWidth() - 129, RADAR_MIDDLE_Y + 5 );
+		Video::UnsetCropRect();
+		return;
+	}
+
+	Uint32 now = Timer::GetTicks();
+	int fps = OPTION( int, "options/video/radar-fps" );
+
+	if( lastUpdate == 0 || fps <= 0 || now - lastUpdate >= 1000u / fps ) {
+		lastUpdate = now;
+
+		Video::SetRenderTarget( texture );
+		SDL_SetRenderDrawColor( Video::GetRenderer(), 0, 0, 0, 0 );
+		SDL_RenderClear( Video::GetRenderer() );
+
+		// The texture starts where the radar's crop rectangle used to be
+		DrawBlips( snapshot, RADAR_MIDDLE_X - 4, RADAR_MIDDLE_Y - 4 );
+
+		Video::SetRenderTarget( NULL );
+	}
+
+	SpriteBatch::Draw( texture, 0.f, 0.f, 1.f, 1.f,
+	                   static_cast<float>(x), static_cast<float>(y),
+	                   static_cast<float>(w), static_cast<float>(h), 0.f, 1.f );
+}
+
+/**\brief Copies the Sprites that the radar can see into a Snapshot.
+ */
+void Radar::Capture( Snapshot* snapshot, Camera* camera, SpriteManager* sprites ) {
+	// The radar doesn't care which blip is closest
+	list<Sprite*> *spriteList = sprites->GetSpritesNear(camera->GetFocusCoordinate(), (float)visibility, DRAW_ORDER_ALL, false);
+	for( list<Sprite*>::const_iterator iter = spriteList->begin(); iter != spriteList->end(); iter++) {
+		Sprite *sprite = *iter;
+		snapshot->AddBlip( sprite->GetID(), sprite->GetWorldPosition(), sprite->GetRadarSize(), sprite->GetRadarColor() );
+	}
+
+	delete spriteList;
+}
+
+/**\brief Draws the blips around the given center.
  */
-void Radar::Draw( Camera* camera, SpriteManager* sprites ) {
-	short int radar_mid_x = RADAR_MIDDLE_X + Video::GetWidth() - 129;
-	short int radar_mid_y = RADAR_MIDDLE_Y + 5;
+void Radar::DrawBlips( Snapshot* snapshot, int radar_mid_x, int radar_mid_y ) {
 	int radarSize;
-	Coordinate focus = camera->GetFocusCoordinate();
+	Coordinate focus = snapshot->focus;
 
 	/*if(largeMode) {
 		if( visibility <= QUADRANTSIZE )
@@ -742,14 +837,11 @@ void Radar::Draw( Camera* camera, SpriteManager* sprites ) {
 		return;
 	}*/
 
-	list<Sprite*> *spriteList = sprites->GetSpritesNear(camera->GetFocusCoordinate(), (float)visibility);
-	for( list<Sprite*>::const_iterator iter = spriteList->begin(); iter != spriteList->end(); iter++) {
+	for( vector<SnapshotBlip>::iterator iter = snapshot->blips.begin(); iter != snapshot->blips.end(); iter++) {
 		Coordinate blip;
-		Sprite *sprite = *iter;
 
 		// Calculate the blip coordinate for this sprite
-		Coordinate wpos = sprite->GetWorldPosition();
-		WorldToBlip( focus, wpos, blip );
+		WorldToBlip( focus, iter->position, blip );
 
 		// Use the OpenGL Crop Rectangle to ensure that the blip is on the radar
 
@@ -757,22 +849,20 @@ void Radar::Draw( Camera* camera, SpriteManager* sprites ) {
 		blip.SetX( blip.GetX() + radar_mid_x );
 		blip.SetY( blip.GetY() + radar_mid_y );
 
-		radarSize = int((sprite->GetRadarSize() / float(visibility)) * (RADAR_HEIGHT / 4.0));
+		radarSize = int((iter->radarSize / float(visibility)) * (RADAR_HEIGHT / 4.0));
 
 		if( radarSize >= 1 ) {
-			if(sprite->GetID() == Hud::GetTarget() && Timer::GetTicks() % 1000 < 100)
+			if(iter->id == Hud::GetTarget() && Timer::GetTicks() % 1000 < 100)
 				Video::DrawCircle( blip, radarSize, 2, WHITE );
 			else
-				Video::DrawCircle( blip, radarSize, 1, sprite->GetRadarColor() );
+				Video::DrawCircle( blip, radarSize, 1, iter->color );
 		} else {
-			if(sprite->GetID() == Hud::GetTarget() && Timer::GetTicks() % 1000 < 100)
+			if(iter->id == Hud::GetTarget() && Timer::GetTicks() % 1000 < 100)
 				Video::DrawCircle( blip, 1, 2, WHITE );
 			else
-				Video::DrawPoint( blip, sprite->GetRadarColor() );
+				Video::DrawPoint( blip, iter->color );
 		}
 	}
-
-	delete spriteList;
 }
 
 /**\brief Gets the radar position based on world coordinate
@@ -788,6 +878,21 @@ int Radar::GetHeight() {
 	//if( largeMode ) {
 	//	return 300;
 	//} else {
-		return Image::Get( "data/skin/hud_radarnav.png" )->GetHeight();
+		return GetBackground()->GetHeight();
 	//}
 }
+
+/**\brief Returns the radar's frame, looking it up the first time.
+ */
+Image* Radar::GetBackground() {
+	return radarBackground;
+}
+
+/**\brief Frees the radar texture.
+ */
+void Radar::Close() {
+	if( texture != NULL ) {
+		SDL_DestroyTexture( texture );
+		texture = NULL;
+	}
+}
@@ -15,6 +15,7 @@
 #include "input/input.h"
 #include "graphics/font.h"
 #include "graphics/image.h"
+#include "engine/snapshot.h"
 #include "sprites/spritemanager.h"
 #include "utilities/lua.h"
 
@@ -83,7 +84,8 @@ class Hud {
 		static void Close( void );
 
 		static void Update( lua_State *L );
-		static void Draw( int flags, float fps, Camera* camera, SpriteManager* sprites );
+		static void Capture( Snapshot* snapshot, Camera* camera, SpriteManager* sprites );
+		static void Draw( int flags, float fps, Snapshot* snapshot );
 
 		static void HandleInput( list<InputEvent> & events, Camera* camera, SpriteManager* sprites );
 		
@@ -114,11 +116,11 @@ class Hud {
 
 	private:
 		static void DrawShieldIntegrity();
-		static void DrawRadarNav( Camera* camera, SpriteManager* sprites );
+		static void DrawRadarNav( Snapshot* snapshot );
 		static void DrawMessages();
-		static void DrawFPS( float fps, SpriteManager* sprites );
+		static void DrawFPS( float fps, Snapshot* snapshot );
 		static void DrawStatusBars();
-		static void DrawTarget(SpriteManager* sprites);
+		static void DrawTarget( Snapshot* snapshot );
 		static void DrawMap( Camera* camera, SpriteManager* sprites );
 		static void DrawUniverseMap( Camera* camera, SpriteManager* sprites );
 
@@ -137,18 +139,24 @@ class Hud {
 class Radar {
 	public:
 		Radar( void );
-		static void Draw( Camera* camera, SpriteManager* sprites );
+		static void Capture( Snapshot* snapshot, Camera* camera, SpriteManager* sprites );
+		static void Draw( Snapshot* snapshot );
 		static void SetVisibility( int visibility );
 		static int GetVisibility() { return visibility;}
 		//static void StartLargeMode( Camera* camera, SpriteManager* sprites );
 		static int GetHeight();
+		static Image* GetBackground();
+		static void Close();
 	
 	private:
+		static void DrawBlips( Snapshot* snapshot, int mid_x, int mid_y );
 		static void WorldToBlip( Coordinate focus, Coordinate &w, Coordinate &b );
 		//static void StopLargeMode();
 	
 		static int visibility;
 		static bool largeMode;
+		static SDL_Texture *texture; // blips from the last radar update
+		static Uint32 lastUpdate;
 };
 
 #endif // __h_hud__
@@ -0,0 +1,155 @@
+/**\file			manifest.cpp
+ * \author			Christopher Thielen (chris@epiar.net)
+ * \date			Created: Monday, October 19, 2026
+ * \date			Modified: Monday, October 19, 2026
+ * \brief			Lists the Resources that a Scenario uses
+ * \details
+ */
+
+#include "includes.h"
+#include "audio/sound.h"
+#include "engine/manifest.h"
+#include "graphics/animation.h"
+#include "graphics/image.h"
+#include "utilities/file.h"
+#include "utilities/loader.h"
+#include "utilities/log.h"
+#include "utilities/xmlfile.h"
+
+/**\class Manifest
+ * \brief Every Image, Animation and Sound that a Scenario refers to.
+ * \details The Components ask for their Resources one at a time while their
+ *          XML is parsed. Reading the files into a Manifest first lets
+ *          WarmUp queue all of them at once, so that every Loader thread
+ *          has something to decode from the start.
+ * \sa Scenario::Load
+ */
+
+// The tags that name a Resource, in any of the Component files
+static const struct {
+	const char *tag;
+	ManifestType type;
+} manifestTags[] = {
+	{ "image",          MANIFEST_IMAGE },     // Models, Planets
+	{ "imageName",      MANIFEST_IMAGE },     // Weapons
+	{ "picName",        MANIFEST_IMAGE },     // Engines, Outfits, Weapons
+	{ "surface-image",  MANIFEST_IMAGE },     // Planets
+	{ "flareAnimation", MANIFEST_ANIMATION }, // Engines
+	{ "thrustSound",    MANIFEST_SOUND },     // Engines
+	{ "sound",          MANIFEST_SOUND },     // Weapons
+};
+
+/**\brief Creates an empty Manifest.
+ */
+Manifest::Manifest() {
+}
+
+/**\brief Adds a Resource, unless it is already listed.
+ */
+void Manifest::Add( ManifestType type, const string& path ) {
+	if( path.empty() ) {
+		return;
+	}
+
+	switch( type ) {
+		case MANIFEST_IMAGE:
+			images.insert( path );
+			break;
+		case MANIFEST_ANIMATION:
+			animations.insert( path );
+			break;
+		case MANIFEST_SOUND:
+			sounds.insert( path );
+			break;
+	}
+}
+
+/**\brief Adds every Resource named in a Component file.
+ * \details Only the tags are looked at; the Components themselves still
+ *          check the file when they load it.
+ * \return false if the file could not be parsed
+ */
+bool Manifest::Read( const string& filename ) {
+	xmlDocPtr doc;
+	xmlNodePtr root, cur, attr;
+	unsigned int t;
+
+	File xmlfile( filename );
+	long filelen = xmlfile.GetLength();
+	const char *buffer = xmlfile.Map();
+	if( buffer == NULL ) {
+		return false;
+	}
+	doc = xmlParseMemory( buffer, static_cast<int>(filelen) );
+	xmlfile.Unmap();
+
+	if( doc == NULL ) {
+		return false;
+	}
+
+	root = xmlDocGetRootElement( doc );
+	if( root == NULL ) {
+		xmlFreeDoc( doc );
+		return false;
+	}
+
+	for( cur = root->xmlChildrenNode; cur != NULL; cur = cur->next ) {
+		for( t = 0; t < sizeof(manifestTags) / sizeof(manifestTags[0]); t++ ) {
+			for( attr = FirstChildNamed( cur, manifestTags[t].tag ); attr != NULL; attr = NextSiblingNamed( attr, manifestTags[t].tag ) ) {
+				Add( manifestTags[t].type, NodeToString( doc, attr ) );
+			}
+		}
+	}
+
+	xmlFreeDoc( doc );
+
+	return true;
+}
+
+/**\brief Loads every Resource in the Manifest.
+ * \details The Resources are queued all at once and decoded on the Loader's
+ *          threads, while this thread uploads whatever has been decoded.
+ *          Call this from the render thread, before the logic thread starts.
+ * \param progress Called with how much has been loaded, from 0.0 to 1.0
+ */
+void Manifest::WarmUp( void (*progress)( float fraction ) ) {
+	set<string>::iterator i;
+	int queued, pending, shown = -1;
+	Uint32 start = SDL_GetTicks();
+
+	if( Size() == 0 ) {
+		return;
+	}
+
+	LogMsg(INFO, "Loading %d Images, %d Animations and %d Sounds.",
+		(int)images.size(), (int)animations.size(), (int)sounds.size() );
+
+	for( i = images.begin(); i != images.end(); ++i ) {
+		Image::Get( *i );
+	}
+	for( i = animations.begin(); i != animations.end(); ++i ) {
+		Ani::Get( *i );
+	}
+	for( i = sounds.begin(); i != sounds.end(); ++i ) {
+		Sound::Get( *i );
+	}
+
+	// Resources that were already loaded, or that don't exist, queue nothing
+	queued = Loader::GetPending();
+
+	while( (pending = Loader::GetPending()) > 0 ) {
+		if( progress && pending != shown ) {
+			progress( static_cast<float>( queued - pending ) / queued );
+			shown = pending;
+		}
+
+		Loader::Update();
+		SDL_Delay( 1 );
+	}
+
+	if( progress ) {
+		progress( 1.f );
+	}
+
+	LogMsg(INFO, "Loaded the Scenario's Resources in %d ms.", SDL_GetTicks() - start );
+}
@@ -0,0 +1,37 @@
+/**\file			manifest.h
+ * \author			Christopher Thielen (chris@epiar.net)
+ * \date			Created: Monday, October 19, 2026
+ * \date			Modified: Monday, October 19, 2026
+ * \brief			Lists the Resources that a Scenario uses
+ * \details
+ */
+
+#ifndef __H_MANIFEST__
+#define __H_MANIFEST__
+
+#include "includes.h"
+
+typedef enum {
+	MANIFEST_IMAGE,
+	MANIFEST_ANIMATION,
+	MANIFEST_SOUND
+} ManifestType;
+
+class Manifest {
+	public:
+		Manifest();
+
+		void Add( ManifestType type, const string& path );
+		bool Read( const string& filename );
+
+		void WarmUp( void (*progress)( float fraction ) = NULL );
+
+		int Size( void ) { return (int)( images.size() + animations.size() + sounds.size() ); }
+
+	private:
+		set<string> images;
+		set<string> animations;
+		set<string> sounds;
+};
+
+#endif // __H_MANIFEST__
@@ -11,6 +11,7 @@
 #include "utilities/lua.h"
 #include "utilities/log.h"
 #include "utilities/components.h"
+#include "sprites/spritemanager.h"
 
 /**\class Mission
  * \brief A Goal for the Player to complete for rewards.
@@ -37,20 +38,30 @@ MissionType = {
 	end,
 	Accept = function( missionTable ) end, --- Call this when the Mission is accepted.
 	Reject = function( missionTable ) end, --- Call this when the Mission is rejected after being accepted.
+	Success = function( missionTable ) end, --- Call this if the Mission is a Success.
+	Failure = function( missionTable ) end, --- Call this if the Mission is a failure.
+
+	--- The following are optional. A Mission only runs Lua for the events it defines.
+	UpdateInterval = 1000, --- Milliseconds between Update calls. Omit to Update every logic tick.
 	Update = function( missionTable ) --- Call this each time that the Mission should be checked.
 		return nil --- Return nil when the mission isn't over yet.
 		return true --- Return true when the mission has succeded.
 		return false --- Return false when the mission has failed.
 	end,
-	Land = function( missionTable ) --- Call this each time that player lands
-		return nil --- Return nil when the mission isn't over yet.
-		return true --- Return true when the mission has succeded.
-		return false --- Return false when the mission has failed.
-	end,
-	Success = function( missionTable ) end, --- Call this if the Mission is a Success.
-	Failure = function( missionTable ) end, --- Call this if the Mission is a failure.
+	Land = function( missionTable ) end, --- Call this each time that player lands
+	Jump = function( missionTable, sectorName ) end, --- Call this when the player arrives in a new sector
+	Kill = function( missionTable, spriteID ) end, --- Call this when a ship is destroyed or leaves the sector
+	NewDay = function( missionTable ) end, --- Call this when the Calendar period changes
+	Arrive = function( missionTable ) end, --- Call this when the player enters the radius of missionTable.Watch
 }
 \endverbatim
+ *
+ * The optional event functions return nil, true or false just like Update.
+ *
+ * Arrive is driven by a Watch table in the MissionTable, either
+ * { id = spriteID, radius = r } or { x = x, y = y, radius = r }.
+ * A MissionTable may also set its own UpdateInterval, which overrides the one
+ * in the MissionType. Both are re-read after every event function runs.
  *
  * The MissionTable is more loosely described, but must contain a "Name" and "Description".
  * This table is generated by calling the MissionTable's Create function.
@@ -68,13 +79,31 @@ MissionType = {
  * \see data/scripts/missions.lua
  */
 
+/**\brief The Mission Type functions for each Handler.
+ */
+const char *Mission::handlerNames[Mission::MAX_HANDLERS] = {
+	"Update",
+	"Land",
+	"Jump",
+	"Kill",
+	"NewDay",
+	"Arrive",
+};
+
 /**\brief Mission Constructor
  */
 Mission::Mission( lua_State *_L, string _type, int _tableReference)
 	:L(_L)
 	,type(_type)
 	,tableReference(_tableReference)
+	,updateInterval(0)
+	,nextUpdate(0)
+	,watchSprite(-1)
+	,watchRadius(0)
+	,inside(false)
 {
+	FindHandlers();
+	ReadSubscriptions();
 }
 
 /**\brief Mission Destructor
@@ -94,8 +123,6 @@ bool Mission::ValidateMission( lua_State *L, string type, int tableReference, in
 		"Create",
 		"Accept",
 		"Reject",
-		"Update",
-		"Land",
 		"Success",
 		"Failure",
 	};
@@ -208,12 +235,50 @@ bool Mission::Accept()
 	return RunFunction( "Accept", false );
 }
 
-/**\brief 
+/**\brief Run the per-tick checks, calling into Lua only when needed.
+ * \details Update is only called once its interval has passed, and Arrive
+ * only when the Player crosses into the watched radius.
+ * \param now The current Timer ticks
+ * \param position The Player's world position
+ * \param sprites Used to find the watched sprite
  * \returns True if the Mission is over (success, failure, or error) and should be deleted.
  */
-bool Mission::Update()
+bool Mission::Update( Uint32 now, Coordinate position, SpriteManager *sprites )
 {
-	return RunFunction( "Update", true );
+	if( handlers[HANDLER_ARRIVE] && (watchRadius > 0) )
+	{
+		bool isInside = false;
+		Coordinate center = watchPoint;
+		Sprite *watched = NULL;
+
+		if( watchSprite != -1 ) {
+			watched = sprites->GetSpriteByID( watchSprite );
+			if( watched != NULL ) {
+				center = watched->GetWorldPosition();
+			}
+		}
+
+		if( (watchSprite == -1) || (watched != NULL) ) {
+			isInside = (center - position).GetMagnitudeSquared() < watchRadius * watchRadius;
+		}
+
+		if( isInside && !inside ) {
+			inside = true;
+			if( RunHandler( HANDLER_ARRIVE, 0 ) ) {
+				return true;
+			}
+		} else {
+			inside = isInside;
+		}
+	}
+
+	if( handlers[HANDLER_UPDATE] && (now >= nextUpdate) )
+	{
+		nextUpdate = now + updateInterval;
+		return RunHandler( HANDLER_UPDATE, 0 );
+	}
+
+	return false;
 }
 
 /**\brief 
@@ -221,7 +286,35 @@ bool Mission::Update()
  */
 bool Mission::Land( )
 {
-	return RunFunction( "Land", true );
+	return RunHandler( HANDLER_LAND, 0 );
+}
+
+/**\brief Tell the Mission that the Player has jumped into a new Sector.
+ * \returns True if the Mission is over (success, failure, or error) and should be deleted.
+ */
+bool Mission::Jump( string sectorName )
+{
+	if( !handlers[HANDLER_JUMP] ) return false;
+	lua_pushstring( L, sectorName.c_str() );
+	return RunHandler( HANDLER_JUMP, 1 );
+}
+
+/**\brief Tell the Mission that a ship has been removed from the Sector.
+ * \returns True if the Mission is over (success, failure, or error) and should be deleted.
+ */
+bool Mission::Kill( int spriteID )
+{
+	if( !handlers[HANDLER_KILL] ) return false;
+	lua_pushinteger( L, spriteID );
+	return RunHandler( HANDLER_KILL, 1 );
+}
+
+/**\brief Tell the Mission that the Calendar period has changed.
+ * \returns True if the Mission is over (success, failure, or error) and should be deleted.
+ */
+bool Mission::NewDay()
+{
+	return RunHandler( HANDLER_NEWDAY, 0 );
 }
 
 void Mission::PushMissionTable()
@@ -261,12 +354,107 @@ int Mission::GetVersion()
 	return version;
 }
 
+/**\brief Record which of the optional event functions the Mission Type defines.
+ */
+void Mission::FindHandlers()
+{
+	const int initialStackTop = lua_gettop(L);
+
+	for( int i = 0; i < MAX_HANDLERS; ++i ) {
+		handlers[i] = false;
+	}
+
+	if( Mission::GetMissionType(L, type) != 1 ) {
+		lua_settop(L, initialStackTop );
+		return;
+	}
+
+	for( int i = 0; i < MAX_HANDLERS; ++i ) {
+		lua_getfield(L, initialStackTop + 1, handlerNames[i] );
+		handlers[i] = lua_isfunction(L, lua_gettop(L));
+		lua_pop(L, 1);
+	}
+
+	lua_settop(L, initialStackTop );
+}
+
+/**\brief Read the UpdateInterval and Watch settings for this Mission.
+ */
+void Mission::ReadSubscriptions()
+{
+	const int initialStackTop = lua_gettop(L);
+
+	PushMissionTable();
+	const int missionTableIndex = lua_gettop(L);
+
+	// The Mission Table's interval wins over the Mission Type's
+	updateInterval = 0;
+	lua_getfield(L, missionTableIndex, "UpdateInterval" );
+	if( lua_isnumber(L, lua_gettop(L)) ) {
+		updateInterval = static_cast<Uint32>( lua_tonumber(L, lua_gettop(L)) );
+	} else if( Mission::GetMissionType(L, type) == 1 ) {
+		lua_getfield(L, lua_gettop(L), "UpdateInterval" );
+		if( lua_isnumber(L, lua_gettop(L)) ) {
+			updateInterval = static_cast<Uint32>( lua_tonumber(L, lua_gettop(L)) );
+		}
+	}
+	lua_settop(L, missionTableIndex );
+
+	int oldSprite = watchSprite;
+	Coordinate oldPoint = watchPoint;
+
+	watchSprite = -1;
+	watchRadius = 0;
+	lua_getfield(L, missionTableIndex, "Watch" );
+	if( lua_istable(L, lua_gettop(L)) ) {
+		const int watchIndex = lua_gettop(L);
+
+		lua_getfield(L, watchIndex, "radius" );
+		watchRadius = static_cast<float>( lua_tonumber(L, lua_gettop(L)) );
+		lua_getfield(L, watchIndex, "id" );
+		if( lua_isnumber(L, lua_gettop(L)) ) {
+			watchSprite = lua_tointeger(L, lua_gettop(L));
+		}
+		lua_getfield(L, watchIndex, "x" );
+		lua_getfield(L, watchIndex, "y" );
+		watchPoint = Coordinate( lua_tonumber(L, -2), lua_tonumber(L, -1) );
+	}
+
+	// Arrive fires again when the Player is already inside a new Watch
+	if( (watchSprite != oldSprite) || (watchPoint.GetX() != oldPoint.GetX()) || (watchPoint.GetY() != oldPoint.GetY()) ) {
+		inside = false;
+	}
+
+	lua_settop(L, initialStackTop );
+}
+
+/**\brief Run one of the optional event functions, if the Mission Type has it.
+ * \param handler The event function to run
+ * \param nargs The number of arguments already pushed onto the stack
+ * \returns true when this Mission is complete
+ */
+bool Mission::RunHandler(Handler handler, int nargs)
+{
+	if( !handlers[handler] ) {
+		lua_pop(L, nargs);
+		return false;
+	}
+
+	if( RunFunction( handlerNames[handler], true, nargs ) ) {
+		return true;
+	}
+
+	ReadSubscriptions();
+	return false;
+}
+
 /**\brief
+ * \param nargs The number of arguments already pushed onto the stack, passed after the MissionTable
  * \returns true when this Mission is complete
  */
-bool Mission::RunFunction(string functionName, bool checkCompletion)
+bool Mission::RunFunction(string functionName, bool checkCompletion, int nargs)
 {
-	const int initialStackTop = lua_gettop(L);
+	const int initialStackTop = lua_gettop(L) - nargs;
 
 	if( Mission::GetMissionType(L, type) != 1 ) {
 		LogMsg(ERR, "Something bad happened?"); // TODO
@@ -276,7 +464,7 @@ bool Mission::RunFunction(string functionName, bool checkCompletion)
 
 	// Get the function
 	lua_pushstring(L, functionName.c_str() );
-	lua_gettable(L,initialStackTop + 1);
+	lua_gettable(L, initialStackTop + nargs + 1);
 	if( ! lua_isfunction(L,lua_gettop(L)) )
 	{
 		LogMsg(ERR, "The Mission Type named '%s' cannot %s!", type.c_str(), functionName.c_str() );
@@ -285,9 +473,12 @@ bool Mission::RunFunction(string functionName, bool checkCompletion)
 	}
 
 	lua_rawgeti(L, LUA_REGISTRYINDEX, tableReference);
+	for( int i = 1; i <= nargs; ++i ) {
+		lua_pushvalue(L, initialStackTop + i);
+	}
 	
 	// Call the function
-	if( lua_pcall(L, 1, LUA_MULTRET, 0) != 0)
+	if( lua_pcall(L, 1 + nargs, LUA_MULTRET, 0) != 0)
 	{
 		LogMsg(ERR,"Failed to run %s.%s: %s\n", type.c_str(), functionName.c_str(), lua_tostring(L, -1));
 		lua_settop(L,initialStackTop);
@@ -309,6 +500,7 @@ bool Mission::RunFunction(string functionName, bool checkCompletion)
 			RunFunction( "Failure", false);
 		}
 
+		lua_settop(L, initialStackTop);
 		return true;
 	}
 
@@ -11,6 +11,9 @@
 
 #include "includes.h"
 #include "common.h"
+#include "utilities/coordinate.h"
+
+class SpriteManager;
 
 class Mission{
 	public:
@@ -21,8 +24,11 @@ class Mission{
 
 		bool Accept();
 		bool Reject();
-		bool Update();
+		bool Update( Uint32 now, Coordinate position, SpriteManager *sprites );
 		bool Land();
+		bool Jump( string sectorName );
+		bool Kill( int spriteID );
+		bool NewDay();
 
 		int GetVersion();
 		string GetName() { return GetStringAttribute("Name"); }
@@ -38,7 +44,21 @@ class Mission{
 		string type; ///< The Mission Type
 		int tableReference; ///< A Lua table to hold
 
-		bool RunFunction(string functionName, bool checkCompletion);
+		// Event subscriptions
+		enum Handler { HANDLER_UPDATE, HANDLER_LAND, HANDLER_JUMP, HANDLER_KILL, HANDLER_NEWDAY, HANDLER_ARRIVE, MAX_HANDLERS };
+		static const char *handlerNames[MAX_HANDLERS];
+		bool handlers[MAX_HANDLERS]; ///< Which optional functions the Mission Type defines
+		Uint32 updateInterval; ///< Milliseconds between Update calls, 0 for every logic tick
+		Uint32 nextUpdate; ///< Timestamp of the next Update call
+		int watchSprite; ///< Sprite whose surroundings trigger Arrive, -1 to use watchPoint
+		Coordinate watchPoint; ///< Point whose surroundings trigger Arrive
+		float watchRadius; ///< Radius that triggers Arrive, 0 when nothing is watched
+		bool inside; ///< Whether the Player was inside the watched radius last tick
+
+		void FindHandlers();
+		void ReadSubscriptions();
+		bool RunHandler(Handler handler, int nargs);
+		bool RunFunction(string functionName, bool checkCompletion, int nargs = 0);
 		string GetStringAttribute(string attribute);
 		static int GetMissionType( lua_State *L, string type );
 };
@@ -126,7 +126,7 @@ bool Model::FromXMLNode( xmlDocPtr doc, xmlNodePtr node ) {
 	string value;
 
 	if( (attr = FirstChildNamed(node,"image")) ){
-		image = Image::Get( NodeToString(doc,attr) );
+		image = Image::Defer( NodeToString(doc,attr) );
 		Image::Store(name, image);
 		SetPicture(image);
 	} else return false;
@@ -139,7 +139,7 @@ bool Model::FromXMLNode( xmlDocPtr doc, xmlNodePtr node ) {
 	}
 
 	if( (attr = FirstChildNamed(node,"engine")) ){
-		defaultEngine = Menu::GetCurrentScenario()->GetEngines()->GetEngine( NodeToString(doc,attr) );
+		engineName = NodeToString(doc,attr);
 	} else return false;
 
 	if( (attr = FirstChildNamed(node,"mass")) ){
@@ -254,7 +254,7 @@ xmlNodePtr Model::ToXMLNode(string componentName) {
 bool Model::ConfigureWeaponSlots( xmlDocPtr doc, xmlNodePtr node ) {
 
 	xmlNodePtr slotPtr;
-	string value;
+	string value, weaponName;
 
 	//if( (slotPtr = FirstChildNamed(node,"slot")) ){
         for( slotPtr = FirstChildNamed(node,"slot"); slotPtr != NULL; slotPtr = NextSiblingNamed(slotPtr,"slot") ){
@@ -296,7 +296,8 @@ bool Model::ConfigureWeaponSlots( xmlDocPtr doc, xmlNodePtr node ) {
 			else
 				value = ""; // slot is empty
 
-			newSlot.content = Menu::GetCurrentScenario()->GetWeapons()->GetWeapon( value );
+			newSlot.content = NULL; // Found by Link
+			weaponName = value;
 		} else return false;
 
 		if( (attr = FirstChildNamed(slotPtr,"firingGroup")) ){
@@ -304,6 +305,7 @@ bool Model::ConfigureWeaponSlots( xmlDocPtr doc, xmlNodePtr node ) {
 		} else return false;
 
 		weaponSlots.push_back(newSlot);
+		weaponNames.push_back(weaponName);
 	}
 
         return true;
@@ -313,9 +315,30 @@ bool Model::ConfigureWeaponSlots( xmlDocPtr doc, xmlNodePtr node ) {
  */
 bool Model::ConfigureWeaponSlots( vector<WeaponSlot>& slots ) {
         this->weaponSlots = slots;
+        this->weaponNames.clear();
         return true;
 }
 
+/**\brief Finds the default Engine and the Weapons in the slots.
+ */
+bool Model::Link( void ) {
+	Scenario *scenario = Menu::GetCurrentScenario();
+
+	if( !engineName.empty() ) {
+		defaultEngine = scenario->GetEngines()->GetEngine( engineName );
+		engineName = "";
+	}
+
+	if( weaponNames.size() == weaponSlots.size() ) {
+		for( unsigned int i = 0; i < weaponSlots.size(); i++ ) {
+			weaponSlots[i].content = scenario->GetWeapons()->GetWeapon( weaponNames[i] );
+		}
+	}
+	weaponNames.clear();
+
+	return true;
+}
+
 /**\brief Return the total number of weapon slots of any kind that this Model (probably a Model) has.
  */
 int Model::GetWeaponSlotCount(){
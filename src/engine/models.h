@@ -46,6 +46,7 @@ class Model : public Outfit {
 				vector<WeaponSlot>& _weaponSlots);
 
 		bool FromXMLNode( xmlDocPtr doc, xmlNodePtr node );
+		bool Link( void );
 		xmlNodePtr ToXMLNode(string componentName);
 		
 		Image *GetImage( void ) { return image; }
@@ -63,6 +64,8 @@ class Model : public Outfit {
 		Engine* defaultEngine; ///< The default Engine for this model
 		short int thrustOffset; ///< The number of pixels engine flare animation offset
 		vector<WeaponSlot> weaponSlots; ///< Slots for Weapons
+		string engineName; ///< The default Engine, until Link finds it
+		vector<string> weaponNames; ///< The Weapon in each slot, until Link finds them
 		// Debug
 		void WSDebug(vector<WeaponSlot>&);
 		void WSDebug(WeaponSlot);
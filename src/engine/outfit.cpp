@@ -130,7 +130,7 @@ bool Outfit::FromXMLNode( xmlDocPtr doc, xmlNodePtr node ) {
 	} else return false;
 
 	if( (attr = FirstChildNamed(node,"picName")) ){
-		Image* pic = Image::Get( NodeToString(doc,attr) );
+		Image* pic = Image::Defer( NodeToString(doc,attr) );
 		// This image can be accessed by either the path or the Engine Name
 		Image::Store(name, pic);
 		SetPicture(pic);
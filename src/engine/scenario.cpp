@@ -14,11 +14,14 @@
 #include "engine/calendar.h"
 #include "engine/calendar_lua.h"
 #include "engine/commodities.h"
+#include "engine/compiled_scenario.h"
 #include "engine/console.h"
 #include "engine/hud.h"
+#include "engine/manifest.h"
 #include "engine/navigation.h"
 #include "engine/scenario.h"
 #include "engine/scenario_lua.h"
+#include "engine/snapshot.h"
 #include "engine/starfield.h"
 #include "engine/technologies.h"
 #include "graphics/video.h"
@@ -33,10 +36,13 @@
 #include "ui/ui.h"
 #include "ui/widgets.h"
 #include "utilities/file.h"
+#include "utilities/loader.h"
+#include "utilities/resource.h"
 #include "utilities/log.h"
 #include "utilities/timer.h"
 #include "utilities/timer_lua.h"
 #include "utilities/lua.h"
+#include "utilities/profiler.h"
 
 // Distance from sector's center player should arrive at after jump completion
 #define JUMP_DISTANCE_FROM_CENTER 6.
@@ -51,6 +57,33 @@
 /**\class Scenario
  * \brief Handles main game loop. */
 
+// The scenario.xml keys that name each Component file, in the order that they are listed
+static const char *componentFiles[] = { "commodities", "engines", "weapons", "models", "outfits",
+                                        "technologies", "alliances", "sectors", "planets" };
+static const int numComponentFiles = sizeof(componentFiles) / sizeof(componentFiles[0]);
+
+/**\class ComponentsJob
+ * \brief Parses one Component file for the Loader. */
+class ComponentsJob : public LoadJob {
+	public:
+		ComponentsJob( Components *_components, const string& _filename, bool *_parsed )
+			:components(_components), filename(_filename), parsed(_parsed), success(false) {}
+
+		void Run( void ) {
+			success = components->Load( filename );
+		}
+
+		void Finish( void ) {
+			*parsed = success;
+		}
+
+	private:
+		Components *components;
+		string filename;
+		bool *parsed;
+		bool success;
+};
+
 /**\brief Loads an empty Scenario.
  */
 Scenario::Scenario( void ) {
@@ -82,6 +115,15 @@ Scenario::Scenario( void ) {
 	currentSector = NULL;
 
 	lastTrafficTime = 0;
+	lowFps = false;
+	lowFpsFrameCount = 0;
+
+	logicThread = NULL;
+	worldLock = NULL;
+	tickReady = NULL;
+	scheduledTicks = 0;
+	ticks = 0;
+	tickTime = 0;
 }
 
 bool Scenario::New( string newname ) {
@@ -131,21 +173,90 @@ bool Scenario::New( string newname ) {
 }
 
 /**\brief Loads the XML file.
+ * \details Every Resource that the Components refer to is loaded before
+ *          the Components themselves, so that they can be decoded in parallel.
+ *          With "options/memory/lazy-assets" on, the Components only refer to
+ *          their Resources, which are loaded by the Sectors that use them.
+ *          If the Scenario has been compiled since its XML last changed, the
+ *          Components are created from the compiled file instead.
  * \param filename Name of the file
+ * \param progress Called while the Resources load, from 0.0 to 1.0
  * \return true if success
+ * \sa CompiledScenario
  */
-bool Scenario::Load( string simName ) {
+bool Scenario::Load( string simName, void (*progress)( float fraction ) ) {
+	Manifest manifest;
+	CompiledScenario compiled;
+	int f;
+
 	folderpath = "data/scenario/" + simName + "/";
 
 	if( !Open( folderpath + string("scenario.xml") ) ) {
 		return false;
 	}
 
+	if( OPTION(bool, "options/scenario/compiled") && compiled.Open( folderpath, GetSources() ) ) {
+		if( !OPTION(bool, "options/memory/lazy-assets") ) {
+			compiled.AddResources( &manifest );
+			manifest.WarmUp( progress );
+		}
+
+		if( !compiled.Build( this ) ) {
+			return false;
+		}
+	} else {
+		// Files that can't be read are reported by ParseComponents
+		if( !OPTION(bool, "options/memory/lazy-assets") ) {
+			for( f = 0; f < numComponentFiles; f++ ) {
+				manifest.Read( folderpath + Get( componentFiles[f] ) );
+			}
+			manifest.WarmUp( progress );
+		}
+
+		if( !ParseComponents() ) {
+			return false;
+		}
+	}
+
 	loaded = ParseXML();
 
 	return loaded;
 }
 
+/**\brief Compiles a Scenario's XML into a binary file that loads faster.
+ * \details This is what `epiar --compile-scenario=<name>` runs.
+ * \return true if success
+ * \sa CompiledScenario
+ */
+bool Scenario::Compile( string simName ) {
+	folderpath = "data/scenario/" + simName + "/";
+
+	if( !Open( folderpath + string("scenario.xml") ) ) {
+		LogMsg(ERR, "Could not open the Scenario '%s'.", simName.c_str() );
+		return false;
+	}
+
+	if( !ParseComponents() ) {
+		return false;
+	}
+
+	return CompiledScenario::Compile( this, folderpath, GetSources() );
+}
+
+/**\brief The XML files that the Scenario is loaded from.
+ */
+vector<string> Scenario::GetSources( void ) {
+	vector<string> sources;
+	int f;
+
+	sources.push_back( folderpath + string("scenario.xml") );
+	for( f = 0; f < numComponentFiles; f++ ) {
+		sources.push_back( folderpath + Get( componentFiles[f] ) );
+	}
+
+	return sources;
+}
+
 /**\brief Pauses the scenario
  */
 void Scenario::pause() {
@@ -226,7 +337,7 @@ bool Scenario::Initialize() {
 		return false;
 	}
 
-	// Preload animation to prevent FPS drop on first ship explosion
+	// Start loading the explosion now so that it is ready for the first one
 	Ani::Get("data/animations/explosion1.ani");
 
 	// Randomize the Lua Seed
@@ -294,10 +405,126 @@ void Scenario::ResetSector( Sector *s ) {
 	// Reveal this sector on player's map, if needed
 	GetPlayer()->RevealSector(s);
 
+	PrefetchSector( s );
+
 	currentSector = s;
 }
 
+/**\brief Adds the Resources that an Outfit is shown with.
+ */
+static void AddResources( set<Resource*>& resources, Outfit *outfit ) {
+	if( outfit != NULL ) {
+		resources.insert( outfit->GetPicture() );
+	}
+}
+
+/**\brief Adds the Resources of a Model, including its Image in space.
+ */
+static void AddResources( set<Resource*>& resources, Model *model ) {
+	if( model != NULL ) {
+		resources.insert( model->GetPicture() );
+		resources.insert( model->GetImage() );
+	}
+}
+
+/**\brief Adds the Resources of an Engine, including its thrust Sound.
+ */
+static void AddResources( set<Resource*>& resources, Engine *engine ) {
+	if( engine != NULL ) {
+		resources.insert( engine->GetPicture() );
+		resources.insert( engine->GetSound() );
+	}
+}
+
+/**\brief Adds the Resources of a Weapon, including its projectile and Sound.
+ */
+static void AddResources( set<Resource*>& resources, Weapon *weapon ) {
+	if( weapon != NULL ) {
+		resources.insert( weapon->GetPicture() );
+		resources.insert( weapon->GetImage() );
+		resources.insert( weapon->GetSound() );
+	}
+}
+
+/**\brief Starts loading what a Sector shows, and keeps it while the player is there.
+ * \details The Components only load their Images and Sounds when they are
+ *          first used. Those of the Sector's planets, what the planets sell
+ *          and the Ships that are already there are loaded now instead, all
+ *          at once on the Loader's threads. They are Acquired so that
+ *          Resource::Trim leaves them alone, until the player leaves.
+ */
+void Scenario::PrefetchSector( Sector *s ) {
+	set<Resource*> resources;
+	set<Resource*>::iterator r;
+	list<string> planetList = s->GetPlanets();
+	list<string>::iterator p;
+	list<Model*> models;
+	list<Model*>::iterator m;
+	list<Engine*> engineList;
+	list<Engine*>::iterator e;
+	list<Weapon*> weaponList;
+	list<Weapon*>::iterator w;
+	list<Outfit*> outfitList;
+	list<Outfit*>::iterator o;
+	list<Sprite*> *ships;
+	list<Sprite*>::iterator i;
+	vector<Weapon*>::iterator sw;
+
+	for( p = planetList.begin(); p != planetList.end(); ++p ) {
+		Planet *planet = planets->GetPlanet( *p );
+		if( planet == NULL ) {
+			continue;
+		}
+
+		resources.insert( planet->GetImage() );
+		resources.insert( planet->GetSurfaceImage() );
+
+		models = planet->GetModels();
+		for( m = models.begin(); m != models.end(); ++m ) {
+			AddResources( resources, *m );
+		}
+		engineList = planet->GetEngines();
+		for( e = engineList.begin(); e != engineList.end(); ++e ) {
+			AddResources( resources, *e );
+		}
+		weaponList = planet->GetWeapons();
+		for( w = weaponList.begin(); w != weaponList.end(); ++w ) {
+			AddResources( resources, *w );
+		}
+		outfitList = planet->GetOutfits();
+		for( o = outfitList.begin(); o != outfitList.end(); ++o ) {
+			AddResources( resources, *o );
+		}
+	}
+
+	ships = sprites->GetSprites( DRAW_ORDER_SHIP | DRAW_ORDER_PLAYER );
+	for( i = ships->begin(); i != ships->end(); ++i ) {
+		Ship *ship = static_cast<Ship*>( *i );
+		AddResources( resources, ship->GetModel() );
+		AddResources( resources, ship->GetEngine() );
+		for( sw = ship->GetWeapons()->begin(); sw != ship->GetWeapons()->end(); ++sw ) {
+			AddResources( resources, *sw );
+		}
+	}
+	delete ships;
+
+	resources.erase( static_cast<Resource*>( NULL ) );
+
+	// Acquire the new Resources before the old ones are Released, as most are in both
+	for( r = resources.begin(); r != resources.end(); ++r ) {
+		(*r)->Acquire();
+		(*r)->Prefetch();
+	}
+	for( r = sectorResources.begin(); r != sectorResources.end(); ++r ) {
+		(*r)->Release();
+	}
+	sectorResources.swap( resources );
+
+	LogMsg(INFO, "Prefetching %d Resources for the '%s' sector.", (int)sectorResources.size(), s->GetName().c_str() );
+}
+
 Scenario::~Scenario() {
+	Profiler::Stop( luaState );
 	Lua::Close();
 	luaState = NULL;
 
@@ -328,6 +555,11 @@ Scenario::~Scenario() {
 
 	mapScale = -1.0f;
 	delete console; console = NULL;
+
+	for( set<Resource*>::iterator r = sectorResources.begin(); r != sectorResources.end(); ++r ) {
+		(*r)->Release();
+	}
+	sectorResources.clear();
 	currentSector = NULL;
 }
 
@@ -356,6 +588,15 @@ void SaveMapScale( void *scenarioInstance ) {
 }
 
 /**\brief Main game loop
+ * \details The logic runs at Timer::GetLogicFPS, which is lowered when the
+ *          logical frames get too expensive. After every logical frame the world
+ *          is copied into a Snapshot, and the screen is drawn from the
+ *          newest Snapshot, in between the last two logical frames.
+ *
+ *          When options/timing/logic-thread is set the logical frames run
+ *          on their own thread while the main thread draws. Input, the Hud,
+ *          the UI and the console still take the world lock when they are
+ *          used, since Lua can change them from either thread.
  */
 void Scenario::Run() {
 	int fpsCount = 0;          // for FPS calculations
@@ -385,18 +626,42 @@ void Scenario::Run() {
 
 	// Generate a starfield
 	Starfield starfield( 700 );
+	Uint32 starfieldTick = 0; // the logical frame that the stars have scrolled to
 
 	// Load sample game music
 	//if(bgmusic && OPTION(int, "options/sound/background")) {
 		//bgmusic->Play();
 	//}
 
+	Snapshot::Initialize();
+	scheduledTicks = 0;
+	ticks = 0;
+	tickTime = 0;
+	pendingEvents.clear();
+	heldEvents.clear();
+
+	if( OPTION(int, "options/timing/logic-thread") ) {
+		worldLock = SDL_CreateMutex();
+		tickReady = SDL_CreateCond();
+		logicThread = SDL_CreateThread( Scenario::LogicThread, "Logic", this );
+
+		if( logicThread == NULL ) {
+			LogMsg(WARN, "Could not start the logic thread, running the logic between frames: %s", SDL_GetError() );
+			SDL_DestroyCond( tickReady );
+			SDL_DestroyMutex( worldLock );
+			tickReady = NULL;
+			worldLock = NULL;
+		}
+	}
+
 	// main game loop
-	bool lowFps = false;
 	bool firstLoop = true;
-	int lowFpsFrameCount = 0;
+	lowFps = false;
+	lowFpsFrameCount = 0;
 
 	while( !quit ) {
+		LockWorld();
+
 		int logicLoops = Timer::Update();
 
 		if(firstLoop) {
@@ -407,57 +672,22 @@ void Scenario::Run() {
 		}
 
 		if( !paused ) {
-			// Logical update cycle
-			while(logicLoops--) {
-				HandleInput();
-
-				if(lowFps) { lowFpsFrameCount--; }
-
-				if(player->DidJump()) {
-					player->ResetJump();
-
-					string sectorName = Navigation::GetNextSector();
-					Sector* newSector = sectors->GetSector(sectorName);
-					assert( newSector != NULL );
+			scheduledTicks += logicLoops;
 
-					// Switch out ships, planets, etc. to new sector
-					ResetSector( newSector );
-
-					// Reset player's coordinates
-					Coordinate newCoordinate = Coordinate(JUMP_DISTANCE_FROM_CENTER, JUMP_DISTANCE_FROM_CENTER);
-					player->SetWorldPosition( newCoordinate * -1 * player->GetJumpAngle() );
-
-					Navigation::RemoveNextSector();
-
-					Hud::Alert(true, "Entering %s sector", newSector->GetName().c_str());
+			if( logicThread != NULL ) {
+				HandleInput();
 
-					// If sector has no planetary objects, alert the player
-					list<string> nearbyPlanets = newSector->GetPlanets();
-					if(nearbyPlanets.size() == 0) {
-						Hud::Alert(false, "No planetary objects detected");
-					}
+				if( logicLoops > 0 ) {
+					SDL_CondSignal( tickReady );
 				}
-
-				// Generate new sector traffic if needed
-				if( lastTrafficTime + TRAFFIC_GENERATION_FREQUENCY < Timer::GetTicks() ) {
-					if( currentSector->GetTraffic() > sprites->GetAIShipCount() ) {
-						if((rand() % 100) > TRAFFIC_GENERATION_CHANCE) {
-							cout << "generating traffic" << endl;
-							currentSector->GenerateTraffic(1);
-						} else {
-							cout << "do not generate traffic, unlucky roll" << endl;
-						}
-					} else {
-						cout << "no traffic: too much (sector ask: " << currentSector->GetTraffic() << "), current count: " << sprites->GetAIShipCount() << endl;
-					}
-					lastTrafficTime = Timer::GetTicks();
+			} else if( logicLoops > 0 ) {
+				// Logical update cycle
+				while( ticks != scheduledTicks ) {
+					HandleInput();
+					Tick();
 				}
 
-				sprites->Update( luaState, lowFps );
-				camera->Update( sprites );
-				sprites->UpdateScreenCoordinates();
-				calendar->Update();
-				starfield.Update( camera );
+				Capture();
 			}
 		} else {
 			// We prefer input to be inside the logic loop (for the Hz) but
@@ -467,18 +697,60 @@ void Scenario::Run() {
 
 		Hud::Update( luaState );
 
+		// Textures for the Resources that the Loader has decoded
+		Loader::Update();
+
+		// Stay within the memory budget, while the logic thread can't play any Sounds
+		Resource::Trim();
+
+		if( logicThread != NULL && ( paused || ticks == scheduledTicks ) ) {
+			// The logic thread is waiting for a tick, so it isn't collecting
+			// the garbage that the menus and key bindings leave behind.
+			Lua::StepGC();
+		}
+
+		// The logic thread may touch the Images once the world is unlocked
+		Snapshot *snapshot = Snapshot::GetLatest();
+		snapshot->Prepare();
+
+		UnlockWorld();
+
 		// Erase cycle
 		Video::Erase();
 
 		// Draw cycle
-		starfield.Draw();
-		sprites->Draw( camera->GetFocusCoordinate() );
-		Hud::Draw( HUD_ALL, currentFPS, camera, sprites );
+
+		// Only the newest logical frame has a partial frame after it. If the
+		// logic thread is behind, show the last finished frame as it is.
+		// After a jump the previous frame would smear across the screen.
+		if( interpolateOn && !snapshot->cut && snapshot->tick == scheduledTicks ) {
+			snapshot->fframe = static_cast<float>( Timer::GetFFrame() );
+		} else {
+			snapshot->fframe = 1.f;
+		}
+
+		if( snapshot->tick != starfieldTick ) {
+			starfield.Update( snapshot->focus );
+			starfieldTick = snapshot->tick;
+		}
+
+		starfield.Draw( snapshot->fframe );
+		snapshot->Draw();
+
+		LockWorld();
+		Hud::Draw( HUD_ALL, currentFPS, snapshot );
 		UI::Draw();
 		console->Draw();
 		camera->Draw();
+		UnlockWorld();
+
 		Video::Update();
 
+		if( logicThread == NULL ) {
+			// Collect Lua garbage between frames rather than during AI decisions
+			Lua::StepGC();
+		}
+
 		Timer::Delay();
 
 		// Counting Frames
@@ -487,8 +759,11 @@ void Scenario::Run() {
 
 		// Update the fps once per second
 		if( (Timer::GetTicks() - fpsTS) > 1000 ) {
+			LockWorld();
+
 			currentFPS = static_cast<float>(1000.0 *
 					((float)fpsCount / (Timer::GetTicks() - fpsTS)));
+			AdjustLogicRate( (Timer::GetTicks() - fpsTS) / 1000.0 );
 			fpsTS = Timer::GetTicks();
 			fpsCount = 0;
 			if( currentFPS < -0.1f ) {
@@ -546,14 +821,189 @@ void Scenario::Run() {
 					UI::RegisterKeyboardFocus( win );
 				}
 			}
+
+			UnlockWorld();
 		}
 	}
 
+	if( logicThread != NULL ) {
+		// Wake the logic thread up so that it sees that we are quitting
+		LockWorld();
+		SDL_CondSignal( tickReady );
+		UnlockWorld();
+
+		SDL_WaitThread( logicThread, NULL );
+		SDL_DestroyCond( tickReady );
+		SDL_DestroyMutex( worldLock );
+		logicThread = NULL;
+		tickReady = NULL;
+		worldLock = NULL;
+	}
+
+	Snapshot::Shutdown();
+
 	Hud::Close();
 
 	LogMsg(INFO,"Scenario stopped. Average framerate: %f frames / second", 1000.0 *((float)fpsTotal / Timer::GetTicks() ) );
 }
 
+/**\brief Runs one logical frame.
+ */
+void Scenario::Tick( void ) {
+	Uint64 started = SDL_GetPerformanceCounter();
+
+	if( logicThread != NULL ) {
+		// HandleInput saved the Lua key bindings for the logic thread
+		list<InputEvent> events = pendingEvents;
+		events.insert( events.end(), heldEvents.begin(), heldEvents.end() );
+		pendingEvents.clear();
+
+		Input::HandleLuaCallBacks( events );
+	}
+
+	if(lowFps) { lowFpsFrameCount--; }
+
+	if(player->DidJump()) {
+		player->ResetJump();
+
+		string sectorName = Navigation::GetNextSector();
+		Sector* newSector = sectors->GetSector(sectorName);
+		assert( newSector != NULL );
+
+		// Switch out ships, planets, etc. to new sector
+		ResetSector( newSector );
+
+		// Reset player's coordinates
+		Coordinate newCoordinate = Coordinate(JUMP_DISTANCE_FROM_CENTER, JUMP_DISTANCE_FROM_CENTER);
+		player->SetWorldPosition( newCoordinate * -1 * player->GetJumpAngle() );
+
+		Navigation::RemoveNextSector();
+
+		player->ArrivedInSector( newSector->GetName() );
+
+		Hud::Alert(true, "Entering %s sector", newSector->GetName().c_str());
+
+		// If sector has no planetary objects, alert the player
+		list<string> nearbyPlanets = newSector->GetPlanets();
+		if(nearbyPlanets.size() == 0) {
+			Hud::Alert(false, "No planetary objects detected");
+		}
+	}
+
+	// Generate new sector traffic if needed
+	if( lastTrafficTime + TRAFFIC_GENERATION_FREQUENCY < Timer::GetTicks() ) {
+		if( currentSector->GetTraffic() > sprites->GetAIShipCount() ) {
+			if((rand() % 100) > TRAFFIC_GENERATION_CHANCE) {
+				cout << "generating traffic" << endl;
+				currentSector->GenerateTraffic(1);
+			} else {
+				cout << "do not generate traffic, unlucky roll" << endl;
+			}
+		} else {
+			cout << "no traffic: too much (sector ask: " << currentSector->GetTraffic() << "), current count: " << sprites->GetAIShipCount() << endl;
+		}
+		lastTrafficTime = Timer::GetTicks();
+	}
+
+	sprites->Update( luaState, lowFps );
+	camera->Update( sprites );
+	sprites->UpdateScreenCoordinates();
+	calendar->Update();
+
+	ticks++;
+	tickTime += SDL_GetPerformanceCounter() - started;
+}
+
+/**\brief Runs fewer logical frames when they take up too much time.
+ * \details Since the screen is drawn in between logical frames, movement
+ *          still looks smooth at a lower logic rate. The rate goes back up,
+ *          to at most options/timing/logic-fps, once the load drops.
+ * \param seconds How long it has been since the last adjustment
+ */
+void Scenario::AdjustLogicRate( double seconds ) {
+	double load, rate, fastest, slowest;
+
+	if( seconds <= 0. ) {
+		return;
+	}
+
+	load = ( tickTime / static_cast<double>( SDL_GetPerformanceFrequency() ) ) / seconds;
+	rate = Timer::GetLogicFPS();
+	fastest = OPTION( double, "options/timing/logic-fps" );
+	slowest = OPTION( double, "options/timing/logic-fps-min" );
+
+	tickTime = 0;
+
+	if( load > 0.8 && rate > slowest ) {
+		Timer::SetLogicFPS( max( slowest, rate * 0.75 ) );
+		LogMsg(DEBUG, "Logical frames are taking %.0f%% of the time, slowing the logic to %.1f frames / second.", load * 100., Timer::GetLogicFPS() );
+	} else if( load < 0.4 && rate < fastest ) {
+		Timer::SetLogicFPS( min( fastest, rate * 1.25 ) );
+		LogMsg(DEBUG, "Logical frames are taking %.0f%% of the time, speeding the logic up to %.1f frames / second.", load * 100., Timer::GetLogicFPS() );
+	}
+}
+
+/**\brief Publishes a Snapshot of the world after the last logical frame.
+ */
+void Scenario::Capture( void ) {
+	Snapshot *snapshot = Snapshot::Begin();
+
+	snapshot->tick = ticks;
+	snapshot->focus = camera->GetFocusCoordinate();
+	snapshot->cut = camera->WasCut();
+	sprites->Capture( snapshot, snapshot->focus );
+	Hud::Capture( snapshot, camera, sprites );
+
+	Snapshot::Publish();
+}
+
+/**\brief Runs the logical frames that the main loop schedules.
+ */
+int Scenario::LogicThread( void *data ) {
+	Scenario *scenario = static_cast<Scenario*>( data );
+
+	scenario->LockWorld();
+
+	while( !scenario->quit ) {
+		if( scenario->ticks == scenario->scheduledTicks ) {
+			SDL_CondWait( scenario->tickReady, scenario->worldLock );
+			continue;
+		}
+
+		scenario->Tick();
+		scenario->Capture();
+
+		if( scenario->ticks == scenario->scheduledTicks ) {
+			// Collect Lua garbage once the logic has caught up
+			Lua::StepGC();
+		}
+
+		// Give the main thread a chance between logical frames
+		scenario->UnlockWorld();
+		scenario->LockWorld();
+	}
+
+	scenario->UnlockWorld();
+
+	return 0;
+}
+
+/**\brief Takes the world lock, if the logic has its own thread.
+ */
+void Scenario::LockWorld( void ) {
+	if( worldLock != NULL ) {
+		SDL_LockMutex( worldLock );
+	}
+}
+
+/**\brief Releases the world lock.
+ */
+void Scenario::UnlockWorld( void ) {
+	if( worldLock != NULL ) {
+		SDL_UnlockMutex( worldLock );
+	}
+}
+
 /**\brief Subroutine. Calls various Lua register functions needed by both Run and Edit
  * \return true if successful
  */
@@ -566,52 +1016,61 @@ void Scenario::LuaRegisters(lua_State *L) {
 	Video::RegisterVideo(L);
 	Calendar_Lua::RegisterCalendar(L);
 	Timer_Lua::RegisterTimer(L);
+	Profiler::RegisterProfiler(L);
 }
 
-/**\brief Parses the scenario XML file
+/**\brief Parses the Component files
+ * \details The Component files are parsed on the Loader's threads, and then
+ *          linked to each other once all of them have been parsed.
  * \return true if successful
  */
-bool Scenario::ParseXML( void ) {
-	LogMsg(INFO, "Scenario version %s.%s.%s.", Get("version-major").c_str(), Get("version-minor").c_str(),  Get("version-macro").c_str());
-
-	// Now load the various subsystems
-	if( commodities->Load( (folderpath + Get("commodities")) ) != true ) {
-		LogMsg(ERR, "There was an error loading the commodities from '%s'.", (folderpath + Get("commodities")).c_str() );
-		return false;
+bool Scenario::ParseComponents( void ) {
+	Components *components[] = { commodities, engines, weapons, models, outfits,
+	                             technologies, alliances, sectors, planets };
+	LoadJob *jobs[numComponentFiles];
+	bool parsed[numComponentFiles];
+	bool success = true;
+	int f;
+
+	// Each file only names the Components in other files, so they can all be parsed at once
+	xmlInitParser();
+	for( f = 0; f < numComponentFiles; f++ ) {
+		parsed[f] = false;
+		jobs[f] = new ComponentsJob( components[f], folderpath + Get( componentFiles[f] ), &parsed[f] );
+		Loader::Queue( jobs[f] );
 	}
-	if( engines->Load( (folderpath + Get("engines")) ) != true ) {
-		LogMsg(ERR, "There was an error loading the engines from '%s'.", (folderpath + Get("engines")).c_str() );
-		return false;
+	for( f = 0; f < numComponentFiles; f++ ) {
+		Loader::Wait( jobs[f] );
 	}
-	if( weapons->Load( (folderpath + Get("weapons")) ) != true ) {
-		LogMsg(ERR, "There was an error loading the weapons from '%s'.", (folderpath + Get("weapons")).c_str() );
-		return false;
-	}
-	if( models->Load( (folderpath + Get("models")) ) != true ) {
-		LogMsg(ERR, "There was an error loading the models from '%s'.", (folderpath + Get("models")).c_str() );
-		return false;
-	}
-	if( outfits->Load( (folderpath + Get("outfits")) ) != true ) {
-		LogMsg(ERR, "There was an error loading the outfits from '%s'.", (folderpath + Get("outfits")).c_str() );
-		return false;
-	}
-	if( technologies->Load( (folderpath + Get("technologies")) ) != true ) {
-		LogMsg(ERR, "There was an error loading the technologies from '%s'.", (folderpath + Get("technologies")).c_str() );
-		return false;
+
+	for( f = 0; f < numComponentFiles; f++ ) {
+		if( !parsed[f] ) {
+			LogMsg(ERR, "There was an error loading the %s from '%s'.", componentFiles[f], (folderpath + Get( componentFiles[f] )).c_str() );
+			success = false;
+		}
 	}
-	if( alliances->Load( (folderpath + Get("alliances")) ) != true ) {
-		LogMsg(ERR, "There was an error loading the alliances from '%s'.", (folderpath + Get("alliances")).c_str() );
+	if( !success ) {
 		return false;
 	}
-	if( sectors->Load( (folderpath + Get("sectors")) ) != true ) {
-	    LogMsg(WARN, "There was an error loading the sectors from '%s'.", (folderpath + Get("sectors")).c_str() );
-	    return false;
-	}
-	if( planets->Load( (folderpath + Get("planets")) ) != true ) {
-	    LogMsg(WARN, "There was an error loading the planets from '%s'.", (folderpath + Get("planets")).c_str() );
-	    return false;
+
+	// Now that every Component exists, they can find each other
+	for( f = 0; f < numComponentFiles; f++ ) {
+		if( !components[f]->Link() ) {
+			LogMsg(ERR, "There was an error linking the %s from '%s'.", componentFiles[f], (folderpath + Get( componentFiles[f] )).c_str() );
+			return false;
+		}
 	}
 
+	return true;
+}
+
+/**\brief Parses the scenario XML file
+ * \details The Components must already have been loaded.
+ * \return true if successful
+ */
+bool Scenario::ParseXML( void ) {
+	LogMsg(INFO, "Scenario version %s.%s.%s.", Get("version-major").c_str(), Get("version-minor").c_str(),  Get("version-macro").c_str());
+
 	// Check the Music
 	if( Get("music").length() > 0 ) {
 		bgmusic = Song::Get( Get("music") );
@@ -655,7 +1114,21 @@ void Scenario::HandleInput() {
 	Hud::HandleInput( events, camera, sprites );
 
 	if( !paused ) {
-		Input::HandleLuaCallBacks( events );
+		if( logicThread != NULL ) {
+			// The logic thread runs the key bindings, once per logical frame
+			list<InputEvent> bound = Input::TakeLuaCallBacks( events );
+
+			heldEvents.clear();
+			for( list<InputEvent>::iterator i = bound.begin(); i != bound.end(); ++i ) {
+				if( i->type == KEY && i->kstate == KEYPRESSED ) {
+					heldEvents.push_back( *i );
+				} else {
+					pendingEvents.push_back( *i );
+				}
+			}
+		} else {
+			Input::HandleLuaCallBacks( events );
+		}
 	}
 
 	//if( Input::HandleSpecificEvent( events, InputEvent( KEY, KEYTYPED, SDLK_PERIOD ) ) )
@@ -1,7 +1,7 @@
 /**\filename			scenario.h
  * \author			Christopher Thielen (chris@epiar.net)
  * \date			Created: July 2006
- * \date			Modified: Wednesday, August 10, 2016
+ * \date			Modified: Monday, October 19, 2026
  * \brief			Contains the main game loop
  * \details
  */
@@ -30,7 +30,8 @@ class Scenario : public XMLFile {
 		~Scenario();
 
 		bool New( string _folderpath );
-		bool Load( string _folderpath );
+		bool Load( string _folderpath, void (*progress)( float fraction ) = NULL );
+		bool Compile( string _folderpath );
 
 		bool Initialize();
 		bool Setup();
@@ -82,8 +83,18 @@ class Scenario : public XMLFile {
 		void SetQuit( bool val ) { quit = val; }
 
 	private:
+		bool ParseComponents( void );
 		bool ParseXML( void );
+		vector<string> GetSources( void );
 		void CreateNavMap( void );
+		void PrefetchSector( Sector *s );
+
+		void Tick( void );
+		void AdjustLogicRate( double seconds );
+		void Capture( void );
+		void LockWorld( void );
+		void UnlockWorld( void );
+		static int LogicThread( void *data );
 
 		// Pointers to Singletons
 		lua_State *luaState;
@@ -107,6 +118,7 @@ class Scenario : public XMLFile {
 		Song* bgmusic;
 		Console *console;
 		Sector* currentSector;
+		set<Resource*> sectorResources; ///< Acquired while the player is in currentSector
 
 		// Description of this scenario
 		string folderpath;
@@ -118,6 +130,18 @@ class Scenario : public XMLFile {
 		bool quit;
 		float mapScale;
 		Uint32 lastTrafficTime;
+		bool lowFps;
+		int lowFpsFrameCount;
+
+		// Logic thread
+		SDL_Thread *logicThread; ///< NULL when the logic runs on the main thread
+		SDL_mutex *worldLock; ///< Held while the world is changed, or read outside of a Snapshot
+		SDL_cond *tickReady; ///< Signalled when logical frames are scheduled
+		Uint32 scheduledTicks; ///< Logical frames that the Timer has asked for
+		Uint32 ticks; ///< Logical frames that have run
+		list<InputEvent> pendingEvents; ///< Lua key bindings waiting for the next logical frame
+		list<InputEvent> heldEvents; ///< Lua key bindings for held keys, run every logical frame
+		Uint64 tickTime; ///< Performance counter ticks spent in logical frames since the logic rate was last adjusted
 };
 
 #endif // __H_SCENARIO__
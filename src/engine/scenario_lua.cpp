@@ -11,6 +11,7 @@
 
 #include "audio/audio.h"
 #include "audio/audio_lua.h"
+#include "audio/soundbank.h"
 #include "engine/console.h"
 #include "engine/scenario.h"
 #include "engine/scenario_lua.h"
@@ -18,6 +19,7 @@
 #include "engine/alliances.h"
 #include "utilities/log.h"
 #include "utilities/lua.h"
+#include "utilities/resource.h"
 #include "ui/ui_lua.h"
 #include "ui/ui.h"
 #include "ui/ui_window.h"
@@ -116,6 +118,9 @@ void Scenario_Lua::RegisterScenario(lua_State *L) {
 		{"listImages", &Scenario_Lua::ListImages},
 		{"listAnimations", &Scenario_Lua::ListAnimations},
 		{"listSounds", &Scenario_Lua::ListSounds},
+
+		// Memory Functions
+		{"resourceStats", &Scenario_Lua::GetResourceStats},
 		{NULL, NULL}
 	};
 
@@ -1427,6 +1432,28 @@ int Scenario_Lua::ListSounds(lua_State *L) {
 	return 1;
 }
 
+/** \brief Describe how the Resources use memory
+ *  \returns One line for the console
+ *  \sa Resource::GetStats
+ */
+int Scenario_Lua::GetResourceStats(lua_State *L) {
+	ResourceStats stats = Resource::GetStats();
+	SoundBankStats bank = SoundBank::GetStats();
+	char line[512];
+
+	snprintf( line, sizeof(line), "%d resources, %u hits, %u misses, %u evictions, %u reloads. "
+	          "Textures %.1f MB, sounds %.1f MB, budget %.0f MB (sounds %.0f MB). "
+	          "Sound bank: %d buffers, %u decoded, %u shared, %.1f MB short, %.1f MB long, peak %.1f MB.",
+	          stats.count, stats.hits, stats.misses, stats.evictions, stats.reloads,
+	          stats.bytes[RESOURCE_TEXTURE] / 1048576., stats.bytes[RESOURCE_PCM] / 1048576.,
+	          stats.budget / 1048576., stats.soundBudget / 1048576.,
+	          bank.buffers, bank.decodes, bank.shared,
+	          bank.bytes / 1048576., bank.streamedBytes / 1048576., bank.peak / 1048576. );
+
+	lua_pushstring(L, line);
+	return 1;
+}
+
 int Scenario_Lua::SetDescription(lua_State *L) {
 	string description= (string)lua_tostring(L, 1);
 	Scenario* sim = GetScenario(L);
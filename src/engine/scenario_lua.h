@@ -86,6 +86,7 @@ class Scenario_Lua {
 		static int ListImages(lua_State *L);
 		static int ListAnimations(lua_State *L);
 		static int ListSounds(lua_State *L);
+		static int GetResourceStats(lua_State *L);
 		static int SetDescription(lua_State *L);
 
 		static void PushSprite(lua_State *L,Sprite* sprite);
@@ -63,15 +63,13 @@ Sector::Sector( string _name,
 	alliance(_alliance),
 	planets(_planets),
 	neighbors(_neighbors),
-	traffic(_traffic)
+	traffic(_traffic),
+	x(_x),
+	y(_y)
 {
 	// Check the inputs
 	assert(_alliance);
 
-	Coordinate pos;
-	pos.SetX(_x);
-	pos.SetY(_y);
-
 	SetName(_name);
 }
 
@@ -88,12 +86,7 @@ bool Sector::FromXMLNode( xmlDocPtr doc, xmlNodePtr node ) {
 	Coordinate pos;
 
 	if( (attr = FirstChildNamed(node, "alliance")) ){
-		value = NodeToString(doc,attr);
-		alliance = Menu::GetCurrentScenario()->GetAlliances()->GetAlliance(value);
-		if(alliance == NULL) {
-			LogMsg(ERR, "Could not create Sector '%s'. Unknown Alliance '%s'.", this->GetName().c_str(), value.c_str());
-			return false;
-		}
+		allianceName = NodeToString(doc,attr);
 	} else return false;
 
 	if( (attr = FirstChildNamed(node, "x")) ){
@@ -126,6 +119,30 @@ bool Sector::FromXMLNode( xmlDocPtr doc, xmlNodePtr node ) {
 	return true;
 }
 
+/**\brief Finds the Alliance that FromXMLNode named, and checks the Planets.
+ */
+bool Sector::Link( void ) {
+	Scenario *scenario = Menu::GetCurrentScenario();
+	list<string>::iterator i;
+
+	if( !allianceName.empty() ) {
+		alliance = scenario->GetAlliances()->GetAlliance( allianceName );
+		if(alliance == NULL) {
+			LogMsg(ERR, "Could not create Sector '%s'. Unknown Alliance '%s'.", this->GetName().c_str(), allianceName.c_str());
+			return false;
+		}
+		allianceName = "";
+	}
+
+	for( i = planets.begin(); i != planets.end(); ++i ) {
+		if( scenario->GetPlanets()->GetPlanet( *i ) == NULL ) {
+			LogMsg(WARN, "Sector '%s' has an unknown Planet '%s'.", this->GetName().c_str(), i->c_str());
+		}
+	}
+
+	return true;
+}
+
 /**\brief List of the Planets in this Sector
  */
 list<string> Sector::GetPlanets() {
@@ -31,6 +31,7 @@ class Sector : public Component {
 		void Update( lua_State *L );
 
 		bool FromXMLNode( xmlDocPtr doc, xmlNodePtr node );
+		bool Link( void );
 		xmlNodePtr ToXMLNode(string componentName);
 		
 		~Sector();
@@ -59,6 +60,7 @@ class Sector : public Component {
 		list<string> neighbors;
 		int traffic;
 		float x, y; // nav map coords, not sprite/world/screen coords
+		string allianceName; ///< Until Link finds the Alliance
 };
 
 // Class that holds list of all sectors; manages them
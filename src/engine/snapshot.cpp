@@ -0,0 +1,231 @@
+/**\file			snapshot.cpp
+ * \author			Christopher Thielen (chris@epiar.net)
+ * \date			Created: Sunday, October 18, 2026
+ * \date			Modified: Monday, October 19, 2026
+ * \brief			What the world looked like after a logical frame
+ * \details
+ */
+
+#include "includes.h"
+#include "engine/snapshot.h"
+#include "graphics/spritebatch.h"
+#include "utilities/log.h"
+
+/**\class Snapshot
+ * \brief Everything the renderer needs to draw the world.
+ * \details After every logical frame the Sprites, the Camera and the Hud
+ *          copy what they look like into a Snapshot, which is then
+ *          published. The renderer draws the newest published Snapshot
+ *          without touching the Sprites, so the logic can run on another
+ *          thread while the screen is being drawn.
+ *
+ *          Every position is kept for the last two logical frames so that
+ *          the renderer can draw the world in between them.
+ * \sa Scenario::Run
+ */
+
+/**\class SnapshotItem
+ * \brief An Image or a line of text drawn in the world. */
+
+/**\class SnapshotBlip
+ * \brief A Sprite on the Radar. */
+
+/**\class SnapshotTarget
+ * \brief The targeted Sprite. */
+
+Snapshot Snapshot::buffers[3];
+Snapshot *Snapshot::writing = &Snapshot::buffers[0];
+Snapshot *Snapshot::ready = &Snapshot::buffers[1];
+Snapshot *Snapshot::reading = &Snapshot::buffers[2];
+bool Snapshot::fresh = false;
+SDL_mutex *Snapshot::lock = NULL;
+
+/**\brief Creates an empty Snapshot.
+ */
+Snapshot::Snapshot() {
+	Clear();
+	fframe = 1.f;
+}
+
+/**\brief Forgets everything, keeping the memory for the next frame.
+ */
+void Snapshot::Clear( void ) {
+	tick = 0;
+	focus = Coordinate( 0, 0 );
+	numSprites = 0;
+	items.clear();
+	blips.clear();
+	hasTarget = false;
+	cut = false;
+}
+
+/**\brief Adds an Image, centered on the position.
+ * \details Animations that are still loading have no Image yet.
+ */
+void Snapshot::AddImage( Image *image, Coordinate position, Coordinate oldPosition, float angle, float alpha ) {
+	SnapshotItem item;
+
+	if( image == NULL ) {
+		return;
+	}
+
+	item.type = SNAPSHOT_IMAGE;
+	item.x = static_cast<float>( position.GetX() );
+	item.y = static_cast<float>( position.GetY() );
+	item.ox = static_cast<float>( oldPosition.GetX() );
+	item.oy = static_cast<float>( oldPosition.GetY() );
+	item.angle = angle;
+	item.alpha = alpha;
+	item.image = image;
+	item.texture = NULL;
+	item.font = NULL;
+
+	items.push_back( item );
+}
+
+/**\brief Adds a line of text.
+ */
+void Snapshot::AddText( Font *font, Color color, const string& text, Coordinate position, Coordinate oldPosition ) {
+	SnapshotItem item;
+
+	item.type = SNAPSHOT_TEXT;
+	item.x = static_cast<float>( position.GetX() );
+	item.y = static_cast<float>( position.GetY() );
+	item.ox = static_cast<float>( oldPosition.GetX() );
+	item.oy = static_cast<float>( oldPosition.GetY() );
+	item.angle = 0.f;
+	item.alpha = 1.f;
+	item.image = NULL;
+	item.texture = NULL;
+	item.font = font;
+	item.color = color;
+	item.text = text;
+
+	items.push_back( item );
+}
+
+/**\brief Adds a Sprite to the Radar.
+ */
+void Snapshot::AddBlip( int id, Coordinate position, int radarSize, Color color ) {
+	SnapshotBlip blip;
+
+	blip.id = id;
+	blip.position = position;
+	blip.radarSize = radarSize;
+	blip.color = color;
+
+	blips.push_back( blip );
+}
+
+/**\brief Sets the targeted Sprite.
+ */
+void Snapshot::SetTarget( Coordinate position, Coordinate oldPosition, int radarSize, int edge, Color color ) {
+	hasTarget = true;
+	target.x = static_cast<float>( position.GetX() );
+	target.y = static_cast<float>( position.GetY() );
+	target.ox = static_cast<float>( oldPosition.GetX() );
+	target.oy = static_cast<float>( oldPosition.GetY() );
+	target.radarSize = radarSize;
+	target.edge = edge;
+	target.color = color;
+}
+
+/**\brief Copies what drawing the Images needs out of them.
+ * \details The logic thread may bind or reload an Image while the world is
+ *          drawn, so call this with the world locked, after Resource::Trim.
+ */
+void Snapshot::Prepare( void ) {
+	vector<SnapshotItem>::iterator i;
+
+	for( i = items.begin(); i != items.end(); ++i ) {
+		if( i->type != SNAPSHOT_IMAGE ) {
+			continue;
+		}
+
+		if( !i->image->GetQuad( &i->texture, &i->u0, &i->v0, &i->u1, &i->v1 ) ) {
+			i->texture = NULL;
+			continue;
+		}
+		i->w = i->image->GetWidth();
+		i->h = i->image->GetHeight();
+	}
+}
+
+/**\brief Draws the world, fframe of the way from the previous frame to this one.
+ * \details Neither the Images nor the Fonts are changed, so this can run
+ *          while the logic thread does.
+ * \sa Prepare
+ */
+void Snapshot::Draw( void ) {
+	vector<SnapshotItem>::iterator i;
+
+	for( i = items.begin(); i != items.end(); ++i ) {
+		int x = TO_INT( Interpolate( i->ox, i->x ) );
+		int y = TO_INT( Interpolate( i->oy, i->y ) );
+
+		if( i->type == SNAPSHOT_IMAGE ) {
+			if( i->texture != NULL ) {
+				SpriteBatch::Draw( i->texture, i->u0, i->v0, i->u1, i->v1,
+				                   static_cast<float>( x - i->w / 2 ), static_cast<float>( y - i->h / 2 ),
+				                   static_cast<float>( i->w ), static_cast<float>( i->h ), i->angle, i->alpha );
+			}
+		} else {
+			i->font->Render( x, y, i->text, i->color );
+		}
+	}
+}
+
+/**\brief Sets up the buffers.
+ */
+void Snapshot::Initialize( void ) {
+	int i;
+
+	if( lock == NULL ) {
+		lock = SDL_CreateMutex();
+	}
+
+	for( i = 0; i < 3; i++ ) {
+		buffers[i].Clear();
+	}
+	fresh = false;
+}
+
+/**\brief Releases the buffers.
+ */
+void Snapshot::Shutdown( void ) {
+	if( lock != NULL ) {
+		SDL_DestroyMutex( lock );
+		lock = NULL;
+	}
+}
+
+/**\brief Returns an empty Snapshot for the logic to fill in.
+ */
+Snapshot* Snapshot::Begin( void ) {
+	writing->Clear();
+	return writing;
+}
+
+/**\brief Makes the Snapshot from Begin the newest one.
+ */
+void Snapshot::Publish( void ) {
+	SDL_LockMutex( lock );
+	swap( writing, ready );
+	fresh = true;
+	SDL_UnlockMutex( lock );
+}
+
+/**\brief Returns the newest published Snapshot.
+ * \details It stays valid until the next call, and may be the same one
+ *          as last time if the logic hasn't published since.
+ */
+Snapshot* Snapshot::GetLatest( void ) {
+	SDL_LockMutex( lock );
+	if( fresh ) {
+		swap( reading, ready );
+		fresh = false;
+	}
+	SDL_UnlockMutex( lock );
+
+	return reading;
+}
@@ -0,0 +1,102 @@
+/**\file			snapshot.h
+ * \author			Christopher Thielen (chris@epiar.net)
+ * \date			Created: Sunday, October 18, 2026
+ * \date			Modified: Monday, October 19, 2026
+ * \brief			What the world looked like after a logical frame
+ * \details
+ */
+
+#ifndef __h_snapshot__
+#define __h_snapshot__
+
+#include "includes.h"
+#include "graphics/color.h"
+#include "graphics/font.h"
+#include "graphics/image.h"
+#include "utilities/coordinate.h"
+
+typedef enum {
+	SNAPSHOT_IMAGE, ///< An Image centered on the position
+	SNAPSHOT_TEXT   ///< A line of text starting at the position
+} SnapshotType;
+
+// Something drawn in the world, in screen coordinates
+class SnapshotItem {
+	public:
+		SnapshotType type;
+		float x, y; ///< Position after the latest logical frame
+		float ox, oy; ///< Position after the logical frame before that
+		float angle;
+		float alpha;
+		Image *image;
+		SDL_Texture *texture; ///< The part of it to draw, copied out of image by Prepare
+		float u0, v0, u1, v1;
+		int w, h;
+		Font *font;
+		Color color;
+		string text;
+};
+
+// A Sprite as seen by the Radar
+class SnapshotBlip {
+	public:
+		int id;
+		Coordinate position; ///< World position
+		int radarSize;
+		Color color;
+};
+
+// The Sprite that the player is targeting
+class SnapshotTarget {
+	public:
+		float x, y; ///< Screen position after the latest logical frame
+		float ox, oy; ///< Screen position after the logical frame before that
+		int radarSize;
+		int edge;
+		Color color;
+};
+
+class Snapshot {
+	public:
+		Snapshot();
+
+		void Clear( void );
+
+		void AddImage( Image *image, Coordinate position, Coordinate oldPosition, float angle, float alpha = 1.f );
+		void AddText( Font *font, Color color, const string& text, Coordinate position, Coordinate oldPosition );
+		void AddBlip( int id, Coordinate position, int radarSize, Color color );
+		void SetTarget( Coordinate position, Coordinate oldPosition, int radarSize, int edge, Color color );
+
+		float Interpolate( float old, float now ) { return old + (now - old) * fframe; }
+
+		void Prepare( void );
+		void Draw( void );
+
+		Uint32 tick; ///< The logical frame that this shows, 0 if none has run yet
+		Coordinate focus; ///< Where the Camera was looking
+		int numSprites;
+		vector<SnapshotItem> items; ///< In drawing order
+		vector<SnapshotBlip> blips;
+		bool hasTarget;
+		SnapshotTarget target;
+		bool cut; ///< The Camera jumped, so the frame before this one shouldn't be blended in
+
+		float fframe; ///< How far the renderer is between the last two frames, set by the renderer
+
+		static void Initialize( void );
+		static void Shutdown( void );
+
+		static Snapshot* Begin( void );
+		static void Publish( void );
+		static Snapshot* GetLatest( void );
+
+	private:
+		// One Snapshot is written by the logic thread, one is drawn by the
+		// render thread, and the third holds the newest finished one
+		static Snapshot buffers[3];
+		static Snapshot *writing, *ready, *reading;
+		static bool fresh; ///< ready is newer than reading
+		static SDL_mutex *lock; ///< guards the swaps
+};
+
+#endif // __h_snapshot__
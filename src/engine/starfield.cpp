@@ -10,14 +10,14 @@
 #include "common.h"
 #include "engine/starfield.h"
 #include "graphics/video.h"
-#include "engine/camera.h"
 #include "utilities/timer.h"
 
 /**\class Starfield
- * \brief Controls the starfield. */
-
-/**\struct Starfield::_stars
- * \brief Contains x,y coordinate as well as the color
+ * \brief Controls the starfield.
+ * \details The stars are stored as separate x, y, ox, oy and clr arrays.
+ *          When drawing, every pixel of every star is sorted into one of
+ *          STARFIELD_LEVELS grey levels, and each level is drawn with a
+ *          single Video::DrawPoints call.
  */
 
 /**\brief Initializes the starfield.
@@ -30,118 +30,149 @@ Starfield::Starfield( int numStars ) {
 	srand(static_cast<unsigned int>( time(NULL) ));
 
 	// allocate space for stars
-	stars = (struct _star *)malloc( sizeof(struct _star) * numStars );
+	x = (float *)malloc( sizeof(float) * numStars );
+	y = (float *)malloc( sizeof(float) * numStars );
+	ox = (float *)malloc( sizeof(float) * numStars );
+	oy = (float *)malloc( sizeof(float) * numStars );
+	clr = (float *)malloc( sizeof(float) * numStars );
 
 	// randomly assign position and color
 	for( i = 0; i < numStars; i++ ) {
-		stars[i].ox = stars[i].x = (float)(rand() % (int)(1.3 * Video::GetWidth()));
-		stars[i].oy = stars[i].y = (float)(rand() % (int)(1.4 * Video::GetHeight()));
+		ox[i] = x[i] = (float)(rand() % (int)(1.3 * Video::GetWidth()));
+		oy[i] = y[i] = (float)(rand() % (int)(1.4 * Video::GetHeight()));
 
 		// rand() % 225 generates greys between 0 and 225
-		stars[i].clr = static_cast<float>( (rand() % 225) / 256. );
+		clr[i] = static_cast<float>( (rand() % 225) / 256. );
+	}
+
+	// Each star lights up to four pixels, spread over the grey levels
+	for( i = 0; i < STARFIELD_LEVELS; i++ ) {
+		batches[i].reserve( (4 * numStars) / STARFIELD_LEVELS + 1 );
 	}
 
 	this->numStars = numStars;
+
+	focused = false;
 }
 
 /**\brief Destroys Starfield
  */
 Starfield::~Starfield( void ) {
-	assert( stars != NULL );
-	free( stars );
-	stars = NULL;
+	assert( x != NULL );
+	free( x );
+	free( y );
+	free( ox );
+	free( oy );
+	free( clr );
+	x = y = ox = oy = clr = NULL;
 }
 
 /**\brief Draws the Starfield
+ * \param fframe How far to draw the stars between the last two Updates
  */
-void Starfield::Draw( void ) {
+void Starfield::Draw( float fframe ) {
 	int i;
 
-	for( i = 0; i < numStars; i++ ) {
-		drawStar(stars[i].ox, stars[i].oy, stars[i].x, stars[i].y, stars[i].clr);
+	for( i = 0; i < STARFIELD_LEVELS; i++ ) {
+		batches[i].clear();
+	}
+
+	if( fframe < 1.f ) {
+		for( i = 0; i < numStars; i++ ) {
+			batchStar( ox[i] * (1.0f - fframe) + x[i] * fframe,
+			           oy[i] * (1.0f - fframe) + y[i] * fframe, clr[i] );
+		}
+	} else {
+		for( i = 0; i < numStars; i++ ) {
+			batchStar( x[i], y[i], clr[i] );
+		}
+	}
+
+	// Level 0 is black, so it is never drawn
+	for( i = 1; i < STARFIELD_LEVELS; i++ ) {
+		if( batches[i].empty() ) continue;
+
+		float grey = static_cast<float>(i) / (STARFIELD_LEVELS - 1);
+		Video::DrawPoints( &batches[i][0], batches[i].size(), grey, grey, grey );
 	}
 }
 
-/**\brief Updates the Starfield
+/**\brief Scrolls the Starfield by how far the camera moved since the last Update
+ * \param focus Where the camera is looking now
  */
-void Starfield::Update( Camera *camera ) {
+void Starfield::Update( Coordinate focus ) {
 	int i;
 	double dx, dy;
-	float w, h;
+	float w, h, fdx, fdy;
 
-	assert(camera != NULL);
-	camera->GetDelta( &dx, &dy );
+	if( !focused ) {
+		this->focus = focus;
+		focused = true;
+	}
+
+	dx = focus.GetX() - this->focus.GetX();
+	dy = focus.GetY() - this->focus.GetY();
+	this->focus = focus;
 
 	w = static_cast<float>(1.3 * Video::GetWidth());
 	h = static_cast<float>(1.4 * Video::GetHeight());
+	fdx = static_cast<float>( dx );
+	fdy = static_cast<float>( dy );
 
+	// No branches or calls other than floorf, so this loop can be vectorized
 	for( i = 0; i < numStars; i++ ) {
-		stars[i].ox = stars[i].x;
-		stars[i].oy = stars[i].y;
-
-		stars[i].x -= (float)dx * stars[i].clr;
-		stars[i].y += (float)dy * stars[i].clr;
-
-		// handle wrapping the stars around if they go offscreen top/left
-		while( stars[i].x < 0.0f ) {
-			stars[i].ox += w;
-			stars[i].x += w;
-		}
-		while( stars[i].y < 0.0f ) {
-			stars[i].oy += h;
-			stars[i].y += h;
-		}
-
-		// handle wrapping the stars around if they go offscreen bottom/right
-		while( stars[i].x > w ) {
-			stars[i].ox -= w;
-			stars[i].x -= w;
-		}
-		while( stars[i].y > h ) {
-			stars[i].oy -= h;
-			stars[i].y -= h;
-		}
+		float nx = x[i] - fdx * clr[i];
+		float ny = y[i] + fdy * clr[i];
+
+		// wrap the stars around when they leave the field, moving the old
+		// position along with them so the interpolation doesn't streak
+		float wrapx = w * floorf( nx / w );
+		float wrapy = h * floorf( ny / h );
+
+		ox[i] = x[i] - wrapx;
+		oy[i] = y[i] - wrapy;
+		x[i] = nx - wrapx;
+		y[i] = ny - wrapy;
 	}
 }
 
-/**\brief Draws the stars
+/**\brief Adds the pixels of one star to the draw batches
+ * \details Each star is drawn as a 2x2 block, with the brightness of each
+ *          pixel weighted by how close the star is to it.
  */
-inline void Starfield::drawStar(float ox, float oy, float x, float y, float  brightness) {
+inline void Starfield::batchStar( float ix, float iy, float brightness ) {
 	float drawBrightness;
 	float xcomponent;
 	float ycomponent;
-	float ix, iy;
-	double fframe = Timer::GetFFrame();
-
-	if(interpolateOn) {
-		ix = ox * (1.0f - fframe) + x * fframe;
-		iy = oy * (1.0f - fframe) + y * fframe;
-	} else {
-		ix = x;
-		iy = y;
-	}
+	int level;
+	int width = Video::GetWidth();
+	int height = Video::GetHeight();
+	int px = (int)ix;
+	int py = (int)iy;
 
 	// Loop between both X columns
 	for (int xcnt = 0; xcnt <= 1; xcnt++) {
 		// Check for clipping in the X direction (make sure it fits horizontally)
-		if (((int)ix - xcnt)>= 0 && ((int)iy - xcnt) < Video::GetWidth()) {
+		if ((px - xcnt) >= 0 && (px - xcnt) < width) {
 			// Loop between both Y rows
 			for (int ycnt = 0; ycnt <= 1; ycnt++) {
 				// Check for clipping in the Y direction (make sure it fits vertically)
-				if ((int)iy - ycnt >= 0 && (int)iy - ycnt < Video::GetHeight()) {
+				if (py - ycnt >= 0 && py - ycnt < height) {
 					// Get the x component of the brightness and divide it by 2
-					xcomponent = (((float)(xcnt - (ix - (int)ix)) * .5f));
+					xcomponent = fabsf( ((float)xcnt - (ix - px)) * .5f );
 
 					// Get the y component of the brightness and divide it by 2
-					ycomponent = (((float)(ycnt - (iy - (int)iy)) * .5f));
-
-					if(ycomponent < 0) ycomponent = ycomponent * -1;
-					if(xcomponent < 0) xcomponent = xcomponent * -1;
+					ycomponent = fabsf( ((float)ycnt - (iy - py)) * .5f );
 
-					// Add the x anid y components of the brightness to get the total brightness at that particular location
+					// Add the x and y components of the brightness to get the total brightness at that particular location
 					drawBrightness = ((xcomponent + ycomponent) * brightness);
 
-					Video::DrawPoint((int)ix - xcnt, (int)iy - ycnt, drawBrightness, drawBrightness, drawBrightness);
+					level = (int)( drawBrightness * (STARFIELD_LEVELS - 1) + .5f );
+					if( level <= 0 ) continue;
+					if( level >= STARFIELD_LEVELS ) level = STARFIELD_LEVELS - 1;
+
+					SDL_Point point = { px - xcnt, py - ycnt };
+					batches[level].push_back( point );
 				}
 			}
 		}
@@ -6,28 +6,38 @@
  * \details
  */
 
-#include "engine/camera.h"
+#include "includes.h"
+#include "utilities/coordinate.h"
 
 #ifndef __h_starfield__
 #define __h_starfield__
 
+// Number of grey levels the stars are quantized into when drawing. Each
+// level is submitted to the renderer as a single batch of points.
+#define STARFIELD_LEVELS 32
+
 class Starfield {
 	public:
 		Starfield( int numStars );
 		~Starfield( void );
 
-		void Draw( void );
-		void Update( Camera *camera );
+		void Draw( float fframe );
+		void Update( Coordinate focus );
 
 	private:
-		inline void drawStar( float ox, float oy, float x, float y, float brightness);
+		inline void batchStar( float ix, float iy, float brightness );
+
+		// Star data is kept as packed arrays so that Update is a flat loop
+		float *x, *y; ///< Current positions
+		float *ox, *oy; ///< Positions from the previous logic frame
+		float *clr; ///< Brightness, also used as the parallax factor
 
-		struct _star {
-			float x, y, ox, oy;
-			float clr;
-		} *stars;
+		vector<SDL_Point> batches[STARFIELD_LEVELS]; ///< Points to draw this frame, by grey level
 
 		int numStars; // number of stars
+
+		Coordinate focus; ///< Where the camera was looking at the last Update
+		bool focused; ///< false until the first Update
 };
 
 #endif // __h_starfield__
@@ -58,41 +58,16 @@ Technology::Technology( string _name,
  */
 bool Technology::FromXMLNode( xmlDocPtr doc, xmlNodePtr node ) {
 	xmlNodePtr tech;
-	string value;
 
 	for( tech = node->xmlChildrenNode; tech != NULL; tech = tech->next ) {
 		if( NodeNameIs( tech, "model" )) {
-			value = NodeToString(doc, tech);
-			Model* model = Menu::GetCurrentScenario()->GetModels()->GetModel( value );
-			if(model == NULL) {
-				LogMsg(ERR, "Could Not find the technology '%s'.", value.c_str() );
-			} else {
-				models.push_back( model );
-			}
+			modelNames.push_back( NodeToString(doc, tech) );
 		} else if( NodeNameIs( tech, "engine" )) {
-			value = NodeToString(doc, tech);
-			Engine* engine = Menu::GetCurrentScenario()->GetEngines()->GetEngine( value );
-			if(engine == NULL) {
-				LogMsg(ERR, "Could Not find the technology '%s'.", value.c_str() );
-			} else {
-				engines.push_back( engine );
-			}
+			engineNames.push_back( NodeToString(doc, tech) );
 		} else if( NodeNameIs( tech, "weapon" )) {
-			value = NodeToString(doc, tech);
-			Weapon* weapon = Menu::GetCurrentScenario()->GetWeapons()->GetWeapon( value );
-			if(weapon == NULL) {
-				LogMsg(ERR, "Could Not find the technology '%s'.", value.c_str() );
-			} else {
-				weapons.push_back( weapon );
-			}
+			weaponNames.push_back( NodeToString(doc, tech) );
 		} else if( NodeNameIs( tech, "outfit" )) {
-			value = NodeToString(doc, tech);
-			Outfit* outfit = Menu::GetCurrentScenario()->GetOutfits()->GetOutfit( value );
-			if(outfit == NULL) {
-				LogMsg(ERR, "Could Not find the technology '%s'.", value.c_str() );
-			} else {
-				outfits.push_back( outfit );
-			}
+			outfitNames.push_back( NodeToString(doc, tech) );
 		} else {
 
 		}
@@ -100,6 +75,53 @@ bool Technology::FromXMLNode( xmlDocPtr doc, xmlNodePtr node ) {
 	return true;
 }
 
+/**\brief Finds the Models, Engines, Weapons and Outfits that FromXMLNode named
+ */
+bool Technology::Link( void ) {
+	Scenario *scenario = Menu::GetCurrentScenario();
+	list<string>::iterator i;
+
+	for( i = modelNames.begin(); i != modelNames.end(); ++i ) {
+		Model* model = scenario->GetModels()->GetModel( *i );
+		if(model == NULL) {
+			LogMsg(ERR, "Could Not find the technology '%s'.", i->c_str() );
+		} else {
+			models.push_back( model );
+		}
+	}
+	for( i = engineNames.begin(); i != engineNames.end(); ++i ) {
+		Engine* engine = scenario->GetEngines()->GetEngine( *i );
+		if(engine == NULL) {
+			LogMsg(ERR, "Could Not find the technology '%s'.", i->c_str() );
+		} else {
+			engines.push_back( engine );
+		}
+	}
+	for( i = weaponNames.begin(); i != weaponNames.end(); ++i ) {
+		Weapon* weapon = scenario->GetWeapons()->GetWeapon( *i );
+		if(weapon == NULL) {
+			LogMsg(ERR, "Could Not find the technology '%s'.", i->c_str() );
+		} else {
+			weapons.push_back( weapon );
+		}
+	}
+	for( i = outfitNames.begin(); i != outfitNames.end(); ++i ) {
+		Outfit* outfit = scenario->GetOutfits()->GetOutfit( *i );
+		if(outfit == NULL) {
+			LogMsg(ERR, "Could Not find the technology '%s'.", i->c_str() );
+		} else {
+			outfits.push_back( outfit );
+		}
+	}
+
+	modelNames.clear();
+	engineNames.clear();
+	weaponNames.clear();
+	outfitNames.clear();
+
+	return true;
+}
+
 /**\brief Converts the Technology object to an XML node
  */
 xmlNodePtr Technology::ToXMLNode(string componentName) {
@@ -21,6 +21,7 @@ class Technology : public Component {
   		Technology& operator= (const Technology&);
 		Technology( string _name, list<Model*> _models, list<Engine*>_engines, list<Weapon*>_weapons, list<Outfit*>_outfits);
 		bool FromXMLNode( xmlDocPtr doc, xmlNodePtr node );
+		bool Link( void );
 		xmlNodePtr ToXMLNode(string componentName);
 
 		list<Model*> GetModels() { return models; }
@@ -33,6 +34,12 @@ class Technology : public Component {
 		list<Engine*> engines;
 		list<Weapon*> weapons;
 		list<Outfit*> outfits;
+
+		// Named by FromXMLNode, until Link finds them
+		list<string> modelNames;
+		list<string> engineNames;
+		list<string> weaponNames;
+		list<string> outfitNames;
 };
 
 // Class that holds list of all technologies; manages them
@@ -130,14 +130,14 @@ bool Weapon::FromXMLNode( xmlDocPtr doc, xmlNodePtr node ) {
 	}
 
 	if( (attr = FirstChildNamed(node,"imageName")) ){
-		image = Image::Get( NodeToString(doc,attr) );
+		image = Image::Defer( NodeToString(doc,attr) );
 	} else {
 		LogMsg(ERR,"Could not find child node imageName while searching component");
 		return false;
 	}
 
 	if( (attr = FirstChildNamed(node,"picName")) ){
-		Image* pic = Image::Get( NodeToString(doc,attr) );
+		Image* pic = Image::Defer( NodeToString(doc,attr) );
 		// This image can be accessed by either the path or the Weapon Name
 		Image::Store(name, pic);
 		SetPicture(pic);
@@ -227,7 +227,7 @@ bool Weapon::FromXMLNode( xmlDocPtr doc, xmlNodePtr node ) {
 
 	if( (attr = FirstChildNamed(node, "sound")) ) {
 		value = NodeToString(doc,attr);
-		this->sound = Sound::Get( value );
+		this->sound = Sound::Defer( value );
 		if( this->sound == NULL) {
 			// Do not return false here - they may be disabling audio on purpose or audio may not be supported on their system
 			LogMsg(WARN, "Could not load sound file while searching component");
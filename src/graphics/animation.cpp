@@ -1,7 +1,7 @@
 /**\file			animation.cpp
  * \author			Christopher Thielen (chris@epiar.net)
  * \date			Created: Unknown (2006?)
- * \date			Modified: Sunday, November 22, 2009
+ * \date			Modified: Monday, October 19, 2026
  * \brief
  * \details
  */
@@ -9,10 +9,31 @@
 #include "includes.h"
 #include "graphics/animation.h"
 #include "utilities/file.h"
+#include "utilities/loader.h"
 #include "utilities/log.h"
 #include "utilities/resource.h"
 
 #define ANI_VERSION 1
+#define ANI_PACK_VERSION 2
+#define ANI_PACK_MAGIC 0x4B415045 // "EPAK"
+
+#define ANI_PACK_RAW 0
+#define ANI_PACK_LZ4 1
+
+// Everything in a pack is little endian
+typedef struct {
+	Uint8 version; ///< Where the .ani version byte has always been
+	Uint8 numFrames;
+	Uint8 delay;
+	Uint8 compression;
+	Uint32 magic;
+	Uint16 sheetW, sheetH;
+	Uint32 dataSize; ///< Bytes of pixel data after the index, as stored
+} AniPackHeader;
+
+typedef struct {
+	Uint16 x, y, w, h;
+} AniPackFrame;
 
 /** \class Ani
  *  \brief An animation data object
@@ -34,21 +55,75 @@
  *
  *  - Multiple Images concatenated together
  *  
+ *  ANI_VERSION 2 (a pack):
+ *
+ *  - An AniPackHeader
+ *
+ *  - One AniPackFrame per frame, saying where it is on the sprite sheet
+ *
+ *  - The sprite sheet as RGBA bytes, row after row, either as they are or
+ *    compressed as one LZ4 block
+ *
+ *  A pack is read in one go and uploaded as a single texture that every
+ *  frame shares, so nothing has to be decoded when it is loaded.
+ *
  *  The external python script "ani.py" can be used to extract, modify, and create .ani files.
+ *  "ani.py --pack" turns .ani files and folders of PNGs into packs.
  *
  *  \warning Since this file format is developed specifically for Epiar it is more fragile than other file formats.  For example, it makes endianess assumptions that require the bytes be swapped before it can be loaded on Big Endian machines.
  *  \see Animation
  */
 
+/**\class AniJob
+ * \brief Reads and decodes an Ani for the Loader. */
+class AniJob : public LoadJob {
+	public:
+		AniJob( Ani *_ani, const string& _filename )
+			:ani(_ani), filename(_filename), frameDelay(0), ok(false) {}
+
+		void Run( void ) {
+			ok = Ani::Decode( filename, &frameDelay, surfaces, regions );
+		}
+
+		void Finish( void ) {
+			ani->loading = NULL;
+
+			if( ok ) {
+				ani->Load( frameDelay, surfaces, regions );
+			}
+		}
+
+	private:
+		Ani *ani;
+		string filename;
+		Uint32 frameDelay;
+		vector<SDL_Surface*> surfaces;
+		vector<SDL_Rect> regions;
+		bool ok;
+};
+
 /**\brief Gets the resource object.
+ * \details The frames are loaded by the Loader, so the Ani has no frames
+ *          until it is finished.
  * \param filename string containing the animation
  */
 Ani* Ani::Get( string filename ) {
 	Ani* value;
 	value = (Ani*)Resource::Get(filename);
 	if( value == NULL ) {
-		value = new Ani(filename);
-		Resource::Store(filename,(Resource*)value);
+		value = new Ani();
+		value->loading = new AniJob( value, filename );
+
+		Ani* stored = (Ani*)Resource::Store(filename,(Resource*)value);
+		if( stored != value ) {
+			// Another thread is loading it already, so this job never ran
+			delete value->loading;
+			value->loading = NULL;
+			delete value;
+			return stored;
+		}
+
+		Loader::Queue( value->loading );
 	}
 	return value;
 }
@@ -57,6 +132,8 @@ Ani* Ani::Get( string filename ) {
  */
 Ani::Ani() {
 	frames = NULL;
+	sheet = NULL;
+	loading = NULL;
 	delay = 0;
 	numFrames = 0;
 	w = h = 0;
@@ -70,6 +147,8 @@ Ani::Ani( string& filename ) {
 	LogMsg(INFO, "New Animation from '%s'", filename.c_str() );
 
 	frames = NULL;
+	sheet = NULL;
+	loading = NULL;
 	delay = 0;
 	numFrames = 0;
 	w = h = 0;
@@ -77,73 +156,314 @@ Ani::Ani( string& filename ) {
 	Load( filename );
 }
 
+/**\brief Frees the frames, and the sprite sheet that a pack's frames share.
+ * \details The Loader finishes the frames first if it still has them.
+ */
+Ani::~Ani() {
+	if( loading ) {
+		Loader::Wait( loading );
+	}
+
+	// The frames of a pack draw from the sheet, so they go first
+	delete [] frames;
+	frames = NULL;
+
+	delete sheet;
+	sheet = NULL;
+}
+
 /**\brief Loads the animation file.
  * \param filename File name of the animation
  */
 bool Ani::Load( string& filename ) {
-	char byte;
-	const char *cName = filename.c_str();
-	File file = File( cName );
+	vector<SDL_Surface*> surfaces;
+	vector<SDL_Rect> regions;
+	Uint32 frameDelay;
 
-	LogMsg(INFO, "Loading animation '%s'", cName );
+	if( !Decode( filename, &frameDelay, surfaces, regions ) ) {
+		return( false );
+	}
 
-	file.Read( 1, &byte );
-	if( byte != ANI_VERSION ) {
-		LogMsg(ERR, "Incorrect ani version" );
+	return( Load( frameDelay, surfaces, regions ) );
+}
+
+/**\brief Takes the decoded frames of an animation.
+ * \param frameDelay How long each frame lasts
+ * \param surfaces The pixels of each frame, which the frames then own
+ * \param regions Empty, or where each frame is on the one sprite sheet in surfaces
+ */
+bool Ani::Load( Uint32 frameDelay, vector<SDL_Surface*>& surfaces, vector<SDL_Rect>& regions ) {
+	delay = frameDelay;
+
+	if( regions.empty() ) {
+		numFrames = surfaces.size();
+
+		// Allocate space for frames
+		frames = new Image[numFrames];
+
+		for( int i = 0; i < numFrames; i++ ) {
+			frames[i].Load( surfaces[i] );
+		}
+	} else {
+		numFrames = regions.size();
+
+		// Every frame draws from the same texture
+		sheet = new Image();
+		sheet->Load( surfaces[0] );
+
+		frames = new Image[numFrames];
+
+		for( int i = 0; i < numFrames; i++ ) {
+			frames[i].Load( sheet, regions[i] );
+		}
+	}
+
+	w = frames[0].GetWidth();
+	h = frames[0].GetHeight();
+
+	//LogMsg(INFO, "Animation loading done." );
+
+	return( true );
+}
+
+/**\brief Expands one LZ4 block.
+ * \return false unless exactly dstSize bytes came out of it
+ */
+static bool DecompressLZ4( const Uint8 *src, long srcSize, Uint8 *dst, long dstSize ) {
+	const Uint8 *srcEnd = src + srcSize;
+	Uint8 *out = dst;
+	Uint8 *outEnd = dst + dstSize;
+
+	while( src < srcEnd ) {
+		Uint8 token = *src++;
+		long length = token >> 4;
+
+		// Literals
+		if( length == 15 ) {
+			Uint8 more;
+			do {
+				if( src >= srcEnd ) return( false );
+				more = *src++;
+				length += more;
+			} while( more == 255 );
+		}
+		if( length > srcEnd - src || length > outEnd - out ) {
+			return( false );
+		}
+		memcpy( out, src, length );
+		src += length;
+		out += length;
+
+		// The last sequence has no match
+		if( src >= srcEnd ) {
+			break;
+		}
+
+		// Match
+		if( srcEnd - src < 2 ) {
+			return( false );
+		}
+		long offset = src[0] | ( src[1] << 8 );
+		src += 2;
+		if( offset == 0 || offset > out - dst ) {
+			return( false );
+		}
+
+		length = token & 0x0F;
+		if( length == 15 ) {
+			Uint8 more;
+			do {
+				if( src >= srcEnd ) return( false );
+				more = *src++;
+				length += more;
+			} while( more == 255 );
+		}
+		length += 4;
+		if( length > outEnd - out ) {
+			return( false );
+		}
+
+		// Matches may overlap what they copy, so this goes a byte at a time
+		const Uint8 *match = out - offset;
+		while( length-- ) {
+			*out++ = *match++;
+		}
+	}
+
+	return( out == outEnd );
+}
+
+/**\brief Reads the sprite sheet of a pack.
+ * \param surfaces Gets the sprite sheet
+ * \param regions Gets where each frame is on the sheet
+ */
+static bool DecodePack( const char *cName, const char *data, long length, Uint32 *frameDelay, vector<SDL_Surface*>& surfaces, vector<SDL_Rect>& regions ) {
+	AniPackHeader header;
+	long pos = sizeof(header);
+	int i;
+
+	if( length < pos ) {
+		LogMsg(ERR, "'%s' is too short to be an animation pack", cName );
 		return( false );
 	}
+	memcpy( &header, data, sizeof(header) );
 
-	file.Read( 1, &byte );
-	if( byte <= 0 ) {
-		LogMsg(ERR, "Cannot have zero or less frames" );
+	if( SDL_SwapLE32( header.magic ) != ANI_PACK_MAGIC ) {
+		LogMsg(ERR, "'%s' is not an animation pack", cName );
+		return( false );
+	}
+	if( header.numFrames == 0 || header.delay == 0 ) {
+		LogMsg(ERR, "Cannot have zero frames or a zero delay" );
 		return( false );
 	}
-	numFrames = byte;
-	// Allocate space for frames
-	frames = new Image[byte];
+	*frameDelay = header.delay;
 
-	file.Read( 1, &byte );
-	if( byte <= 0 ) {
-		LogMsg(ERR, "Cannot have zero or less for a delay" );
-		delete [] frames;
-		frames = NULL;
+	int sheetW = SDL_SwapLE16( header.sheetW );
+	int sheetH = SDL_SwapLE16( header.sheetH );
+	long dataSize = SDL_SwapLE32( header.dataSize );
+
+	if( length - pos < static_cast<long>( header.numFrames * sizeof(AniPackFrame) ) ) {
+		LogMsg(ERR, "'%s' is missing its frame index", cName );
 		return( false );
 	}
-	delay = byte;
+	for( i = 0; i < header.numFrames; i++ ) {
+		AniPackFrame frame;
+		SDL_Rect region;
+
+		memcpy( &frame, data + pos, sizeof(frame) );
+		pos += sizeof(frame);
+
+		region.x = SDL_SwapLE16( frame.x );
+		region.y = SDL_SwapLE16( frame.y );
+		region.w = SDL_SwapLE16( frame.w );
+		region.h = SDL_SwapLE16( frame.h );
+		if( region.w == 0 || region.h == 0 || region.x + region.w > sheetW || region.y + region.h > sheetH ) {
+			LogMsg(ERR, "Frame %d of '%s' is not on the sprite sheet", i, cName );
+			return( false );
+		}
+		regions.push_back( region );
+	}
 
-	for( int i = 0; i < numFrames; i++ ) {
-		long pos;
-		int fs;
+	if( dataSize > length - pos ) {
+		LogMsg(ERR, "'%s' is missing part of its sprite sheet", cName );
+		return( false );
+	}
 
-		file.Read( sizeof(int), (char *) &fs );
+	SDL_Surface *surface = SDL_CreateRGBSurfaceWithFormat( 0, sheetW, sheetH, 32, SDL_PIXELFORMAT_RGBA32 );
+	if( surface == NULL ) {
+		LogMsg(ERR, "Could not create the sprite sheet for '%s': %s", cName, SDL_GetError() );
+		return( false );
+	}
 
-		// Big Endian Machines need to swap the bytes here.
-		if( IsBigEndian() ) {
-			LogMsg(ERR, "Swapping Bytes for Endianness");
-			fs = SDL_SwapLE32(fs);
+	// The rows are packed in the file, so they can go straight into the surface if it has no padding
+	long rowBytes = sheetW * 4L;
+	long sheetBytes = rowBytes * sheetH;
+	bool direct = ( surface->pitch == rowBytes );
+	Uint8 *pixels = direct ? static_cast<Uint8*>( surface->pixels ) : new Uint8[sheetBytes];
+	const Uint8 *stored = reinterpret_cast<const Uint8*>( data + pos );
+	bool ok;
+
+	if( header.compression == ANI_PACK_LZ4 ) {
+		ok = DecompressLZ4( stored, dataSize, pixels, sheetBytes );
+	} else if( header.compression == ANI_PACK_RAW ) {
+		ok = ( dataSize == sheetBytes );
+		if( ok ) {
+			memcpy( pixels, stored, sheetBytes );
 		}
+	} else {
+		ok = false;
+	}
 
-		pos = file.Tell();
+	if( !direct ) {
+		if( ok ) {
+			for( int row = 0; row < sheetH; row++ ) {
+				memcpy( static_cast<Uint8*>( surface->pixels ) + row * surface->pitch, pixels + row * rowBytes, rowBytes );
+			}
+		}
+		delete [] pixels;
+	}
 
-		// On OS X 10.6 with SDL_image 1.2.8, the load from fp is broken, so we load it into a buffer ourselves and SDL_image
-		// loads from that correctly. It's an extra step on our part, but performance/functionally they're identical. Hopefully
-		// this gets fixed in a future SDL_image
-		char *buf = new char [fs];
-		file.Read( fs, buf );
+	if( !ok ) {
+		LogMsg(ERR, "Could not read the sprite sheet of '%s'", cName );
+		SDL_FreeSurface( surface );
+		regions.clear();
+		return( false );
+	}
 
-		//frames[i].Load( fp, (int)fs );
-		frames[i].Load( buf, fs );
+	surfaces.push_back( surface );
 
-		delete [] buf;
-		buf = NULL;
+	return( true );
+}
 
-		file.Seek( pos + fs );
+/**\brief Reads and decodes the frames of an animation file.
+ * \details This doesn't touch the renderer, so any thread can use it.
+ * \param filename File name of the animation
+ * \param frameDelay Set to how long each frame lasts
+ * \param surfaces Filled with the pixels of each frame, or with the sprite sheet of a pack
+ * \param regions Filled with where each frame is on the sprite sheet, for a pack
+ */
+bool Ani::Decode( const string& filename, Uint32 *frameDelay, vector<SDL_Surface*>& surfaces, vector<SDL_Rect>& regions ) {
+	int count;
+	const char *cName = filename.c_str();
+	File file( cName );
+	const char *data = file.Map();
+	long length = file.GetLength();
+	long pos = 3;
+
+	LogMsg(INFO, "Loading animation '%s'", cName );
+
+	if( data == NULL || length < pos ) {
+		LogMsg(ERR, "Could not read '%s'", cName );
+		return( false );
 	}
 
-	w = frames[0].GetWidth();
-	h = frames[0].GetHeight();
+	if( data[0] == ANI_PACK_VERSION ) {
+		return( DecodePack( cName, data, length, frameDelay, surfaces, regions ) );
+	}
 
-	//LogMsg(INFO, "Animation loading done." );
+	if( data[0] != ANI_VERSION ) {
+		LogMsg(ERR, "Incorrect ani version" );
+		return( false );
+	}
+
+	if( data[1] <= 0 ) {
+		LogMsg(ERR, "Cannot have zero or less frames" );
+		return( false );
+	}
+	count = data[1];
+
+	if( data[2] <= 0 ) {
+		LogMsg(ERR, "Cannot have zero or less for a delay" );
+		return( false );
+	}
+	*frameDelay = data[2];
+
+	// The frames are decoded straight out of the file
+	for( int i = 0; i < count; i++ ) {
+		Sint32 fs;
+		SDL_Surface *surface = NULL;
+
+		if( length - pos >= static_cast<long>( sizeof(fs) ) ) {
+			memcpy( &fs, data + pos, sizeof(fs) );
+			fs = SDL_SwapLE32( fs );
+			pos += sizeof(fs);
+
+			if( fs >= 0 && fs <= length - pos ) {
+				surface = Image::Decode( data + pos, fs );
+				pos += fs;
+			}
+		}
+
+		if( surface == NULL ) {
+			LogMsg(ERR, "Could not decode frame %d of '%s'", i, cName );
+			for( vector<SDL_Surface*>::iterator s = surfaces.begin(); s != surfaces.end(); ++s ) {
+				SDL_FreeSurface( *s );
+			}
+			surfaces.clear();
+			return( false );
+		}
+		surfaces.push_back( surface );
+	}
 
 	return( true );
 }
@@ -212,6 +532,13 @@ Animation::Animation( string filename ) {
 bool Animation::Update() {
 	bool finished = false;
 
+	// Wait for the Loader, and don't play broken animations at all
+	if( ani->IsLoading() ) {
+		return false;
+	} else if( ani->GetNumFrames() == 0 ) {
+		return true;
+	}
+
 	if( startTime ) {
 		fnum = (SDL_GetTicks() - startTime) / ani->GetDelay();
 
@@ -232,8 +559,11 @@ bool Animation::Update() {
 /**\brief Draws the animation at given coordinate.
  */
 void Animation::Draw( int x, int y, float ang, float alpha ) {
-	Image* frame = ani->GetFrame( fnum );
-	frame->DrawCentered( x, y, ang, alpha );
+	Image *frame = GetFrame();
+
+	if( frame != NULL ) {
+		frame->DrawCentered( x, y, ang, alpha );
+	}
 }
 
 /**\brief Resets animation data back to the first frame.
@@ -1,7 +1,7 @@
 /**\file			animation.h
  * \author			Christopher Thielen (chris@epiar.net)
  * \date			Created: Unknown (2006?)
- * \date			Modified: Sunday, November 22, 2009
+ * \date			Modified: Monday, October 19, 2026
  * \brief
  * \details
  */
@@ -13,13 +13,19 @@
 #include "utilities/resource.h"
 #include "includes.h"
 
+class LoadJob;
+
 class Ani : public Resource {
 	public:
 		Ani();
 		Ani( string& filename );
+		~Ani();
 		bool Load( string& filename );
+		bool Load( Uint32 frameDelay, vector<SDL_Surface*>& surfaces, vector<SDL_Rect>& regions );
 		static Ani* Get(string filename);
+		static bool Decode( const string& filename, Uint32 *frameDelay, vector<SDL_Surface*>& surfaces, vector<SDL_Rect>& regions );
 
+		bool IsLoading() { return loading != NULL; }
 		Image* GetFrame(int frameNum);
 		int GetNumFrames() { return numFrames; }
 		int GetDelay() { return delay; }
@@ -28,9 +34,13 @@ class Ani : public Resource {
 
 	private:
 		Image *frames;
+		Image *sheet; ///< The sprite sheet that the frames of a pack are drawn from
+		LoadJob *loading; ///< The Loader's job for this Ani, until it is finished
 		int numFrames;
 		Uint32 delay;
 		int w, h;
+
+		friend class AniJob;
 };
 
 class Animation {
@@ -39,6 +49,7 @@ class Animation {
 		Animation( string filename );
 		bool Update( void );
 		void Draw( int x, int y, float ang, float alpha );
+		Image* GetFrame( void ) { return ani->GetNumFrames() ? ani->GetFrame( fnum ) : NULL; } // NULL until the Ani is loaded
 		void SetLoopPercent( float loopPercent );
 		float GetLoopPercent( void ) { return loopPercent; };
 		void Reset( void );
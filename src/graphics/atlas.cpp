@@ -0,0 +1,160 @@
+/**\file			atlas.cpp
+ * \author			Christopher Thielen (chris@epiar.net)
+ * \date			Created: Sunday, October 18, 2026
+ * \date			Modified: Sunday, October 18, 2026
+ * \brief			Packs images into a few large textures
+ * \details
+ */
+
+#include "includes.h"
+#include "common.h"
+#include "graphics/atlas.h"
+#include "graphics/video.h"
+#include "utilities/log.h"
+#include "utilities/resource.h"
+
+/**\class Atlas
+ * \brief Texture atlas for small images.
+ * \details Images are packed into square pages as they are loaded, using
+ *          a simple shelf packer: images are placed left to right, and a new
+ *          shelf is started below the tallest image once a row is full.
+ *          Space is never reclaimed since Images live as long as the game.
+ *
+ *          Since every image on a page shares one SDL_Texture, sprites drawn
+ *          from the same page can be submitted together by the SpriteBatch.
+ *          Font glyphs are stored here as well, so text is batched along
+ *          with the sprites around it.
+ * \see SpriteBatch
+ */
+
+/**\class AtlasPage
+ * \brief One texture of the Atlas, and the packing state of its free space.
+ */
+
+vector<AtlasPage*> Atlas::pages;
+int Atlas::pageSize = 0;
+
+/**\brief Copies an image into the atlas.
+ * \param surface The image to copy. It is not modified or freed.
+ * \param texture Set to the page texture the image was copied into.
+ * \param where Set to the area of the page that now holds the image.
+ * \return false if the image doesn't fit on a page and should be given a
+ *         texture of its own instead.
+ */
+bool Atlas::Insert( SDL_Surface *surface, SDL_Texture **texture, SDL_Rect *where ) {
+	AtlasPage *page = NULL;
+
+	if( pageSize == 0 ) {
+		SDL_RendererInfo info;
+
+		pageSize = OPTION( int, "options/video/atlas-size" );
+		if( SDL_GetRendererInfo( Video::GetRenderer(), &info ) == 0 ) {
+			if( info.max_texture_width > 0 && pageSize > info.max_texture_width )
+				pageSize = info.max_texture_width;
+			if( info.max_texture_height > 0 && pageSize > info.max_texture_height )
+				pageSize = info.max_texture_height;
+		}
+	}
+
+	if( surface->w + 2 * ATLAS_PADDING > pageSize || surface->h + 2 * ATLAS_PADDING > pageSize ) {
+		return false;
+	}
+
+	// Only the last page is still being filled; earlier pages are full
+	// enough that it isn't worth searching them.
+	if( pages.empty() || !Fits( pages.back(), surface->w, surface->h, where ) ) {
+		page = NewPage();
+		if( page == NULL ) {
+			return false;
+		}
+		Fits( page, surface->w, surface->h, where );
+	}
+	page = pages.back();
+
+	SDL_Surface *converted = SDL_ConvertSurfaceFormat( surface, SDL_PIXELFORMAT_ARGB8888, 0 );
+	if( converted == NULL ) {
+		LogMsg(WARN, "Could not convert image for the texture atlas: %s", SDL_GetError() );
+		return false;
+	}
+
+	SDL_UpdateTexture( page->texture, where, converted->pixels, converted->pitch );
+	SDL_FreeSurface( converted );
+
+	*texture = page->texture;
+	return true;
+}
+
+/**\brief Reserves space for an image on a page.
+ * \return false if the page is full.
+ */
+bool Atlas::Fits( AtlasPage *page, int w, int h, SDL_Rect *where ) {
+	int paddedW = w + 2 * ATLAS_PADDING;
+	int paddedH = h + 2 * ATLAS_PADDING;
+
+	// Start a new shelf when this one is full
+	if( page->cursorX + paddedW > page->size ) {
+		page->shelfY += page->shelfH;
+		page->shelfH = 0;
+		page->cursorX = 0;
+	}
+
+	if( page->shelfY + paddedH > page->size ) {
+		return false;
+	}
+
+	where->x = page->cursorX + ATLAS_PADDING;
+	where->y = page->shelfY + ATLAS_PADDING;
+	where->w = w;
+	where->h = h;
+
+	page->cursorX += paddedW;
+	if( paddedH > page->shelfH ) {
+		page->shelfH = paddedH;
+	}
+
+	return true;
+}
+
+/**\brief Creates a new empty page.
+ */
+AtlasPage *Atlas::NewPage() {
+	SDL_Texture *texture = SDL_CreateTexture( Video::GetRenderer(), SDL_PIXELFORMAT_ARGB8888,
+	                                          SDL_TEXTUREACCESS_STATIC, pageSize, pageSize );
+	if( texture == NULL ) {
+		LogMsg(WARN, "Could not create a %dx%d texture atlas page: %s", pageSize, pageSize, SDL_GetError() );
+		return NULL;
+	}
+
+	// The contents of new textures are undefined, so clear the padding
+	vector<Uint32> blank( pageSize * pageSize, 0 );
+	SDL_UpdateTexture( texture, NULL, &blank[0], pageSize * sizeof(Uint32) );
+	SDL_SetTextureBlendMode( texture, SDL_BLENDMODE_BLEND );
+
+	AtlasPage *page = new AtlasPage( texture, pageSize );
+	Resource::Account( RESOURCE_TEXTURE, static_cast<Sint64>( pageSize ) * pageSize * 4 );
+	pages.push_back( page );
+
+	LogMsg(INFO, "Created texture atlas page %d (%dx%d)", (int)pages.size(), pageSize, pageSize );
+
+	return page;
+}
+
+/**\brief Destroys all of the pages.
+ * \details Any Image still pointing into the atlas can no longer be drawn.
+ */
+void Atlas::Shutdown() {
+	vector<AtlasPage*>::iterator i;
+	for( i = pages.begin(); i != pages.end(); ++i ) {
+		SDL_DestroyTexture( (*i)->texture );
+		Resource::Account( RESOURCE_TEXTURE, -static_cast<Sint64>( pageSize ) * pageSize * 4 );
+		delete (*i);
+	}
+	pages.clear();
+	pageSize = 0;
+}
+
+/**\fn Atlas::GetPageCount()
+ *  \brief Returns the number of pages created so far.
+ * \fn Atlas::GetPageSize()
+ *  \brief Returns the width and height of each page.
+ */
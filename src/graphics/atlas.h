@@ -0,0 +1,46 @@
+/**\file			atlas.h
+ * \author			Christopher Thielen (chris@epiar.net)
+ * \date			Created: Sunday, October 18, 2026
+ * \date			Modified: Sunday, October 18, 2026
+ * \brief			Packs images into a few large textures
+ * \details
+ */
+
+#ifndef __H_ATLAS__
+#define __H_ATLAS__
+
+#include "includes.h"
+
+// Empty border kept around every image so that filtering doesn't pull in
+// pixels from the neighbouring image
+#define ATLAS_PADDING 1
+
+class AtlasPage {
+	public:
+		AtlasPage( SDL_Texture *_texture, int _size )
+			:texture(_texture), size(_size), shelfY(0), shelfH(0), cursorX(0) {}
+
+		SDL_Texture *texture;
+		int size;
+		int shelfY; ///< Top of the shelf currently being filled
+		int shelfH; ///< Height of the tallest image on that shelf
+		int cursorX; ///< First free column on that shelf
+};
+
+class Atlas {
+	public:
+		static bool Insert( SDL_Surface *surface, SDL_Texture **texture, SDL_Rect *where );
+		static void Shutdown();
+
+		static int GetPageCount() { return pages.size(); }
+		static int GetPageSize() { return pageSize; }
+
+	private:
+		static bool Fits( AtlasPage *page, int w, int h, SDL_Rect *where );
+		static AtlasPage *NewPage();
+
+		static vector<AtlasPage*> pages;
+		static int pageSize;
+};
+
+#endif // __H_ATLAS__
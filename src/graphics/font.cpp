@@ -1,7 +1,7 @@
 /**\file			font.cpp
  * \author			Christopher Thielen (chris@epiar.net)
  * \date			Created: Unknown (2006?)
- * \date			Modified: Saturday, February 13, 2016
+ * \date			Modified: Monday, October 19, 2026
  * \brief
  * \details
  */
@@ -11,20 +11,54 @@
 #include <FTGL/ftgl.h>
 #include "graphics/font.h"
 #include "graphics/video.h"
+#include "graphics/atlas.h"
+#include "graphics/spritebatch.h"
 #include "utilities/log.h"
 #include "utilities/file.h"
 
 /**\class Font
- * \brief Font class takes care of initializing fonts. */
+ * \brief Font class takes care of initializing fonts.
+ * \details Each character is rendered once, in white, into the texture Atlas.
+ *          Strings are drawn as one quad per character through the
+ *          SpriteBatch, tinted with the font color, so many strings can be
+ *          drawn with a single draw call. The layout of recently drawn
+ *          strings is kept in a small least recently used cache.
+ *
+ *          Text may be measured on any thread, but characters are only
+ *          drawn into the Atlas on the render thread, the first time they
+ *          are drawn.
+ */
+
+/**\class Glyph
+ * \brief A rendered character of a Font. */
+
+/**\class TextLayout
+ * \brief The glyphs that make up a string, and their offsets. */
+
+/**\class FontFace
+ * \brief The contents of a font file.
+ * \details Every size of a font is opened from the same copy of the file in
+ *          memory, so each file is only read once.
+ */
+
+/**\class FontSize
+ * \brief A font file opened at one size, with its glyphs and layouts.
+ * \details Fonts are handles that only add a color, so any number of Fonts
+ *          of the same file and size share one FontSize.
+ */
+
+map<string,FontFace*> Font::faces;
+map<string,FontSize*> Font::sizes;
+SDL_mutex* Font::lock = SDL_CreateMutex();
 
 /**\brief Constructs new font (default color white).
  */
-Font::Font():r(1.f),g(1.f),b(1.f),a(1.f),font(NULL),lastRenderedTexture(NULL) {}
+Font::Font():r(1.f),g(1.f),b(1.f),a(1.f),font(NULL),shared(NULL) {}
 
 /**\brief Construct new font based on file.
  * \param filename String containing file.
  */
-Font::Font( string filename, unsigned int size ):r(1.f),g(1.f),b(1.f),a(1.f),font(NULL),lastRenderedTexture(NULL) {
+Font::Font( string filename, unsigned int size ):r(1.f),g(1.f),b(1.f),a(1.f),font(NULL),shared(NULL) {
 	bool success;
 	success = Load( filename, size );
 	assert( success );
@@ -45,7 +79,11 @@ Font* Font::Get( string filename, unsigned int size ) {
 		value = new Font();
 
 		if(value->Load(filename, size)){
-			Resource::Store(filename,(Resource*)value);
+			Font* stored = static_cast<Font*>(Resource::Store(ss.str(),(Resource*)value));
+			if( stored != value ) {
+				delete value;
+				value = stored;
+			}
 		} else {
 			LogMsg(WARN, "Couldn't Find Font '%s'", filename.c_str());
 			delete value;
@@ -58,10 +96,35 @@ Font* Font::Get( string filename, unsigned int size ) {
 
 /**\brief Destroys the font.*/
 Font::~Font() {
-	TTF_CloseFont(font);
+	CloseFace();
+}
+
+/**\brief Stops using the shared font, closing it if this was the last user.
+ */
+void Font::CloseFace( void ) {
+	if( shared == NULL ) {
+		return;
+	}
+
+	if( --shared->users == 0 ) {
+		FontFace *face = shared->face;
+
+		TTF_CloseFont( shared->font );
+		sizes.erase( shared->key );
+		delete shared;
+
+		// The file has to stay in memory for as long as any size is open
+		if( --face->users == 0 ) {
+			faces.erase( face->filename );
+			delete [] face->buffer;
+			delete face;
+		}
+
+		LogMsg(DEBUG, "Font '%s' freed (%d faces, %d sizes still open).", fontname.c_str(), GetFaceCount(), GetSizeCount() );
+	}
+
+	shared = NULL;
 	font = NULL;
-	if(lastRenderedTexture) { SDL_DestroyTexture(lastRenderedTexture); }
-	LogMsg(DEBUG, "Font '%s' freed.", fontname.c_str() );
 }
 
 /**\brief Sets the new color and alpha value.
@@ -86,30 +149,78 @@ void Font::SetColor( float r, float g, float b, float a ) {
  * \param filename Path to font file.
  */
 bool Font::Load( string filename, unsigned int size ) {
-	File fontFile;
+	std::ostringstream ss;
+	FontSize *opened;
 
-	if( fontFile.OpenRead( filename.c_str() ) == false) {
-		LogMsg(ERR, "Font '%s' could not be loaded.", fontname.c_str() );
-		return( false );
-	}
+	ss << filename << "-" << size;
 
 	if( this->font != NULL) {
 		LogMsg(ERR, "Deleting the old font '%s'.\n", fontname.c_str() );
-		TTF_CloseFont(font);
-		font = NULL;
+		CloseFace();
 	}
 
-	fontname = fontFile.GetAbsolutePath();
-	font = TTF_OpenFont( fontname.c_str(), size );
+	map<string,FontSize*>::iterator existing = sizes.find( ss.str() );
+	if( existing != sizes.end() ) {
+		opened = existing->second;
+	} else {
+		FontFace *face;
+		map<string,FontFace*>::iterator file = faces.find( filename );
+
+		if( file != faces.end() ) {
+			face = file->second;
+		} else {
+			File fontFile;
+
+			if( fontFile.OpenRead( filename.c_str() ) == false) {
+				LogMsg(ERR, "Font '%s' could not be loaded.", filename.c_str() );
+				return( false );
+			}
+
+			face = new FontFace();
+			face->filename = filename;
+			face->length = fontFile.GetLength();
+			face->buffer = fontFile.Read();
+			face->users = 0;
+
+			if( face->buffer == NULL ) {
+				LogMsg(ERR, "Font '%s' could not be read.", filename.c_str() );
+				delete face;
+				return( false );
+			}
+		}
 
-	if( font == NULL ) {
-		LogMsg(ERR, "Failed to load font '%s'.\n", fontname.c_str() );
-		return( false );
+		TTF_Font *ttf = TTF_OpenFontRW( SDL_RWFromConstMem( face->buffer, face->length ), 1, size );
+
+		if( ttf == NULL ) {
+			LogMsg(ERR, "Failed to load font '%s'.\n", filename.c_str() );
+			if( face->users == 0 ) {
+				delete [] face->buffer;
+				delete face;
+			}
+			return( false );
+		}
+
+		faces[filename] = face;
+		face->users++;
+
+		opened = new FontSize();
+		opened->key = ss.str();
+		opened->face = face;
+		opened->font = ttf;
+		opened->users = 0;
+		opened->maxLayouts = OPTION( int, "options/video/text-cache" );
+		if( opened->maxLayouts < 1 ) opened->maxLayouts = 1;
+		sizes[opened->key] = opened;
+
+		LogMsg(DEBUG, "Font '%s' loaded at size %d (%d faces, %d sizes open).\n", filename.c_str(), size, GetFaceCount(), GetSizeCount() );
 	}
 
-	this->size = size;
+	opened->users++;
+	shared = opened;
+	font = opened->font;
+	fontname = filename;
 
-	LogMsg(DEBUG, "Font '%s' loaded.\n", fontname.c_str() );
+	this->size = size;
 
 	return( true );
 }
@@ -121,11 +232,11 @@ unsigned int Font::GetSize( void ){
 
 /**\brief Returns the width of the text (no padding).*/
 int Font::TextWidth( const string& text ) {
-	int w, h;
+	SDL_LockMutex( lock );
+	int width = Layout( text ).width;
+	SDL_UnlockMutex( lock );
 
-	TTF_SizeText(font, text.c_str(), &w, &h);
-
-	return w;
+	return width;
 }
 
 /**\brief Returns the recommended line height of the font.
@@ -156,7 +267,24 @@ int Font::Render( int x, int y, const string& text, XPos xpos, YPos ypos ){
 	//int h = this->LineHeight();
 	int h = TTF_FontAscent(font);
 
-	return this->_Render(x, y, text, h, xpos, ypos);
+	return this->_Render(x, y, text, h, xpos, ypos, GetColor());
+}
+
+/**\brief Renders a string with natural padding, in a color of its own.
+ * \details The Font's own color is left alone, so a Font that other code is
+ *          using can be drawn with.
+ * \return The consumed width (This includes a small bit of padding on the right)
+ */
+int Font::Render( int x, int y, const string& text, Color c, XPos xpos, YPos ypos ){
+	int h = TTF_FontAscent(font);
+	SDL_Color color;
+
+	color.r = c.r * 255.;
+	color.g = c.g * 255.;
+	color.b = c.b * 255.;
+	color.a = 255;
+
+	return this->_Render(x, y, text, h, xpos, ypos, color);
 }
 
 /**\brief Renders a string with no padding.
@@ -165,11 +293,23 @@ int Font::Render( int x, int y, const string& text, XPos xpos, YPos ypos ){
 int Font::RenderTight(int x, int y, const string& text, XPos xpos, YPos ypos ){
 	int h = this->TightHeight();
 
-	return this->_Render(x, y, text, h, xpos, ypos);
+	return this->_Render(x, y, text, h, xpos, ypos, GetColor());
+}
+
+/**\brief The Font's color, as the SpriteBatch takes it. */
+SDL_Color Font::GetColor( void ) {
+	SDL_Color color;
+
+	color.r = r * 255.;
+	color.g = g * 255.;
+	color.b = b * 255.;
+	color.a = a * 255.;
+
+	return color;
 }
 
 /**\brief Internal rendering function. Returns the consumed width. */
-int Font::_Render( int x, int y, const string& text, int h, XPos xpos, YPos ypos) {
+int Font::_Render( int x, int y, const string& text, int h, XPos xpos, YPos ypos, SDL_Color color ) {
 	int xn = 0;
 	int yn = 0;
 
@@ -222,63 +362,156 @@ int Font::_Render( int x, int y, const string& text, int h, XPos xpos, YPos ypos
 			assert(0);
 	}
 
-	int ret_w = -1;
-	SDL_Rect rect;
-	SDL_Texture *t = NULL;
+	SDL_LockMutex( lock );
 
-	if(lastRenderedText == text) {
-		assert(lastRenderedTexture != NULL);
+	const TextLayout& layout = Layout( text );
+	vector< pair<Glyph*,int> >::const_iterator i;
 
-		rect.x = xn;
-		rect.y = yn;
-		rect.w = lastRenderedW;
-		rect.h = lastRenderedH;
+	for( i = layout.glyphs.begin(); i != layout.glyphs.end(); ++i ) {
+		Glyph *glyph = i->first;
+		if( !glyph->rendered ) {
+			RenderGlyph( glyph );
+		}
+		if( glyph->texture == NULL ) {
+			continue;
+		}
 
-		t = lastRenderedTexture;
+		SpriteBatch::Draw( glyph->texture, glyph->u0, glyph->v0, glyph->u1, glyph->v1,
+		                   static_cast<float>(xn + i->second), static_cast<float>(yn),
+		                   static_cast<float>(glyph->w), static_cast<float>(glyph->h), 0.f, color );
+	}
 
-		ret_w = rect.w;
-	} else {
-		SDL_Surface *s = NULL;
-		SDL_Color fg;
+	int width = layout.width;
 
-		fg.r = r * 255.;
-		fg.g = g * 255.;
-		fg.b = b * 255.;
-		fg.a = a * 255.;
+	SDL_UnlockMutex( lock );
 
-		s = TTF_RenderUTF8_Blended(font, text.c_str(), fg);
-		if(s == NULL) {
-			LogMsg(ERR, "Could not render '%s'!", text.c_str());
+	return width;
+}
 
-			if(text.length() == 0) {
-				LogMsg(ERR, "Text length should not be zero.");
-			}
+/**\brief Decodes the next character of a UTF-8 string.
+ * \details Characters outside of the Basic Multilingual Plane, which SDL_ttf
+ *          can't render as single glyphs, and malformed bytes become '?'.
+ */
+static Uint16 NextCharacter( const string& text, string::size_type &pos ) {
+	unsigned char c = text[pos++];
+	Uint32 ch;
+	int extra;
+
+	if( c < 0x80 ) {
+		return c;
+	} else if( (c & 0xE0) == 0xC0 ) {
+		ch = c & 0x1F;
+		extra = 1;
+	} else if( (c & 0xF0) == 0xE0 ) {
+		ch = c & 0x0F;
+		extra = 2;
+	} else {
+		// Skip the rest of a four byte sequence, or a stray continuation byte
+		while( pos < text.length() && (text[pos] & 0xC0) == 0x80 ) pos++;
+		return '?';
+	}
 
-			return 0;
+	for( ; extra > 0; extra-- ) {
+		if( pos >= text.length() || (text[pos] & 0xC0) != 0x80 ) {
+			return '?';
 		}
+		ch = (ch << 6) | (text[pos++] & 0x3F);
+	}
+
+	return static_cast<Uint16>( ch );
+}
 
-		rect.x = xn;
-		rect.y = yn;
-		rect.w = s->w;
-		rect.h = s->h;
+/**\brief Returns a character, measuring it the first time.
+ * \details The character is also rendered into the Atlas if this is the
+ *          render thread; otherwise that waits until it is first drawn.
+ */
+Glyph* Font::GetGlyph( Uint16 ch ) {
+	map<Uint16,Glyph>::iterator found = shared->glyphs.find( ch );
+	if( found != shared->glyphs.end() ) {
+		return &found->second;
+	}
 
-		t = SDL_CreateTextureFromSurface(Video::GetRenderer(), s);
+	Glyph &glyph = shared->glyphs[ch];
+	glyph.ch = ch;
+	glyph.rendered = false;
+	glyph.texture = NULL;
+	glyph.u0 = glyph.v0 = glyph.u1 = glyph.v1 = 0.f;
+	glyph.w = glyph.h = 0;
 
-		ret_w = s->w;
-		lastRenderedW = s->w;
-		lastRenderedH = s->h;
+	int minx, maxx, miny, maxy;
+	if( TTF_GlyphMetrics( font, ch, &minx, &maxx, &miny, &maxy, &glyph.advance ) != 0 ) {
+		glyph.advance = 0;
+	}
 
-		SDL_FreeSurface(s);
+	if( Video::IsRenderThread() ) {
+		RenderGlyph( &glyph );
+	}
 
-		if(lastRenderedTexture) { SDL_DestroyTexture(lastRenderedTexture); }
-		lastRenderedTexture = t;
-		lastRenderedText = text;
+	return &glyph;
+}
+
+/**\brief Renders a character into the Atlas.
+ */
+void Font::RenderGlyph( Glyph* glyph ) {
+	glyph->rendered = true;
+
+	// Render the character as a one character string so that it is placed
+	// within its box the same way as it would be in a whole line of text.
+	Uint16 str[2] = { glyph->ch, 0 };
+	SDL_Color white = { 255, 255, 255, 255 };
+	SDL_Surface *s = TTF_RenderUNICODE_Blended( font, str, white );
+	if( s == NULL ) {
+		return;
 	}
 
-	SDL_RenderCopy(Video::GetRenderer(), t, NULL, &rect);
+	SDL_Rect region;
+	if( Atlas::Insert( s, &glyph->texture, &region ) ) {
+		float pageSize = static_cast<float>( Atlas::GetPageSize() );
+
+		glyph->u0 = region.x / pageSize;
+		glyph->v0 = region.y / pageSize;
+		glyph->u1 = (region.x + region.w) / pageSize;
+		glyph->v1 = (region.y + region.h) / pageSize;
+		glyph->w = s->w;
+		glyph->h = s->h;
+	} else {
+		LogMsg(WARN, "Could not add character %d of font '%s' to the texture atlas.", glyph->ch, fontname.c_str() );
+		glyph->texture = NULL;
+	}
 
-	//cout << "rendered '" << text << "' at " << xn << ", " << yn << " with color " << r << ", " << g << ", " << b << ", " << a << endl;
+	SDL_FreeSurface( s );
+}
+
+/**\brief Returns where each character of a string goes.
+ */
+const TextLayout& Font::Layout( const string& text ) {
+	map<string, list< pair<string,TextLayout> >::iterator>::iterator found = shared->layoutIndex.find( text );
+	if( found != shared->layoutIndex.end() ) {
+		// Move it to the front of the list
+		shared->layouts.splice( shared->layouts.begin(), shared->layouts, found->second );
+		return found->second->second;
+	}
+
+	shared->layouts.push_front( make_pair( text, TextLayout() ) );
+	shared->layoutIndex[text] = shared->layouts.begin();
+
+	TextLayout &layout = shared->layouts.front().second;
+	string::size_type pos = 0;
+	int pen = 0;
+
+	while( pos < text.length() ) {
+		Glyph *glyph = GetGlyph( NextCharacter( text, pos ) );
+		layout.glyphs.push_back( make_pair( glyph, pen ) );
+		pen += glyph->advance;
+	}
+	layout.width = pen;
+
+	// Forget the least recently drawn string
+	if( shared->layouts.size() > shared->maxLayouts ) {
+		shared->layoutIndex.erase( shared->layouts.back().first );
+		shared->layouts.pop_back();
+	}
 
-	return ret_w;
+	return layout;
 }
 
@@ -1,7 +1,7 @@
 /**\file			font.h
  * \author			Christopher Thielen (chris@epiar.net)
  * \date			Created: Unknown (2006?)
- * \date			Modified: Saturday, February 13, 2016
+ * \date			Modified: Monday, October 19, 2026
  * \brief
  * \details
  */
@@ -13,6 +13,47 @@
 #include "graphics/video.h"
 #include "utilities/resource.h"
 
+// A single character, stored in the texture Atlas
+class Glyph {
+	public:
+		Uint16 ch;
+		bool rendered; // false until the character has been drawn into the Atlas
+		SDL_Texture *texture; // NULL for glyphs that couldn't be rendered
+		float u0, v0, u1, v1;
+		int w, h;
+		int advance; // distance to the start of the next glyph
+};
+
+// Where each glyph of a string goes, relative to the start of the string
+class TextLayout {
+	public:
+		vector< pair<Glyph*,int> > glyphs;
+		int width;
+};
+
+// A font file, read into memory once and shared by every size
+class FontFace {
+	public:
+		string filename;
+		char *buffer;
+		long length;
+		int users; // number of FontSizes using this file
+};
+
+// A font file opened at one size, shared by every Font of that size
+class FontSize {
+	public:
+		string key; // filename + "-" + size
+		FontFace *face;
+		TTF_Font *font;
+		int users; // number of Fonts using this size
+
+		map<Uint16,Glyph> glyphs; // every glyph rendered so far
+		list< pair<string,TextLayout> > layouts; // recently drawn strings, most recent first
+		map<string, list< pair<string,TextLayout> >::iterator> layoutIndex;
+		unsigned int maxLayouts;
+};
+
 class Font : public Resource {
 		public:
 			enum XPos {
@@ -32,6 +73,9 @@ class Font : public Resource {
 
 			static Font* Get(string filename, unsigned int size);
 
+			static int GetFaceCount( void ) { return faces.size(); }
+			static int GetSizeCount( void ) { return sizes.size(); }
+
 			bool Load( string filename, unsigned int size );
 
 			unsigned int GetSize( void );
@@ -43,19 +87,29 @@ class Font : public Resource {
 			int TightHeight( void );
 
 			int Render( int x, int y, const string& text, XPos xpos = LEFT, YPos ypos = TOP );
+			int Render( int x, int y, const string& text, Color c, XPos xpos = LEFT, YPos ypos = TOP );
 			int RenderTight( int x, int y, const string& text, XPos xpos = LEFT, YPos ypos = TOP );
 
 		private:
-			int _Render( int x, int y, const string& text, int h, XPos xpos, YPos ypos);
+			int _Render( int x, int y, const string& text, int h, XPos xpos, YPos ypos, SDL_Color color );
+			SDL_Color GetColor( void );
+
+			Glyph* GetGlyph( Uint16 ch );
+			void RenderGlyph( Glyph* glyph );
+			const TextLayout& Layout( const string& text );
 
 			string fontname; // filename of the loaded font
 			float r, g, b, a; // color of text
 			unsigned int size;
 
-			TTF_Font* font;
-			SDL_Texture* lastRenderedTexture; // cache of last rendered texture
-			string lastRenderedText;
-			int lastRenderedW, lastRenderedH;
+			void CloseFace( void ); // not Release, which is Resource::Acquire's pair
+
+			TTF_Font* font; // shortcut to shared->font
+			FontSize* shared;
+
+			static map<string,FontFace*> faces; // every open font file, by filename
+			static map<string,FontSize*> sizes; // every open font size, by filename + "-" + size
+			static SDL_mutex* lock; // guards the glyphs and layouts, text is measured by the logic thread too
 };
 
 #endif // H_FONT
@@ -1,7 +1,7 @@
 /**\file			image.cpp
  * \author			Christopher Thielen (chris@epiar.net)
  * \date			Created: Saturday, January 31, 2009
- * \date			Modified: Sunday, January 3, 2016
+ * \date			Modified: Monday, October 19, 2026
  * \brief			Image loading and display
  * \details
  * See this note section in image.h for an important clarification about the handling
@@ -10,20 +10,86 @@
  */
 
 #include "includes.h"
+#include "common.h"
 #include "graphics/image.h"
+#include "graphics/atlas.h"
+#include "graphics/spritebatch.h"
 #include "graphics/video.h"
 #include "utilities/file.h"
+#include "utilities/loader.h"
 #include "utilities/log.h"
 #include "utilities/trig.h"
 
 /**\class Image
  * \brief Image handling. */
 
+/**\class ImageJob
+ * \brief Reads and decodes an Image for the Loader. */
+class ImageJob : public LoadJob {
+	public:
+		ImageJob( Image *_image, const string& _filename )
+			:image(_image), filename(_filename), surface(NULL) {}
+
+		void Run( void ) {
+			File file;
+
+			if( file.OpenRead( filename ) ) {
+				const char *buffer = file.Map();
+				if( buffer != NULL ) {
+					surface = Image::Decode( buffer, file.GetLength() );
+				}
+			}
+		}
+
+		void Finish( void ) {
+			image->loading = NULL;
+
+			if( surface != NULL ) {
+				image->Load( surface );
+			} else {
+				LogMsg(WARN, "Couldn't load Image '%s'", filename.c_str() );
+			}
+		}
+
+	private:
+		Image *image;
+		string filename;
+		SDL_Surface *surface;
+};
+
+/**\class BindJob
+ * \brief Reads the size of a deferred Image for the Loader, which then
+ *        queues the ImageJob for its pixels. */
+class BindJob : public LoadJob {
+	public:
+		BindJob( Image *_image ) :image(_image) {}
+
+		void Run( void ) {
+			image->BindNow();
+		}
+
+		void Finish( void ) {}
+
+	private:
+		Image *image;
+};
+
+SDL_mutex* Image::bindLock = SDL_CreateMutex();
+SDL_cond* Image::bindDone = SDL_CreateCond();
+
 /**\brief Constructor, initialize default values
  */
 Image::Image() {
 	w = h = real_w = real_h = 0;
 	image = NULL;
+	pending = NULL;
+	loading = NULL;
+	parent = NULL;
+	evicted = false;
+	SDL_AtomicSet( &binding, IMAGE_BOUND );
+	inAtlas = false;
+	u0 = v0 = 0.f;
+	u1 = v1 = 1.f;
 	scale_w = scale_h = 1.;
 	filepath = "";
 }
@@ -33,6 +99,14 @@ Image::Image() {
 Image::Image( const string& filename ) {
 	w = h = real_w = real_h = 0;
 	image = NULL;
+	pending = NULL;
+	loading = NULL;
+	parent = NULL;
+	evicted = false;
+	SDL_AtomicSet( &binding, IMAGE_BOUND );
+	inAtlas = false;
+	u0 = v0 = 0.f;
+	u1 = v1 = 1.f;
 	scale_w = scale_h = 1.;
 	filepath = "";
 
@@ -48,18 +122,39 @@ Image::Image( SDL_Texture* texture, int w, int h ) {
 	filepath = "";
 
 	image = texture;
+	pending = NULL;
+	loading = NULL;
+	parent = NULL;
+	evicted = false;
+	SDL_AtomicSet( &binding, IMAGE_BOUND );
+	inAtlas = false;
+	u0 = v0 = 0.f;
+	u1 = v1 = 1.f;
+
+	SetBytes( RESOURCE_TEXTURE, static_cast<Sint64>( w ) * h * 4 );
 }
 
 /**\brief Deallocate allocations
  */
 Image::~Image() {
-	if ( image ) {
+	if( loading ) {
+		Loader::Wait( loading );
+	}
+
+	if ( image && !inAtlas ) {
 		SDL_DestroyTexture( image );
 		image = NULL;
 	}
+
+	if( pending ) {
+		SDL_FreeSurface( pending );
+		pending = NULL;
+	}
 }
 
 /**\brief Lazy fetch an Image
+ * \details The pixels are loaded by the Loader, so the Image may not have
+ *          anything to draw yet. Its size is known right away.
  */
 Image* Image::Get( string filename ) {
 	Image* value = NULL;
@@ -68,8 +163,13 @@ Image* Image::Get( string filename ) {
 	if( value == NULL ) {
 		value = new Image();
 
-		if(value->Load(filename)) {
-			Resource::Store(filename, (Resource*)value);
+		if(value->LoadAsync(filename)) {
+			Image* stored = static_cast<Image*>(Resource::Store(filename, (Resource*)value));
+			if( stored != value ) {
+				// Another thread loaded it meanwhile
+				delete value;
+				value = stored;
+			}
 		} else {
 			LogMsg(DEBUG, "Couldn't Find Image '%s'", filename.c_str());
 			delete value;
@@ -80,10 +180,81 @@ Image* Image::Get( string filename ) {
 	return value;
 }
 
+/**\brief Gets an Image without loading it until it is first needed
+ * \details Only the path is looked up now. The file is read the first time
+ *          that the Image is drawn, measured or prefetched, so Components
+ *          only cost memory for what is actually used. With
+ *          "options/memory/lazy-assets" off, this is the same as Get.
+ */
+Image* Image::Defer( const string& filename ) {
+	Image* value = NULL;
+
+	if( !OPTION( bool, "options/memory/lazy-assets" ) ) {
+		return Get( filename );
+	}
+
+	value = static_cast<Image*>(Resource::Get(filename));
+
+	if( value == NULL ) {
+		if( !File::Exists( filename ) ) {
+			LogMsg(DEBUG, "Couldn't Find Image '%s'", filename.c_str());
+			return NULL;
+		}
+
+		value = new Image();
+		value->filepath = filename;
+		SDL_AtomicSet( &value->binding, IMAGE_DEFERRED );
+
+		Image* stored = static_cast<Image*>(Resource::Store(filename, (Resource*)value));
+		if( stored != value ) {
+			delete value;
+			value = stored;
+		}
+	}
+
+	return value;
+}
+
+/**\brief Reads the size of a deferred Image, and starts loading its pixels
+ * \details The logic thread may measure an Image while the render thread
+ *          draws it, so only one of them reads the file and the other waits
+ *          until the size is known.
+ */
+void Image::BindNow( void ) {
+	if( SDL_AtomicCAS( &binding, IMAGE_DEFERRED, IMAGE_BINDING ) ) {
+		if( !LoadAsync( filepath ) ) {
+			LogMsg(WARN, "Couldn't load Image '%s'", filepath.c_str() );
+		}
+
+		SDL_LockMutex( bindLock );
+		SDL_AtomicSet( &binding, IMAGE_BOUND );
+		SDL_CondBroadcast( bindDone );
+		SDL_UnlockMutex( bindLock );
+		return;
+	}
+
+	SDL_LockMutex( bindLock );
+	while( SDL_AtomicGet( &binding ) == IMAGE_BINDING ) {
+		SDL_CondWait( bindDone, bindLock );
+	}
+	SDL_UnlockMutex( bindLock );
+}
+
+/**\brief Starts loading a deferred Image without waiting for it
+ * \details Even reading the size means opening the file, so that is left to
+ *          the Loader's threads too. Measuring or drawing the Image before
+ *          then binds it right away, as usual.
+ */
+void Image::Prefetch( void ) {
+	if( SDL_AtomicGet( &binding ) == IMAGE_DEFERRED ) {
+		Loader::Queue( new BindJob( this ) );
+	}
+}
+
 /**\brief Load image from file
  */
 bool Image::Load( const string& filename ) {
-	File file = File();
+	File file;
 
 	if( filename == "" ) {
 		return false; // No File to load.
@@ -93,7 +264,7 @@ bool Image::Load( const string& filename ) {
 		return false; // File could not be opened or found.
 	}
 
-	char* buffer = file.Read();
+	const char* buffer = file.Map();
 	int bytesread = file.GetLength();
 
 	if ( buffer == NULL ) {
@@ -101,7 +272,6 @@ bool Image::Load( const string& filename ) {
 	}
 
 	int retval = Load( buffer, bytesread );
-	delete [] buffer;
 
 	if ( retval ) {
 		filepath = filename;
@@ -111,25 +281,256 @@ bool Image::Load( const string& filename ) {
 	return false; // Image could not be loaded.
 }
 
-/**\brief Load image from buffer
+/**\brief Start loading an image file
+ * \details A PNG file says how big it is in its first few bytes, so only
+ *          those are read now and the rest is left to the Loader. Other
+ *          files are loaded right away.
  */
-bool Image::Load( char *buf, int bufSize ) {
+bool Image::LoadAsync( const string& filename ) {
+	File file;
+	unsigned char header[24];
+
+	if( filename == "" ) {
+		return false; // No File to load.
+	}
+
+	if( !file.OpenRead(filename ) ) {
+		return false; // File could not be opened or found.
+	}
+
+	if( file.GetLength() < 24 || !file.Read( 24, (char*)header )
+	    || memcmp( header, "\x89PNG\r\n\x1a\n", 8 ) != 0
+	    || memcmp( header + 12, "IHDR", 4 ) != 0 ) {
+		file.Close();
+		return Load( filename );
+	}
+	file.Close();
+
+	w = real_w = (header[16] << 24) | (header[17] << 16) | (header[18] << 8) | header[19];
+	h = real_h = (header[20] << 24) | (header[21] << 16) | (header[22] << 8) | header[23];
+	filepath = filename;
+
+	loading = new ImageJob( this, filename );
+	Loader::Queue( loading );
+
+	return true;
+}
+
+/**\brief Decode an image file into pixels
+ * \details This doesn't touch the renderer, so any thread can use it.
+ */
+SDL_Surface* Image::Decode( const char *buf, int bufSize ) {
 	SDL_RWops *rw;
+	SDL_Surface *surface;
 
-	rw = SDL_RWFromMem( buf, bufSize );
+	rw = SDL_RWFromConstMem( buf, bufSize );
 	if( rw == NULL ) {
 		LogMsg(WARN, "Image loading failed. Could not create RWops" );
-		return( false );
+		return( NULL );
 	}
 
-	image = IMG_LoadTexture_RW( Video::GetRenderer(), rw, 0 );
+	surface = IMG_Load_RW( rw, 0 );
 	SDL_FreeRW(rw);
-	if( image == NULL ) {
+	if( surface == NULL ) {
 		LogMsg(WARN, "Failed to load image from buffer" );
+		return( NULL );
+	}
+
+	return( surface );
+}
+
+/**\brief Load image from buffer
+ */
+bool Image::Load( const char *buf, int bufSize ) {
+	SDL_Surface *surface = Decode( buf, bufSize );
+
+	if( surface == NULL ) {
 		return( false );
 	}
 
-	SDL_QueryTexture(image, NULL, NULL, &w, &h);
+	return( Load( surface ) );
+}
+
+/**\brief Load image from decoded pixels
+ * \details Textures can only be made on the thread that owns the renderer.
+ *          Images loaded anywhere else keep their pixels until they are
+ *          first drawn. The renderer may be drawing this Image meanwhile,
+ *          so the pixels are handed over atomically.
+ */
+bool Image::Load( SDL_Surface *surface ) {
+	SDL_Surface *old;
+
+	w = real_w = surface->w;
+	h = real_h = surface->h;
+
+	old = static_cast<SDL_Surface*>( SDL_AtomicSetPtr( (void**)&pending, surface ) );
+	if( old ) {
+		SDL_FreeSurface( old );
+	}
+
+	if( !Video::IsRenderThread() ) {
+		return( true );
+	}
+
+	return( Upload() );
+}
+
+/**\brief Use part of another Image
+ * \details The sheet keeps the pixels; this Image only draws a region of
+ *          its texture, so a whole sprite sheet is uploaded only once.
+ */
+bool Image::Load( Image *sheet, const SDL_Rect& region ) {
+	parent = sheet;
+	this->region = region;
+
+	w = real_w = region.w;
+	h = real_h = region.h;
+
+	return( true );
+}
+
+/**\brief Points this Image at its parent's texture
+ * \details The parent may itself be in the Atlas, so the region is taken
+ *          relative to the parent's own part of the texture.
+ */
+bool Image::Share( void ) {
+	if( SDL_AtomicGetPtr( (void**)&parent->pending ) ) {
+		parent->Upload();
+	}
+
+	if( parent->image == NULL ) {
+		return( false );
+	}
+
+	// The parent's UVs span its whole canvas, which may have been expanded
+	float du = ( parent->u1 - parent->u0 ) / parent->real_w;
+	float dv = ( parent->v1 - parent->v0 ) / parent->real_h;
+
+	u0 = parent->u0 + du * region.x;
+	v0 = parent->v0 + dv * region.y;
+	u1 = parent->u0 + du * ( region.x + region.w );
+	v1 = parent->v0 + dv * ( region.y + region.h );
+
+	inAtlas = true; // The parent owns the texture
+	image = parent->image;
+
+	return( true );
+}
+
+/**\brief Creates the texture for the pending pixels
+ * \details Small images are copied into the texture Atlas so that they can
+ *          be batched with each other; anything else gets its own texture.
+ */
+bool Image::Upload( void ) {
+	SDL_Surface *surface = static_cast<SDL_Surface*>( SDL_AtomicSetPtr( (void**)&pending, NULL ) );
+	SDL_Rect region;
+
+	if( surface == NULL ) {
+		return( image != NULL );
+	}
+
+	// Large images would crowd out everything else
+	int largest = OPTION( int, "options/video/atlas-max-image" );
+	bool atlas = OPTION( bool, "options/video/atlas" ) && (w <= largest) && (h <= largest);
+
+	if( atlas && Atlas::Insert( surface, &image, &region ) ) {
+		float size = static_cast<float>( Atlas::GetPageSize() );
+
+		// The Atlas pages are counted instead
+		SetBytes( RESOURCE_TEXTURE, 0 );
+
+		inAtlas = true;
+		u0 = region.x / size;
+		v0 = region.y / size;
+		u1 = (region.x + region.w) / size;
+		v1 = (region.y + region.h) / size;
+	} else {
+		image = SDL_CreateTextureFromSurface( Video::GetRenderer(), surface );
+		inAtlas = false;
+		u0 = v0 = 0.f;
+		u1 = v1 = 1.f;
+
+		SetBytes( RESOURCE_TEXTURE, image ? static_cast<Sint64>( surface->w ) * surface->h * 4 : 0 );
+	}
+
+	SDL_FreeSurface( surface );
+
+	if( image == NULL ) {
+		LogMsg(WARN, "Failed to create a texture for image: %s", SDL_GetError() );
+		return( false );
+	}
+
+	return( true );
+}
+
+/**\brief Gets the texture ready to be drawn
+ * \details Uploads pixels that have been loaded, and starts loading the
+ *          image again if it was evicted. Images that are still loading are
+ *          simply not drawn yet.
+ * \return true if there is a texture to draw
+ */
+bool Image::Ready( void ) {
+	Touch();
+	Bind();
+
+	if( SDL_AtomicGetPtr( (void**)&pending ) ) {
+		Upload();
+	}
+
+	if( image == NULL && parent != NULL ) {
+		Share();
+	}
+
+	if( image == NULL && evicted && loading == NULL ) {
+		evicted = false;
+		CountReload();
+		LoadAsync( filepath );
+	}
+
+	if( image == NULL ) {
+		if( loading == NULL ) {
+			LogMsg(WARN, "Trying to draw without loading an image first." );
+		}
+		return( false );
+	}
+
+	return( true );
+}
+
+/**\brief Destroys the texture, which is loaded again the next time it is drawn
+ * \details Only Images with their own texture and file can be evicted.
+ * \sa Resource::Trim
+ */
+bool Image::Evict( void ) {
+	if( image == NULL || inAtlas || parent != NULL || loading != NULL
+	    || filepath.empty() || SDL_AtomicGetPtr( (void**)&pending ) ) {
+		return( false );
+	}
+
+	SDL_DestroyTexture( image );
+	image = NULL;
+	evicted = true;
+	SetBytes( RESOURCE_TEXTURE, 0 );
+
+	return( true );
+}
+
+/**\brief Gets the texture ready, and says which part of it holds this Image
+ * \details This is for drawing the Image later without touching it, such as
+ *          from a Snapshot while the logic thread runs. The texture stays
+ *          valid until the next Resource::Trim.
+ * \return false if there is no texture to draw yet
+ */
+bool Image::GetQuad( SDL_Texture **texture, float *u0, float *v0, float *u1, float *v1 ) {
+	if( !Ready() ) {
+		return( false );
+	}
+
+	*texture = image;
+	*u0 = this->u0;
+	*v0 = this->v0;
+	*u1 = this->u1;
+	*v1 = this->v1;
 
 	return( true );
 }
@@ -149,25 +550,16 @@ void Image::DrawAlpha( int x, int y, float alpha ) {
 /**\brief Draw the image (angle is in degrees)
  */
 void Image::_Draw( int x, int y, float r, float g, float b, float alpha, float angle, float resize_ratio_w, float resize_ratio_h) {
-	if( image == NULL ) {
-		LogMsg(WARN, "Trying to draw without loading an image first." );
+	if( !Ready() ) {
 		return;
 	}
 
-	SDL_Rect dest;
-
-	dest.x = x;
-	dest.y = y;
-	dest.w = w * resize_ratio_w;
-	dest.h = h * resize_ratio_h;
-
-	SDL_SetTextureAlphaMod(image, alpha * 255.);
-	// Use the negative of the angle as SDL_RenderCopyEx rotates clockwise while our system uses
-	// the mathematical unit circle system which rotates counter-clockwise
-	// This ensures that e.g. a 90 degree rotation means rotation 90 degrees counter-clockwise,
-	// and that any sprites with an angle of 0 will point to the right, 90 points to the top of the
-	// screen, etc.
-	SDL_RenderCopyEx(Video::GetRenderer(), image, NULL, &dest, -angle, NULL, SDL_FLIP_NONE );
+	// Our angles follow the mathematical unit circle and rotate counter-clockwise,
+	// so any sprites with an angle of 0 will point to the right, 90 points to the
+	// top of the screen, etc.
+	SpriteBatch::Draw( image, u0, v0, u1, v1,
+	                   static_cast<float>(x), static_cast<float>(y),
+	                   w * resize_ratio_w, h * resize_ratio_h, angle, alpha );
 }
 
 /**\brief Draw the image centered on (x,y)
@@ -177,7 +569,7 @@ void Image::DrawCentered( int x, int y, float angle ) {
 }
 
 void Image::DrawCentered( int x, int y, float angle, float alpha ) {
-	_Draw( x - (w / 2), y - (h / 2), 1.f, 1.f, 1.f, 1.f, angle, alpha );
+	_Draw( x - (w / 2), y - (h / 2), 1.f, 1.f, 1.f, alpha, angle );
 }
 
 /**\brief Draw the image stretched within to a box
@@ -210,8 +602,7 @@ void Image::DrawFit( int x, int y, int box_w, int box_h, float angle ) {
 /**\brief Draw the image tiled to fill a rectangle of w/h - will crop to meet w/h and won't overflow
  */
 void Image::DrawTiled( int x, int y, int fill_w, int fill_h, float alpha ) {
-	if( image == NULL ) {
-		LogMsg(WARN, "Trying to draw without loading an image first." );
+	if( !Ready() ) {
 		return;
 	}
 
@@ -219,19 +610,13 @@ void Image::DrawTiled( int x, int y, int fill_w, int fill_h, float alpha ) {
 
 	for( int j = 0; j < fill_h; j += h) {
 		for( int i = 0; i < fill_w; i += w) {
-			SDL_Rect src, dest;
-
-			src.x = 0;
-			src.y = 0;
-			src.w = fill_w < w ? fill_w : w;
-			src.h = fill_h < h ? fill_h : h;
-			dest.x = x + i;
-			dest.y = y + j;
-			dest.w = fill_w < w ? fill_w : w;
-			dest.h = fill_h < h ? fill_h : h;
-
-			SDL_SetTextureAlphaMod(image, alpha * 255.);
-			SDL_RenderCopyEx(Video::GetRenderer(), image, &src, &dest, 0., NULL, SDL_FLIP_NONE );
+			int tile_w = fill_w < w ? fill_w : w;
+			int tile_h = fill_h < h ? fill_h : h;
+
+			SpriteBatch::Draw( image, u0, v0,
+			                   u0 + (u1 - u0) * tile_w / w, v0 + (v1 - v0) * tile_h / h,
+			                   static_cast<float>(x + i), static_cast<float>(y + j),
+			                   static_cast<float>(tile_w), static_cast<float>(tile_h), 0.f, alpha );
 		}
 	}
 
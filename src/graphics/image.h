@@ -1,7 +1,7 @@
 /**\file			image.h
  * \author			Christopher Thielen (chris@epiar.net)
  * \date			Created: Saturday, January 31, 2009
- * \date			Modified: Friday, January 1, 2016
+ * \date			Modified: Monday, October 19, 2026
  * \brief			Image loading and display
  * \details
  * You don't have to worry about OpenGL's power of 2 image dimension requirements.
@@ -22,6 +22,13 @@
 #include "includes.h"
 #include "utilities/resource.h"
 
+class LoadJob;
+
+// Whether an Image from Defer has looked at its file yet
+#define IMAGE_BOUND    0
+#define IMAGE_DEFERRED 1
+#define IMAGE_BINDING  2
+
 class Image : public Resource {
 	public:
 		Image();
@@ -32,17 +39,32 @@ class Image : public Resource {
 		~Image();
 
 		static Image* Get(string filename);
+		// Get an Image that isn't loaded until it is first needed
+		static Image* Defer( const string& filename );
 
 		// Load image from file
 		bool Load( const string& filename );
 		// Load image from buffer
-		bool Load( char *buf, int bufSize );
+		bool Load( const char *buf, int bufSize );
+		// Load image from decoded pixels, which the Image then owns
+		bool Load( SDL_Surface *surface );
+		// Use part of another Image, such as a frame of a sprite sheet
+		bool Load( Image *sheet, const SDL_Rect& region );
+
+		// Decode an image file, on any thread
+		static SDL_Surface* Decode( const char *buf, int bufSize );
+
+		// Is the Loader still working on the pixels?
+		bool IsLoading( void ) { return loading != NULL; }
 
 		// Get information about image dimensions (always the virtual/effective size)
-		int GetWidth( void ) { return w; };
-		int GetHeight( void ) { return h; };
-		int GetHalfWidth( void ) { return w / 2; };
-		int GetHalfHeight( void ) { return h / 2; };
+		int GetWidth( void ) { Bind(); return w; };
+		int GetHeight( void ) { Bind(); return h; };
+		int GetHalfWidth( void ) { Bind(); return w / 2; };
+		int GetHalfHeight( void ) { Bind(); return h / 2; };
+
+		// Start loading the image on the Loader's threads, if it was deferred
+		void Prefetch( void );
 
 		// Draw the image (angle in degrees)
 		void Draw( int x, int y, float angle = 0.f );
@@ -58,11 +80,32 @@ class Image : public Resource {
 		// Draw the image within a box but not stretched
 		void DrawFit( int x, int y, int w, int h, float angle = 0. );
 
+		// Get the texture ready, and say which part of it to draw
+		bool GetQuad( SDL_Texture **texture, float *u0, float *v0, float *u1, float *v1 );
+
 		string GetPath(){return filepath;}
 
+	protected:
+		bool Evict( void );
+
 	private:
 		// Draw the image (angle in degrees)
 		void _Draw( int x, int y, float r, float g, float b, float alpha = 1.f, float angle = 0.f, float resize_ratio_w = 1.f, float resize_ratio_h = 1.f );
+		// Turn the loaded pixels into a texture
+		bool Upload( void );
+		// Use the parent's texture, once it has one
+		bool Share( void );
+		// Get the texture ready to be drawn
+		bool Ready( void );
+		// Start loading the image on the Loader's threads
+		bool LoadAsync( const string& filename );
+		// Look at the file of a deferred Image
+		void Bind( void ) {
+			if( SDL_AtomicGet( &binding ) != IMAGE_BOUND ) {
+				BindNow();
+			}
+		}
+		void BindNow( void );
 
 		int w, h; // virtual w/h (effective, same as original file)
 		int real_w, real_h; // real w/h, size of expanded canvas (image) should expansion be needed
@@ -71,8 +114,21 @@ class Image : public Resource {
 		                        // the larger canvas actually contains the original image (<= 1.0)
 		                        // defaults = 1.0, this factor is always used, so non-expanded images are
 		                        // simply "scaled" at 1.0. THIS HAS NOTHING TO DO WITH RESIZE()
-		SDL_Texture* image;
+		SDL_Texture* image; // either owned by this Image, or a page of the Atlas
+		bool inAtlas; // true when image is shared with other Images
+		float u0, v0, u1, v1; // the part of image that holds this Image, from 0.0 to 1.0
+		SDL_Surface* pending; // pixels loaded off the render thread, waiting for Upload()
+		LoadJob* loading; // the Loader's job for this Image, until it is finished
+		Image* parent; // the Image that this is a part of, if any
+		bool evicted; // the texture was let go by Resource::Trim, and is loaded again when drawn
+		SDL_atomic_t binding; // IMAGE_DEFERRED until the file is first needed
+		static SDL_mutex* bindLock; // guards waiting for another thread to bind an Image
+		static SDL_cond* bindDone; // signalled whenever an Image has been bound
+		SDL_Rect region; // the part of parent that holds this Image, in pixels
 		string filepath;
+
+		friend class ImageJob;
+		friend class BindJob;
 };
 
 #endif // __H_IMAGE__
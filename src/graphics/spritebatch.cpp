@@ -0,0 +1,141 @@
+/**\file			spritebatch.cpp
+ * \author			Christopher Thielen (chris@epiar.net)
+ * \date			Created: Sunday, October 18, 2026
+ * \date			Modified: Sunday, October 18, 2026
+ * \brief			Queues textured quads and draws them together
+ * \details
+ */
+
+#include "includes.h"
+#include "common.h"
+#include "graphics/spritebatch.h"
+#include "graphics/video.h"
+#include "utilities/log.h"
+
+/**\class SpriteBatch
+ * \brief Batched sprite renderer.
+ * \details Quads are queued until a quad with a different texture arrives,
+ *          then all of the queued quads are drawn with one
+ *          SDL_RenderGeometry call. Since most images share a few Atlas
+ *          pages, the number of draw calls follows the number of pages in
+ *          use rather than the number of sprites.
+ *
+ *          Quads are never reordered, so overlapping sprites are drawn in
+ *          the same order as before. Video's recorded primitives are drawn
+ *          before the first quad is queued and Video draws the quads before
+ *          recording a primitive, so at most one of the two is ever
+ *          waiting. Anything else that draws to the renderer must call
+ *          Video::Flush() first.
+ * \see Atlas
+ */
+
+SDL_Texture *SpriteBatch::current = NULL;
+vector<SDL_Vertex> SpriteBatch::vertices;
+vector<int> SpriteBatch::indices;
+int SpriteBatch::flushes = 0;
+int SpriteBatch::sprites = 0;
+int SpriteBatch::lastFlushes = 0;
+int SpriteBatch::lastSprites = 0;
+
+/**\brief Queues a quad.
+ * \param texture Texture to draw from.
+ * \param u0,v0,u1,v1 Area of the texture to draw, from 0.0 to 1.0.
+ * \param x,y Top left corner of the quad before it is rotated.
+ * \param w,h Size of the quad on screen.
+ * \param angle Counter-clockwise rotation about the center, in degrees.
+ * \param alpha Opacity, from 0.0 to 1.0.
+ */
+void SpriteBatch::Draw( SDL_Texture *texture, float u0, float v0, float u1, float v1,
+                        float x, float y, float w, float h, float angle, float alpha ) {
+	SDL_Color color = { 255, 255, 255, static_cast<Uint8>( alpha * 255.f ) };
+
+	Draw( texture, u0, v0, u1, v1, x, y, w, h, angle, color );
+}
+
+/**\brief Queues a quad tinted with a color.
+ * \details The texture's colors are multiplied by the color, so white
+ *          images such as font glyphs take on the color exactly.
+ */
+void SpriteBatch::Draw( SDL_Texture *texture, float u0, float v0, float u1, float v1,
+                        float x, float y, float w, float h, float angle, SDL_Color color ) {
+	// Primitives recorded before this sprite have to be drawn before it
+	if( indices.empty() ) {
+		Video::FlushPrimitives();
+	}
+
+	if( texture != current ) {
+		Flush();
+		current = texture;
+	}
+
+	float hw = w / 2.f;
+	float hh = h / 2.f;
+	float cx = x + hw;
+	float cy = y + hh;
+
+	// The screen's y axis points down, so a counter-clockwise rotation of
+	// (dx,dy) is (dx*cos + dy*sin, dy*cos - dx*sin).
+	float c = 1.f, s = 0.f;
+	if( angle != 0.f ) {
+		float radians = static_cast<float>( angle * M_PI / 180. );
+		c = cosf( radians );
+		s = sinf( radians );
+	}
+
+	const float dx[4] = { -hw,  hw, hw, -hw };
+	const float dy[4] = { -hh, -hh, hh,  hh };
+	const float u[4] = { u0, u1, u1, u0 };
+	const float v[4] = { v0, v0, v1, v1 };
+
+	int first = vertices.size();
+
+	for( int i = 0; i < 4; i++ ) {
+		SDL_Vertex vertex;
+		vertex.position.x = cx + dx[i] * c + dy[i] * s;
+		vertex.position.y = cy + dy[i] * c - dx[i] * s;
+		vertex.color = color;
+		vertex.tex_coord.x = u[i];
+		vertex.tex_coord.y = v[i];
+		vertices.push_back( vertex );
+	}
+
+	indices.push_back( first );
+	indices.push_back( first + 1 );
+	indices.push_back( first + 2 );
+	indices.push_back( first );
+	indices.push_back( first + 2 );
+	indices.push_back( first + 3 );
+
+	sprites++;
+}
+
+/**\brief Draws all of the queued quads.
+ */
+void SpriteBatch::Flush() {
+	if( indices.empty() ) {
+		return;
+	}
+
+	if( SDL_RenderGeometry( Video::GetRenderer(), current, &vertices[0], vertices.size(),
+	                        &indices[0], indices.size() ) != 0 ) {
+		LogMsg(WARN, "Could not draw sprites: %s", SDL_GetError() );
+	}
+
+	vertices.clear();
+	indices.clear();
+	flushes++;
+}
+
+/**\brief Records the statistics of the frame that just ended.
+ */
+void SpriteBatch::EndFrame() {
+	lastFlushes = flushes;
+	lastSprites = sprites;
+	flushes = sprites = 0;
+}
+
+/**\fn SpriteBatch::GetFlushes()
+ *  \brief Returns the number of draw calls made during the last frame.
+ * \fn SpriteBatch::GetSprites()
+ *  \brief Returns the number of sprites drawn during the last frame.
+ */
@@ -0,0 +1,35 @@
+/**\file			spritebatch.h
+ * \author			Christopher Thielen (chris@epiar.net)
+ * \date			Created: Sunday, October 18, 2026
+ * \date			Modified: Sunday, October 18, 2026
+ * \brief			Queues textured quads and draws them together
+ * \details
+ */
+
+#ifndef __H_SPRITEBATCH__
+#define __H_SPRITEBATCH__
+
+#include "includes.h"
+
+class SpriteBatch {
+	public:
+		static void Draw( SDL_Texture *texture, float u0, float v0, float u1, float v1,
+		                  float x, float y, float w, float h, float angle, float alpha );
+		static void Draw( SDL_Texture *texture, float u0, float v0, float u1, float v1,
+		                  float x, float y, float w, float h, float angle, SDL_Color color );
+		static void Flush();
+
+		static int GetFlushes() { return lastFlushes; }
+		static int GetSprites() { return lastSprites; }
+		static void EndFrame();
+
+	private:
+		static SDL_Texture *current;
+		static vector<SDL_Vertex> vertices;
+		static vector<int> indices;
+
+		static int flushes, sprites;
+		static int lastFlushes, lastSprites;
+};
+
+#endif // __H_SPRITEBATCH__
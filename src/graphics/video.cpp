@@ -9,6 +9,8 @@
 #include "includes.h"
 #include "common.h"
 #include "graphics/video.h"
+#include "graphics/atlas.h"
+#include "graphics/spritebatch.h"
 #include "utilities/file.h"
 #include "utilities/log.h"
 #include "utilities/xmlfile.h"
@@ -35,8 +37,20 @@
  *  \brief height
  */
 
+/**\class PrimitiveRun
+ * \brief A run of points, lines or rectangles that share a color.
+ * \details Lines are stored as a connected strip of points, so a run of
+ *          lines can be drawn with a single SDL_RenderDrawLines call.
+ */
+
 /**\class Video
- * \brief Video handling. */
+ * \brief Video handling.
+ * \details Points, lines, rectangles and circles aren't drawn immediately. They are
+ *          recorded as PrimitiveRuns, merging each primitive into the
+ *          previous run when its color allows, and the runs are drawn when
+ *          something else needs the renderer: a sprite, a crop rectangle
+ *          change or the end of the frame.
+ */
 
 int Video::w = 0;
 int Video::h = 0;
@@ -45,6 +59,12 @@ int Video::h2 = 0;
 stack<Rect> Video::cropRects;
 SDL_Window *Video::window = NULL;
 SDL_Renderer *Video::renderer = NULL;
+SDL_threadID Video::renderThread = 0;
+vector<PrimitiveRun> Video::primitives;
+vector<SDL_Point> Video::primitivePoints;
+vector<SDL_Rect> Video::primitiveRects;
+vector<SDL_Vertex> Video::primitiveVertices;
+vector<SDL_FPoint> Video::circleTables[CIRCLE_LEVELS];
 
 /**\brief Initializes the Video display.
  */
@@ -59,6 +79,8 @@ bool Video::Initialize( void ) {
 
 	atexit( SDL_Quit );
 
+	renderThread = SDL_ThreadID();
+
 	int w = OPTION( int, "options/video/w" );
 	int h = OPTION( int, "options/video/h" );
 	bool fullscreen = OPTION( bool, "options/video/fullscreen" );
@@ -92,6 +114,8 @@ bool Video::Initialize( void ) {
 bool Video::Shutdown( void ) {
 	EnableMouse();
 
+	Atlas::Shutdown();
+
 	SDL_DestroyRenderer( renderer ); renderer = NULL;
 	SDL_DestroyWindow( window ); window = NULL;
 
@@ -178,12 +202,163 @@ int Video::lua_getHeight(lua_State *L) {
 /**\brief Video updates.
  */
 void Video::Update( void ) {
+	Flush();
+	SpriteBatch::EndFrame();
 	SDL_RenderPresent(renderer);
 }
 
+/**\brief Draws everything that has been queued so far.
+ * \details Call this before drawing to the renderer directly, so that queued
+ *          sprites don't end up on top of what is drawn afterwards.
+ */
+void Video::Flush( void ) {
+	SpriteBatch::Flush();
+	FlushPrimitives();
+}
+
+/**\brief Sends drawing to a texture, or back to the screen when target is NULL.
+ */
+void Video::SetRenderTarget( SDL_Texture *target ) {
+	// Everything queued so far belongs to the previous target
+	Flush();
+
+	SDL_SetRenderTarget( renderer, target );
+}
+
+/**\brief Draws the recorded points, lines and rectangles.
+ */
+void Video::FlushPrimitives( void ) {
+	vector<PrimitiveRun>::iterator run;
+
+	if( primitives.empty() ) {
+		return;
+	}
+
+	for( run = primitives.begin(); run != primitives.end(); ++run ) {
+		SDL_SetRenderDrawBlendMode( renderer, (run->color.a == 255) ? SDL_BLENDMODE_NONE : SDL_BLENDMODE_BLEND );
+		SDL_SetRenderDrawColor( renderer, run->color.r, run->color.g, run->color.b, run->color.a );
+
+		switch( run->type ) {
+			case PRIMITIVE_POINTS:
+				SDL_RenderDrawPoints( renderer, &primitivePoints[run->first], run->count );
+				break;
+			case PRIMITIVE_LINES:
+				SDL_RenderDrawLines( renderer, &primitivePoints[run->first], run->count );
+				break;
+			case PRIMITIVE_RECTS:
+				SDL_RenderDrawRects( renderer, &primitiveRects[run->first], run->count );
+				break;
+			case PRIMITIVE_FILLED_RECTS:
+				SDL_RenderFillRects( renderer, &primitiveRects[run->first], run->count );
+				break;
+			case PRIMITIVE_TRIANGLES:
+				SDL_RenderGeometry( renderer, NULL, &primitiveVertices[run->first], run->count, NULL, 0 );
+				break;
+		}
+	}
+
+	primitives.clear();
+	primitivePoints.clear();
+	primitiveRects.clear();
+	primitiveVertices.clear();
+}
+
+/**\brief Converts a color from floats between 0.0 and 1.0.
+ */
+SDL_Color Video::ToColor( float r, float g, float b, float a ) {
+	SDL_Color color;
+
+	color.r = static_cast<Uint8>( r * 255.f );
+	color.g = static_cast<Uint8>( g * 255.f );
+	color.b = static_cast<Uint8>( b * 255.f );
+	color.a = static_cast<Uint8>( a * 255.f );
+
+	return color;
+}
+
+/**\brief Returns the run that the next primitive should be added to.
+ * \details The last run is reused if it has the same type and color,
+ *          unless a new run is asked for.
+ */
+PrimitiveRun *Video::Primitive( PrimitiveType type, SDL_Color color, bool newRun ) {
+	// Sprites queued before this primitive have to be drawn before it
+	SpriteBatch::Flush();
+
+	if( !newRun && !primitives.empty() ) {
+		PrimitiveRun &last = primitives.back();
+		if( last.type == type && last.color.r == color.r && last.color.g == color.g
+		    && last.color.b == color.b && last.color.a == color.a ) {
+			return &last;
+		}
+	}
+
+	PrimitiveRun run;
+	run.type = type;
+	run.color = color;
+	switch( type ) {
+		case PRIMITIVE_POINTS:
+		case PRIMITIVE_LINES:
+			run.first = primitivePoints.size();
+			break;
+		case PRIMITIVE_RECTS:
+		case PRIMITIVE_FILLED_RECTS:
+			run.first = primitiveRects.size();
+			break;
+		case PRIMITIVE_TRIANGLES:
+			run.first = primitiveVertices.size();
+			break;
+	}
+	run.count = 0;
+	primitives.push_back( run );
+
+	return &primitives.back();
+}
+
+/**\brief Records a point.
+ */
+void Video::AddPoint( int x, int y, SDL_Color color ) {
+	SDL_Point point = { x, y };
+
+	Primitive( PRIMITIVE_POINTS, color )->count++;
+	primitivePoints.push_back( point );
+}
+
+/**\brief Records a line, extending the last line if it ends where this one starts.
+ */
+void Video::AddLine( int x1, int y1, int x2, int y2, SDL_Color color ) {
+	PrimitiveRun *run = Primitive( PRIMITIVE_LINES, color );
+
+	if( run->count > 0 ) {
+		SDL_Point &end = primitivePoints.back();
+		if( end.x != x1 || end.y != y1 ) {
+			run = Primitive( PRIMITIVE_LINES, color, true );
+		}
+	}
+
+	if( run->count == 0 ) {
+		SDL_Point start = { x1, y1 };
+		primitivePoints.push_back( start );
+		run->count++;
+	}
+
+	SDL_Point end = { x2, y2 };
+	primitivePoints.push_back( end );
+	run->count++;
+}
+
+/**\brief Records a filled or unfilled rectangle.
+ */
+void Video::AddRect( int x, int y, int w, int h, bool filled, SDL_Color color ) {
+	SDL_Rect rect = { x, y, w, h };
+
+	Primitive( filled ? PRIMITIVE_FILLED_RECTS : PRIMITIVE_RECTS, color )->count++;
+	primitiveRects.push_back( rect );
+}
+
 /**\brief Clears screen.
  */
 void Video::Erase( void ) {
+	Flush();
 	SDL_SetRenderDrawColor(renderer, 0., 0., 0., 255.);
 	SDL_RenderClear(renderer);
 }
@@ -203,8 +378,7 @@ int Video::GetHeight( void ) {
 /**\brief draws a point, a single pixel, on the screen
  */
 void Video::DrawPoint( int x, int y, float r, float g, float b ) {
-	SDL_SetRenderDrawColor(renderer, r * 255., g * 255., b * 255., 255.);
-	SDL_RenderDrawPoint(renderer, x, y);
+	AddPoint( x, y, ToColor( r, g, b, 1.f ) );
 }
 
 /**\brief Draw a point using Coordinate and Color.
@@ -213,6 +387,13 @@ void Video::DrawPoint( Coordinate c, Color col ) {
 	DrawPoint( (int)c.GetX(), (int)c.GetY(), col.r, col.g, col.b );
 }
 
+/**\brief Draws many single pixel points of the same color in one call.
+ */
+void Video::DrawPoints( const SDL_Point *points, int count, float r, float g, float b ) {
+	Primitive( PRIMITIVE_POINTS, ToColor( r, g, b, 1.f ) )->count += count;
+	primitivePoints.insert( primitivePoints.end(), points, points + count );
+}
+
 /**\brief Draw a Line.
  */
 void Video::DrawLine( Coordinate p1, Coordinate p2, Color c, float a ) {
@@ -228,9 +409,7 @@ void Video::DrawLine( int x1, int y1, int x2, int y2, Color c, float a ) {
 /**\brief Draw a Line.
  */
 void Video::DrawLine( int x1, int y1, int x2, int y2, float r, float g, float b, float a ) {
-	SDL_SetRenderDrawColor( renderer, r * 255., g * 255., b * 255., a * 255. );
-  
-	SDL_RenderDrawLine( renderer, x1, y1, x2, y2 );
+	AddLine( x1, y1, x2, y2, ToColor( r, g, b, a ) );
 }
 
 /**\brief Draws a filled rectangle
@@ -244,17 +423,7 @@ void Video::DrawLine( int x1, int y1, int x2, int y2, float r, float g, float b,
  * \param a
  */
 void Video::DrawRect( int x, int y, int w, int h, float r, float g, float b, float a ) {
-	SDL_Rect rect;
-
-	rect.x = x;
-	rect.y = y;
-	rect.w = w;
-	rect.h = h;
- 
-	SDL_SetRenderDrawBlendMode(renderer, (a == 255) ? SDL_BLENDMODE_NONE : SDL_BLENDMODE_BLEND);
-	SDL_SetRenderDrawColor(renderer, r * 255., g * 255., b * 255., a * 255.);
-  
-	SDL_RenderFillRect( renderer, &rect );
+	AddRect( x, y, w, h, true, ToColor( r, g, b, a ) );
 }
 
 void Video::DrawRect( int x, int y, int w, int h, Color c, float a ) {
@@ -272,18 +441,9 @@ void Video::DrawBox( int x, int y, int w, int h, Color c, float a ) {
 /**\brief Draws an unfilled rectangle
  */
 void Video::DrawBox( int x, int y, int w, int h, float r, float g, float b, float a ) {
-	SDL_Rect rect;
-
 	a = 0.5;
 
-	SDL_SetRenderDrawColor( renderer, r * 255., g * 255., b * 255., a * 255. );
-
-	rect.x = x;
-	rect.y = y;
-	rect.w = w;
-	rect.h = h;
-
-	SDL_RenderDrawRect( renderer, &rect );
+	AddRect( x, y, w, h, false, ToColor( r, g, b, a ) );
 }
 
 /**\brief Draws a circle.
@@ -302,30 +462,6 @@ void Video::DrawCircle( Coordinate c, int radius, float line_width, Color col, f
  */
 void Video::DrawCircle( int x, int y, int radius, float line_width, float r, float g, float b, float a) {
 	DrawEllipse( x, y, radius, radius, r, g, b, a );
-
-	/*double prev_x, prev_y, cur_x, cur_y;
-
-	SDL_SetRenderDrawColor( renderer, r * 255., g * 255., b * 255., a * 255. );
-
-	Trig* t = Trig::Instance();
-
-	prev_x = radius * t->GetCos(0) + x;
-	prev_y = radius * t->GetSin(0) + y;
-
-	for(int angle = 5; angle < 360; angle += 5) {
-		cur_x = radius * t->GetCos(angle) + x;
-		cur_y = radius * t->GetSin(angle) + y;
-
-		SDL_RenderDrawLine(renderer, prev_x, prev_y, cur_x, cur_y);
-
-		prev_x = cur_x;
-		prev_y = cur_y;
-	}
-
-	cur_x = radius * t->GetCos(0) + x;
-	cur_y = radius * t->GetSin(0) + y;
-
-	SDL_RenderDrawLine(renderer, prev_x, prev_y, cur_x, cur_y);*/
 }
 
 void Video::DrawFilledCircle( Coordinate p, int radius, Color c, float a) {
@@ -337,210 +473,92 @@ void Video::DrawFilledCircle( int x, int y, int radius, Color c, float a) {
 }
 
 /**\brief Draw a filled circle.
- *
- *        Adapted from: SDL2_gfx (zlib licensed, aschiffler at ferzkopp dot net) http://www.ferzkopp.net/Software/SDL2_gfx/Docs/html/_s_d_l2__gfx_primitives_8c_source.html#l01457
+ * \details The circle is recorded as a fan of triangles around its center,
+ *          so circles of the same color are drawn with one SDL_RenderGeometry call.
  */
 void Video::DrawFilledCircle( int x, int y, int rad, float r, float g, float b, float a) {
-	Sint16 cx = 0;
-	Sint16 cy = rad;
-	Sint16 ocx = (Sint16) 0xffff;
-	Sint16 ocy = (Sint16) 0xffff;
-	Sint16 df = 1 - rad;
-	Sint16 d_e = 3;
-	Sint16 d_se = -2 * rad + 5;
-	Sint16 xpcx, xmcx, xpcy, xmcy;
-	Sint16 ypcy, ymcy, ypcx, ymcx;
-
-	// Convert from 'float'
-	r *= 255.;
-	g *= 255.;
-	b *= 255.;
-	a *= 255.;
-
-	// Sanity check radius 
+	// Sanity check radius
 	if (rad <= 0) {
 		return;
 	}
 
-	// Set color
-	SDL_SetRenderDrawBlendMode(renderer, (a == 255) ? SDL_BLENDMODE_NONE : SDL_BLENDMODE_BLEND);
-	SDL_SetRenderDrawColor(renderer, r, g, b, a);
- 
-	// Draw 
-	do {
-		xpcx = x + cx;
-		xmcx = x - cx;
-		xpcy = x + cy;
-		xmcy = x - cy;
-		
-		if (ocy != cy) {
-			if (cy > 0) {
-				ypcy = y + cy;
-				ymcy = y - cy;
-
-				SDL_RenderDrawLine(renderer, xmcx, ypcy, xpcx, ypcy);
-				SDL_RenderDrawLine(renderer, xmcx, ymcy, xpcx, ymcy);
-			} else {
-				SDL_RenderDrawLine(renderer, xmcx, y, xpcx, y);
-			}
-
-			ocy = cy;
-		}
-		if (ocx != cx) {
-			if (cx != cy) {
-				if (cx > 0) {
-					ypcx = y + cx;
-					ymcx = y - cx;
-
-					SDL_RenderDrawLine(renderer, xmcy, ymcx, xpcy, ymcx);
-					SDL_RenderDrawLine(renderer, xmcy, ypcx, xpcy, ypcx);
-				} else {
-					SDL_RenderDrawLine(renderer, xmcy, y, xpcy, y);
-				}
-			}
-
-			ocx = cx;
-		}
- 
-		// Update 
-		if (df < 0) {
-			df += d_e;
-			d_e += 2;
-			d_se += 2;
-		} else {
-			df += d_se;
-			d_e += 2;
-			d_se += 4;
-			cy--;
-		}
+	const vector<SDL_FPoint>& unit = UnitCircle( static_cast<float>(rad) );
+	int segments = unit.size() - 1;
+	SDL_Color color = ToColor( r, g, b, a );
+	SDL_Vertex center;
+
+	center.position.x = static_cast<float>(x);
+	center.position.y = static_cast<float>(y);
+	center.color = color;
+	center.tex_coord.x = center.tex_coord.y = 0.f;
+
+	Primitive( PRIMITIVE_TRIANGLES, color )->count += 3 * segments;
 
-		cx++;
-	} while (cx <= cy);
+	for( int i = 0; i < segments; i++ ) {
+		SDL_Vertex rim1 = center, rim2 = center;
+
+		rim1.position.x += rad * unit[i].x;
+		rim1.position.y += rad * unit[i].y;
+		rim2.position.x += rad * unit[i+1].x;
+		rim2.position.y += rad * unit[i+1].y;
+
+		primitiveVertices.push_back( center );
+		primitiveVertices.push_back( rim1 );
+		primitiveVertices.push_back( rim2 );
+	}
 }
 
 /**\brief Draw an ellipse.
- *
- *        Adapted from: SDL2_gfx (zlib licensed, aschiffler at ferzkopp dot net) http://www.ferzkopp.net/Software/SDL2_gfx/Docs/html/_s_d_l2__gfx_primitives_8c_source.html#l01598
+ * \details The outline is recorded as a single closed strip of lines.
  */
 void Video::DrawEllipse( int x, int y, int rx, int ry, float r, float g, float b, float a) {
-	int ix, iy;
-	int h, i, j, k;
-	int oh, oi, oj, ok;
-	int xmh, xph, ypk, ymk;
-	int xmi, xpi, ymj, ypj;
-	int xmj, xpj, ymi, ypi;
-	int xmk, xpk, ymh, yph;
-
-	// Convert from 'float'
-	r *= 255.;
-	g *= 255.;
-	b *= 255.;
-	a *= 255.;
- 
-         // Sanity check radii 
-         if ((rx <= 0) || (ry <= 0)) {
-                 return;
-         }
- 
-         // Set color
-         SDL_SetRenderDrawBlendMode(renderer, (a == 255) ? SDL_BLENDMODE_NONE : SDL_BLENDMODE_BLEND);
-         SDL_SetRenderDrawColor(renderer, r, g, b, a);
- 
-         // Init vars 
-         oh = oi = oj = ok = 0xFFFF;
- 
-         // Draw 
-         if (rx > ry) {
-                 ix = 0;
-                 iy = rx * 64;
- 
-                 do {
-                         h = (ix + 32) >> 6;
-                         i = (iy + 32) >> 6;
-                         j = (h * ry) / rx;
-                         k = (i * ry) / rx;
- 
-                         if (((ok != k) && (oj != k)) || ((oj != j) && (ok != j)) || (k != j)) {
-                                 xph = x + h;
-                                 xmh = x - h;
-                                 if (k > 0) {
-                                         ypk = y + k;
-                                         ymk = y - k;
-                                         SDL_RenderDrawPoint(renderer, xmh, ypk);
-                                         SDL_RenderDrawPoint(renderer, xph, ypk);
-                                         SDL_RenderDrawPoint(renderer, xmh, ymk);
-                                         SDL_RenderDrawPoint(renderer, xph, ymk);
-                                 } else {
-                                         SDL_RenderDrawPoint(renderer, xmh, y);
-                                         SDL_RenderDrawPoint(renderer, xph, y);
-                                 }
-                                 ok = k;
-                                 xpi = x + i;
-                                 xmi = x - i;
-                                 if (j > 0) {
-                                         ypj = y + j;
-                                         ymj = y - j;
-                                         SDL_RenderDrawPoint(renderer, xmi, ypj);
-                                         SDL_RenderDrawPoint(renderer, xpi, ypj);
-                                         SDL_RenderDrawPoint(renderer, xmi, ymj);
-                                         SDL_RenderDrawPoint(renderer, xpi, ymj);
-                                 } else {
-                                         SDL_RenderDrawPoint(renderer, xmi, y);
-                                         SDL_RenderDrawPoint(renderer, xpi, y);
-                                 }
-                                 oj = j;
-                         }
- 
-                         ix = ix + iy / rx;
-                         iy = iy - ix / rx;
- 
-                 } while (i > h);
-         } else {
-                 ix = 0;
-                 iy = ry * 64;
- 
-                 do {
-                         h = (ix + 32) >> 6;
-                         i = (iy + 32) >> 6;
-                         j = (h * rx) / ry;
-                         k = (i * rx) / ry;
- 
-                         if (((oi != i) && (oh != i)) || ((oh != h) && (oi != h) && (i != h))) {
-                                 xmj = x - j;
-                                 xpj = x + j;
-                                 if (i > 0) {
-                                         ypi = y + i;
-                                         ymi = y - i;
-                                         SDL_RenderDrawPoint(renderer, xmj, ypi);
-                                         SDL_RenderDrawPoint(renderer, xpj, ypi);
-                                         SDL_RenderDrawPoint(renderer, xmj, ymi);
-                                         SDL_RenderDrawPoint(renderer, xpj, ymi);
-                                 } else {
-                                         SDL_RenderDrawPoint(renderer, xmj, y);
-                                         SDL_RenderDrawPoint(renderer, xpj, y);
-                                 }
-                                 oi = i;
-                                 xmk = x - k;
-                                 xpk = x + k;
-                                 if (h > 0) {
-                                         yph = y + h;
-                                         ymh = y - h;
-                                         SDL_RenderDrawPoint(renderer, xmk, yph);
-                                         SDL_RenderDrawPoint(renderer, xpk, yph);
-                                         SDL_RenderDrawPoint(renderer, xmk, ymh);
-                                         SDL_RenderDrawPoint(renderer, xpk, ymh);
-                                 } else {
-                                         SDL_RenderDrawPoint(renderer, xmk, y);
-                                         SDL_RenderDrawPoint(renderer, xpk, y);
-                                 }
-                                 oh = h;
-                         }
- 
-                         ix = ix + iy / ry;
-                         iy = iy - ix / ry;
- 
-                 } while (i > h);
-         }
+	// Sanity check radii
+	if ((rx <= 0) || (ry <= 0)) {
+		return;
+	}
+
+	const vector<SDL_FPoint>& unit = UnitCircle( static_cast<float>( rx > ry ? rx : ry ) );
+	int points = unit.size();
+
+	// Always start a new strip, as the outline is closed
+	Primitive( PRIMITIVE_LINES, ToColor( r, g, b, a ), true )->count += points;
+
+	for( int i = 0; i < points; i++ ) {
+		SDL_Point point;
+		point.x = x + TO_INT( floor( rx * unit[i].x + .5f ) );
+		point.y = y + TO_INT( floor( ry * unit[i].y + .5f ) );
+		primitivePoints.push_back( point );
+	}
+}
+
+/**\brief Returns the points of a circle of radius 1, in enough detail for a circle of this radius.
+ * \details The tables are built the first time they are needed. Each level
+ *          has twice as many points as the one before, and the level used
+ *          is the first whose segments are at most CIRCLE_SEGMENT_LENGTH
+ *          pixels long. The first point is repeated at the end.
+ */
+const vector<SDL_FPoint>& Video::UnitCircle( float radius ) {
+	int level = 0;
+	int segments = CIRCLE_MIN_SEGMENTS;
+
+	while( (level < CIRCLE_LEVELS - 1) && (2.f * M_PI * radius / segments > CIRCLE_SEGMENT_LENGTH) ) {
+		level++;
+		segments *= 2;
+	}
+
+	vector<SDL_FPoint>& table = circleTables[level];
+
+	if( table.empty() ) {
+		table.resize( segments + 1 );
+		for( int i = 0; i < segments; i++ ) {
+			double angle = 2. * M_PI * i / segments;
+			table[i].x = static_cast<float>( cos( angle ) );
+			table[i].y = static_cast<float>( sin( angle ) );
+		}
+		table[segments] = table[0];
+	}
+
+	return table;
 }
 
 /**\brief Draws a targeting overlay.
@@ -549,23 +567,25 @@ void Video::DrawTarget( int x, int y, int w, int h, int d, float r, float g, flo
 	float w2 = w / 2.;
 	float h2 = h / 2.;
 
-	SDL_SetRenderDrawColor( renderer, r * 255., g * 255., b * 255., a * 255. );
+	SDL_Color color = ToColor( r, g, b, a );
 
+	// Each corner is drawn from the end of one arm, through the corner, to
+	// the end of the other arm, so both arms join into one strip of lines.
 	// Upper Left Corner
-	SDL_RenderDrawLine(renderer, x - w2, y - h2, x - w2, y - h2 + d);
-	SDL_RenderDrawLine(renderer, x - w2, y - h2, x - w2 + d, y - h2);
+	AddLine( x - w2, y - h2 + d, x - w2, y - h2, color );
+	AddLine( x - w2, y - h2, x - w2 + d, y - h2, color );
 
 	// Upper Right Corner
-	SDL_RenderDrawLine(renderer, x + w2, y - h2, x + w2, y - h2 + d);
-	SDL_RenderDrawLine(renderer, x + w2, y - h2, x + w2 - d, y - h2);
+	AddLine( x + w2, y - h2 + d, x + w2, y - h2, color );
+	AddLine( x + w2, y - h2, x + w2 - d, y - h2, color );
 
 	// Lower Left Corner
-	SDL_RenderDrawLine(renderer, x - w2, y + h2, x - w2, y + h2 - d);
-	SDL_RenderDrawLine(renderer, x - w2, y + h2, x - w2 + d, y + h2);
+	AddLine( x - w2, y + h2 - d, x - w2, y + h2, color );
+	AddLine( x - w2, y + h2, x - w2 + d, y + h2, color );
 
 	// Lower Right Corner
-	SDL_RenderDrawLine(renderer, x + w2, y + h2, x + w2, y + h2 - d);
-	SDL_RenderDrawLine(renderer, x + w2, y + h2, x + w2 - d, y + h2);
+	AddLine( x + w2, y + h2 - d, x + w2, y + h2, color );
+	AddLine( x + w2, y + h2, x + w2 - d, y + h2, color );
 }
 
 /**\brief Enables the mouse
@@ -621,6 +641,9 @@ void Video::SetCropRect( int x, int y, int w, int h ) {
 		if(hn < 0) hn = 0; // same reason as line above
 	}
 
+	// Queued sprites were meant for the previous crop rectangle
+	Flush();
+
 	cropRects.push(Rect( xn, yn, wn, hn ));
 
 	SDL_Rect rect;
@@ -638,6 +661,8 @@ void Video::SetCropRect( int x, int y, int w, int h ) {
 /**\brief Unset the previous crop rectangle after use.
  */
 void Video::UnsetCropRect( void ) {
+	Flush();
+
 	if(!cropRects.empty()) { // Shouldn't be empty
 		cropRects.pop();
 	} else {
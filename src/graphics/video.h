@@ -31,6 +31,27 @@ class Rect {
 		Rect( int x, int y, int w, int h ) { this->x = TO_FLOAT(x); this->y = TO_FLOAT(y); this->w = TO_FLOAT(w); this->h = TO_FLOAT(h); }
 };
 
+enum PrimitiveType {
+	PRIMITIVE_POINTS,
+	PRIMITIVE_LINES, // a connected strip of lines
+	PRIMITIVE_RECTS,
+	PRIMITIVE_FILLED_RECTS,
+	PRIMITIVE_TRIANGLES // untextured, three vertices each
+};
+
+// Levels of detail of the cached circle outlines
+#define CIRCLE_LEVELS 5
+#define CIRCLE_MIN_SEGMENTS 12
+#define CIRCLE_SEGMENT_LENGTH 4.f // longest segment allowed, in pixels
+
+class PrimitiveRun {
+	public:
+		PrimitiveType type;
+		SDL_Color color;
+		int first; // index of the first point, rectangle or vertex of this run
+		int count;
+};
+
 class Video {
  	public:
 		static bool Initialize( void );
@@ -42,8 +63,12 @@ class Video {
 
   		static void Update( void );
   		static void Erase( void );
+		static void Flush( void );
+		static void FlushPrimitives( void );
+		static void SetRenderTarget( SDL_Texture *target );
 
 		static SDL_Renderer* GetRenderer( void ) { return renderer; }
+		static bool IsRenderThread( void ) { return SDL_ThreadID() == renderThread; }
 
   		static void EnableMouse( void );
   		static void DisableMouse( void );
@@ -55,6 +80,7 @@ class Video {
 
 		static void DrawPoint( int x, int y, float r, float g, float b );
 		static void DrawPoint( Coordinate c, Color col );
+		static void DrawPoints( const SDL_Point *points, int count, float r, float g, float b );
 		static void DrawLine( int x1, int y1, int x2, int y2, Color c, float a = 1.0f);
 		static void DrawLine( int x1, int y1, int x2, int y2, float r, float g, float b, float a = 1.0f);
 		static void DrawLine( Coordinate p1, Coordinate p2, Color c, float a = 1.0f);
@@ -89,6 +115,21 @@ class Video {
 		static stack<Rect> cropRects;
 		static SDL_Window *window;
 		static SDL_Renderer *renderer;
+		static SDL_threadID renderThread; // the only thread that may use the renderer
+
+		static SDL_Color ToColor( float r, float g, float b, float a );
+		static PrimitiveRun *Primitive( PrimitiveType type, SDL_Color color, bool newRun = false );
+		static void AddPoint( int x, int y, SDL_Color color );
+		static void AddLine( int x1, int y1, int x2, int y2, SDL_Color color );
+		static void AddRect( int x, int y, int w, int h, bool filled, SDL_Color color );
+
+		static vector<PrimitiveRun> primitives; // recorded primitives, in drawing order
+		static vector<SDL_Point> primitivePoints; // points of the point and line runs
+		static vector<SDL_Rect> primitiveRects; // rectangles of the rectangle runs
+		static vector<SDL_Vertex> primitiveVertices; // vertices of the triangle runs
+
+		static const vector<SDL_FPoint>& UnitCircle( float radius );
+		static vector<SDL_FPoint> circleTables[CIRCLE_LEVELS];
 };
 
 #endif // __H_VIDEO__
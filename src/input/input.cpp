@@ -336,6 +336,26 @@ void Input::HandleLuaCallBacks( list<InputEvent> & events ) {
 	}
 }
 
+/**\brief Removes the events that have Lua key bindings, to be handled later.
+ * \return The removed events, in order
+ * \sa HandleLuaCallBacks
+ */
+list<InputEvent> Input::TakeLuaCallBacks( list<InputEvent> & events ) {
+	list<InputEvent> taken;
+	list<InputEvent>::iterator i = events.begin();
+
+	while( i != events.end() ) {
+		if( eventMappings.find( *i ) != eventMappings.end() ) {
+			taken.push_back( *i );
+			i = events.erase( i );
+		} else {
+			i++;
+		}
+	}
+
+	return taken;
+}
+
 /**\brief Register Lua events.
  */
 void Input::RegisterCallBack( InputEvent event, string command ) {
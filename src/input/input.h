@@ -93,6 +93,7 @@ class Input {
 		static list<InputEvent> Update( void );
 
 		static void HandleLuaCallBacks( list<InputEvent> & events );
+		static list<InputEvent> TakeLuaCallBacks( list<InputEvent> & events );
 		static void RegisterCallBack( InputEvent key, string command );
 		static void UnRegisterCallBack( InputEvent key );
 		static void RegisterLuaVariables( void );
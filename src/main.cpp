@@ -20,6 +20,7 @@
 #include "ui/ui.h"
 #include "utilities/argparser.h"
 #include "utilities/filesystem.h"
+#include "utilities/loader.h"
 #include "utilities/log.h"
 #include "utilities/lua.h"
 #include "utilities/xmlfile.h"
@@ -35,6 +36,8 @@ XMLFile *skinfile = NULL;
 Font *SansSerif = NULL, *BitType = NULL, *Serif = NULL, *Mono = NULL;
 ArgParser *argparser = NULL;
 bool interpolateOn = true;
+// Set by --compile-scenario
+static string compileScenario;
 
 void InitializeOS           ( int argc, char **argv ); ///< Run OS Specific setup code
 void Main_Load_Options      (); ///< Load the settings files
@@ -79,6 +82,13 @@ int main( int argc, char **argv ) {
 
 	// Main game
 	Main_Init_Singletons();
+
+	if( !compileScenario.empty() ) {
+		bool compiled = Menu::CompileScenario( compileScenario );
+		Main_Close_Singletons();
+		return( compiled ? 0 : 1 );
+	}
+
 	Menu::Run();
 
 	LogMsg(DEBUG, "Shutting down ..." );
@@ -194,6 +204,7 @@ void Main_Init_Singletons() {
 
 	Timer::Initialize();
 	Video::Initialize();
+	Loader::Initialize();
 
 	SansSerif       = new Font( "data/fonts/FreeSans.ttf", 12 );
 	BitType         = new Font( "data/fonts/visitor2.ttf", 12 );
@@ -219,6 +230,7 @@ void Main_Close_Singletons( void ) {
 	delete Serif;
 	delete Mono;
 
+	Loader::Shutdown();
 	Video::Shutdown();
 	Audio::Instance()->Shutdown();
 
@@ -259,6 +271,7 @@ void Main_Parse_Args( int argc, char **argv ) {
 	argparser->SetOpt(VALUEOPT, "log-msg",       "Filter log messages by string content.");
 
 	argparser->SetOpt(LONGOPT, "restore-defaults", "Restore options to default values.");
+	argparser->SetOpt(VALUEOPT, "compile-scenario", "Compile the named scenario for faster loading, then exit.");
 
 #ifdef EPIAR_COMPILE_TESTS
 	argparser->SetOpt(VALUEOPT, "run-test",      "Run specified test");
@@ -315,6 +328,8 @@ void Main_Parse_Args( int argc, char **argv ) {
 	string msgfilt = argparser->HaveValue("log-msg");
 	string loglvl = argparser->HaveValue("log-lvl");
 
+	compileScenario = argparser->HaveValue("compile-scenario");
+
 	if("" != funcfilt) Log::Instance().SetFuncFilter(funcfilt);
 	if("" != msgfilt) Log::Instance().SetMsgFilter(msgfilt);
 	if("" != loglvl) {
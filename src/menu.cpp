@@ -13,6 +13,8 @@
 #include "ui/ui.h"
 #include "ui/widgets.h"
 #include "utilities/filesystem.h"
+#include "utilities/loader.h"
+#include "utilities/resource.h"
 #include "utilities/timer.h"
 
 bool Menu::quit = false;
@@ -79,6 +81,10 @@ void Menu::Run( void ) {
 		events = inputs.Update();
 		UI::HandleInput( events );
 
+		// Take whatever the Loader has finished
+		Loader::Update();
+		Resource::Trim();
+
 		// Draw Things
 		int loops = Timer::Update();
 		if(loops) {
@@ -102,6 +108,24 @@ Scenario* Menu::GetCurrentScenario( void ) {
 	return scenario;
 }
 
+/** Compiles a Scenario, without running it.
+ * \returns true if the scenario was compiled successfully.
+ * \sa Scenario::Compile
+ */
+bool Menu::CompileScenario( string name ) {
+	bool success;
+
+	assert(scenario == NULL);
+	scenario = new Scenario();
+
+	// The Components find each other through the current Scenario
+	success = scenario->Compile( name );
+
+	delete scenario; scenario = NULL;
+
+	return success;
+}
+
 /** Load the most recent Player
  * \note When the user leaves the Scenario, the game will quit.
  * \returns true if the player was loaded successfully.
@@ -117,7 +141,7 @@ bool Menu::AutoLoad() {
 		assert(scenario == NULL);
 		scenario = new Scenario();
 
-		if( !scenario->Load( info->scenario ) )
+		if( !scenario->Load( info->scenario, &Menu::LoadingScreen ) )
 		{
 			LogMsg(ERR,"Failed to load the scenario '%s'.", info->scenario.c_str() );
 			delete scenario; scenario = NULL;
@@ -143,6 +167,24 @@ bool Menu::AutoLoad() {
 	return false;
 }
 
+/** Draws how far the Scenario has loaded
+ *  \details Called by Scenario::Load while its Resources are decoded.
+ */
+void Menu::LoadingScreen( float fraction ) {
+	int w = Video::GetWidth() / 2;
+	int x = Video::GetHalfWidth() - w / 2;
+	int y = Video::GetHeight() - 60;
+
+	Video::Erase();
+	if( menuSplash ) {
+		menuSplash->DrawStretch( 0, 0, Video::GetWidth(), Video::GetHeight() );
+	}
+	Video::DrawRect( x, y, w, 12, 0.f, 0.f, 0.f, 0.6f );
+	Video::DrawRect( x, y, static_cast<int>( w * fraction ), 12, 0.8f, 0.8f, 0.8f, 0.9f );
+	Video::DrawBox( x, y, w, 12, 1.f, 1.f, 1.f, 1.f );
+	Video::Update();
+}
+
 /** Create the Basic Main Menu
  *  \details The Splash Screen is random.
  */
@@ -276,7 +318,7 @@ void Menu::StartGame( void *info ) {
 	scenario = new Scenario();
 
 	// Load the Scenario from file
-	if( !scenario->Load( simName ) ) {
+	if( !scenario->Load( simName, &Menu::LoadingScreen ) ) {
 		LogMsg(ERR, "Failed to load the scenario '%s'.", simName.c_str());
 		Dialogs::Alert("Failed to load scenario!");
 		return;
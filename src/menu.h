@@ -20,6 +20,7 @@ class Menu {
 	public:
 		static void Run( void );
 		static Scenario* GetCurrentScenario( void );
+		static bool CompileScenario( string name );
 
 	private:
 		static bool quit;
@@ -51,6 +52,7 @@ class Menu {
 		static void CreateNewWindow();
 		static void CreateLoadWindow();
 		static void StartGame( void* playerInfo );
+		static void LoadingScreen( float fraction );
 		static void QuitMenu();
 	
 		// Player Management
@@ -13,6 +13,7 @@
 #include "sprites/sprite.h"
 #include "sprites/effects.h"
 #include "engine/scenario_lua.h"
+#include "engine/snapshot.h"
 
 /** \addtogroup Sprites
  * @{
@@ -46,11 +47,10 @@ void Effect::Update( lua_State *L ) {
 	}
 }
 
-/**\brief Draws the Effect
+/**\brief Adds the current frame of the Effect to a Snapshot
  */
-void Effect::Draw( void ) {
-	Coordinate pos = GetScreenPosition();
-	visual->Draw( pos.GetX(), pos.GetY(), this->GetAngle(), 1.0 );
+void Effect::Capture( Snapshot *snapshot ) {
+	snapshot->AddImage( visual->GetFrame(), GetScreenPosition(), GetOldScreenPosition(), this->GetAngle(), 1.0 );
 }
 
 /**\fn Effect::GetDrawOrder( )
@@ -20,7 +20,7 @@ class Effect : public Sprite {
 		Effect(Coordinate pos, string filename, float loopPercent);
 		~Effect();
 		void Update( lua_State *L );
-		void Draw(void);
+		void Capture( Snapshot *snapshot );
 		virtual int GetDrawOrder( void ) {
 			return( DRAW_ORDER_EFFECT);
 		}
@@ -14,6 +14,7 @@
 #include "sprites/spritemanager.h"
 #include "utilities/lua.h"
 #include "engine/scenario_lua.h"
+#include "engine/snapshot.h"
 
 /** \addtogroup Sprites
  * @{
@@ -31,81 +32,153 @@ NPC::NPC(string _name, string machine) :
 	name(_name),
 	allegiance(NULL),
 	stateMachine(machine),
-	state("default")
+	state("default"),
+	thread(NULL),
+	threadReference(LUA_NOREF),
+	running(false),
+	restart(false)
 {
 	this->isPlayerFlag = false;
 	target = 0;
 	merciful = 0;
+	dockedUntil = 0;
 }
 
-/** \brief Run the Lua Statemachine to act and possibly change state.
+/** \brief AI Destructor
  */
+NPC::~NPC() {
+	// The Lua state may already be closed when the Scenario is torn down
+	if( Lua::CurrentState() != NULL ) {
+		StopThread( Lua::CurrentState() );
+	}
+}
 
-void NPC::Decide( lua_State *L ) {
-	// Decide
-	const int initialStackTop = lua_gettop(L);
-
-	// Get the current state machine
-	lua_getglobal(L, stateMachine.c_str());
-	int machineIndex = lua_gettop(L);
-	if(lua_istable(L, machineIndex) == false) {
-		LogMsg(ERR, "There is no State Machine named '%s'!", stateMachine.c_str() );
-		return; // This ship will just sit idle...
+/** \brief Switch to a different state machine.
+ * \details The coroutine is restarted on the next Decide, in the state of
+ * the same name if the new state machine has one.
+ */
+void NPC::SetStateMachine(string _machine) {
+	stateMachine = _machine;
+	if( running ) {
+		restart = true; // The coroutine can't be stopped from inside itself
+	} else if( Lua::CurrentState() != NULL ) {
+		StopThread( Lua::CurrentState() );
+	}
+}
+
+/** \brief Force the state machine into a new state.
+ */
+void NPC::SetState(string _state) {
+	state = _state;
+	if( running ) {
+		restart = true; // The coroutine can't be stopped from inside itself
+	} else if( Lua::CurrentState() != NULL ) {
+		StopThread( Lua::CurrentState() );
+	}
+}
+
+/** \brief Create the coroutine that runs this NPC's state machine.
+ * \details The coroutine runs RunStateMachine from npc.lua, which keeps the
+ * current state and the NPC's AIData entry in locals between ticks.
+ * \returns false if the state machine could not be started.
+ */
+bool NPC::StartThread( lua_State *L ) {
+	thread = lua_newthread(L);
+	threadReference = luaL_ref(L, LUA_REGISTRYINDEX);
+
+	lua_getglobal(thread, "RunStateMachine");
+	if( lua_isfunction(thread, -1) == false ) {
+		LogMsg(ERR, "There is no RunStateMachine function to run the State Machine '%s'.", stateMachine.c_str() );
+		StopThread( L );
+		return false;
 	}
 
-	// Get the current state
-	lua_pushstring(L, state.c_str());
-	lua_gettable(L, machineIndex);
-	if(lua_isfunction(L, lua_gettop(L)) == false) {
-		LogMsg(WARN, "The State Machine '%s' has no state '%s'.", stateMachine.c_str(), state.c_str() );
+	lua_pushinteger( thread, this->GetID() );
+	lua_pushstring( thread, stateMachine.c_str() );
+	lua_pushstring( thread, state.c_str() );
+
+	// Run up to the first yield, which reports the starting state
+	running = true;
+	int status = lua_resume(thread, 3);
+	running = false;
+
+	if( status != LUA_YIELD ) {
+		LogMsg(ERR, "Failed to start %s(%s): %s", stateMachine.c_str(), state.c_str(), lua_tostring(thread, -1));
+		restart = false;
+		StopThread( L );
+		return false;
+	}
 
-		lua_getglobal(L, stateMachine.c_str());
-		lua_pushstring(L, "default");
-		lua_gettable(L, machineIndex);
+	if( restart ) {
+		// Start over in the state that was asked for
+		restart = false;
+		StopThread( L );
+		return false;
+	}
 
-		if(lua_isfunction(L, lua_gettop(L)) == false) {
-			LogMsg(ERR, "The State Machine '%s' has no default state.", stateMachine.c_str() );
+	state = lua_tostring(thread, -1);
+	lua_settop(thread, 0);
 
-			lua_settop(L, initialStackTop);
+	return true;
+}
 
+/** \brief Release the coroutine so that it can be collected.
+ */
+void NPC::StopThread( lua_State *L ) {
+	if( thread != NULL ) {
+		luaL_unref(L, LUA_REGISTRYINDEX, threadReference);
+		thread = NULL;
+		threadReference = LUA_NOREF;
+	}
+}
+
+/** \brief Resume the Lua Statemachine to act and possibly change state.
+ */
+
+void NPC::Decide( lua_State *L ) {
+	if( thread == NULL ) {
+		if( !StartThread( L ) ) {
 			return; // This ship will just sit idle...
 		}
 	}
 
 	// Push Current AI Variables
-	lua_pushinteger( L, this->GetID() );
-	lua_pushnumber( L, this->GetWorldPosition().GetX() );
-	lua_pushnumber( L, this->GetWorldPosition().GetY() );
-	lua_pushnumber( L, this->GetAngle() );
-	lua_pushnumber( L, this->GetMomentum().GetMagnitude() ); // Speed
-	lua_pushnumber( L, this->GetMomentum().GetAngle() ); // Vector
-
-	// Run the current NPC state
-	//printf("Call:"); Lua::stackDump(L); // DEBUG
-	if( lua_pcall(L, 6, 1, 0) != 0) {
-		LogMsg(ERR, "Failed to run %s(%s): %s\n", stateMachine.c_str(), state.c_str(), lua_tostring(L, -1));
-		lua_settop(L, initialStackTop);
+	lua_pushnumber( thread, this->GetWorldPosition().GetX() );
+	lua_pushnumber( thread, this->GetWorldPosition().GetY() );
+	lua_pushnumber( thread, this->GetAngle() );
+	lua_pushnumber( thread, this->GetMomentum().GetMagnitude() ); // Speed
+	lua_pushnumber( thread, this->GetMomentum().GetAngle() ); // Vector
+
+	// Run the current NPC state.
+	// SetState and SetStateMachine only ask for a restart while it runs.
+	running = true;
+	int status = lua_resume(thread, 5);
+	running = false;
+
+	if( status != LUA_YIELD ) {
+		restart = false;
+		if( status == 0 ) {
+			LogMsg(ERR, "The State Machine '%s' stopped running in state '%s'.", stateMachine.c_str(), state.c_str() );
+		} else {
+			LogMsg(ERR, "Failed to run %s(%s): %s. Resetting StateMachine.", stateMachine.c_str(), state.c_str(), lua_tostring(thread, -1));
+		}
+		state = "default"; // Reset the state
+		StopThread( L );
 		return;
 	}
-	//printf("Return:"); Lua::stackDump(L); // DEBUG
-
-	if(lua_isstring(L, lua_gettop(L))) {
-		string newstate = (string)luaL_checkstring(L, lua_gettop(L));
 
-		// Verify that this new state exists
-		lua_pushstring(L, newstate.c_str());
-		lua_gettable(L, machineIndex);
-		if(lua_isfunction(L, lua_gettop(L))) {
-			state = newstate;
-		} else {
-			LogMsg(ERR, "The State Machine '%s' has no state '%s'. Could not transition from '%s'. Resetting StateMachine.", stateMachine.c_str(), newstate.c_str(), state.c_str() );
-			state = "default"; // Reset the state
-		}
-		//printf("Changing State:"); Lua::stackDump(L); // DEBUG
+	if( restart ) {
+		// The new state or State Machine starts with the next Decide
+		restart = false;
+		StopThread( L );
+		return;
 	}
 
-	//printf("Complete:");Lua::stackDump(L); // DEBUG
-	lua_settop(L, initialStackTop);
+	// The State Machine only reports the state when it changes
+	if( lua_isstring(thread, -1) ) {
+		state = lua_tostring(thread, -1);
+	}
+	lua_settop(thread, 0);
 }
 
 /**\brief Updates the NPC controlled ship by first calling the Lua function
@@ -138,6 +211,9 @@ void NPC::Killed( lua_State *L ) {
 	LogMsg(DEBUG, "NPC %s has been killed", GetName().c_str() );
 	SpriteManager *sprites = Scenario_Lua::GetScenario(L)->GetSpriteManager();
 
+	// Let the Missions know that this ship is gone
+	Scenario_Lua::GetScenario(L)->GetPlayer()->ShipRemoved( GetID() );
+
 	Sprite* killer = sprites->GetSpriteByID( target );
 	if(killer != NULL) {
 		if( killer->GetDrawOrder() == DRAW_ORDER_PLAYER ) {
@@ -147,21 +223,122 @@ void NPC::Killed( lua_State *L ) {
 }
 
 
-/**\brief Draw the AI Ship, and possibly debugging information.
+/**\brief Fly towards a destination.
+ * \param destination World coordinate to travel to
+ * \param arrivalRadius Distance from the destination that counts as arrived
+ * \return true once the ship is within arrivalRadius of the destination
+ */
+bool NPC::TravelTo( Coordinate destination, float arrivalRadius ) {
+	Rotate( GetDirectionTowards( destination ), false );
+	Accelerate( false );
+
+	return (destination - GetWorldPosition()).GetMagnitudeSquared() < arrivalRadius * arrivalRadius;
+}
+
+/**\brief Come to a stop and stay docked for a while.
+ *
+ * "Docking" for NPCs is really waiting between 5 and 15 seconds while
+ * stopped. The wait starts once the ship has stopped moving.
+ *
+ * \return true once the docking time has passed
+ */
+bool NPC::Dock() {
+	if( GetMomentum().GetMagnitudeSquared() != 0 ) {
+		Decelerate();
+		return false;
+	}
+
+	if( dockedUntil == 0 ) {
+		dockedUntil = Timer::TimestampAfterSeconds( (rand() % 10) + 5 );
+		return false;
+	}
+
+	if( Timer::GetTicks() > dockedUntil ) {
+		dockedUntil = 0;
+		return true;
+	}
+
+	return false;
+}
+
+/**\brief Circle around a point, staying between two radii.
+ * \param center World coordinate to orbit
+ * \param nearRadius Closest the ship should get to the center
+ * \param farRadius Farthest the ship should get from the center
+ */
+void NPC::Orbit( Coordinate center, float nearRadius, float farRadius ) {
+	float dist = (center - GetWorldPosition()).GetMagnitude();
+	float direction = GetDirectionTowards( center );
+
+	if( dist > farRadius ) {
+		Rotate( direction, false );
+	} else if( dist < nearRadius ) {
+		Rotate( -direction, false );
+	} else {
+		Rotate( direction + 90, false );
+	}
+
+	Accelerate( false );
+}
+
+/**\brief Close in on an enemy and optionally fire at it.
+ * \param enemy The Sprite being attacked
+ * \param standoff Distance at which the ship stops accelerating towards the enemy
+ * \param fire Whether to fire the weapons this tick
+ * \return distance to the enemy
+ */
+float NPC::Attack( Sprite* enemy, float standoff, bool fire ) {
+	float dist = (enemy->GetWorldPosition() - GetWorldPosition()).GetMagnitude();
+	float direction = GetDirectionTowards( enemy->GetWorldPosition() );
+
+	Rotate( direction, false );
+
+	if( fire ) {
+		FireStatus result = FirePrimary( enemy->GetID() );
+
+		// If this firing group isn't doing anything, switch
+		if( result == FireNoAmmo || result == FireEmptyGroup ) {
+			FireSecondary( enemy->GetID() );
+		}
+	}
+
+	if( dist > standoff && fabs( GetDirectionTowards( enemy->GetWorldPosition() ) ) < ALIGNED_ANGLE ) {
+		Accelerate( false );
+	}
+
+	return dist;
+}
+
+/**\brief Fly directly away from a threat.
+ * \param threat World coordinate to get away from
+ * \param safeRadius Distance from the threat that counts as safe
+ * \return true once the ship is beyond safeRadius
+ */
+bool NPC::Flee( Coordinate threat, float safeRadius ) {
+	Rotate( -GetDirectionTowards( threat ), false );
+	Accelerate( false );
+
+	return (threat - GetWorldPosition()).GetMagnitudeSquared() > safeRadius * safeRadius;
+}
+
+
+/**\brief Capture the AI Ship, and possibly debugging information.
  *
  * When the "options/development/debug-ai" flag is set, this will display the
  * current stateMachine and state below the Ship Spite.
  *
  * \see OPTION
  */
-void NPC::Draw(){
-	this->Ship::Draw();
+void NPC::Capture( Snapshot *snapshot ){
+	this->Ship::Capture( snapshot );
 
 	//if( OPTION(int,"options/development/debug-ai") ) {
 		Coordinate position = this->GetScreenPosition();
-		SansSerif->SetColor( WHITE );
-		SansSerif->Render( position.GetX(), position.GetY() + GetImage()->GetHalfHeight(), stateMachine);
-		SansSerif->Render(position.GetX(), position.GetY() + GetImage()->GetHalfHeight() + 20, state);
+		Coordinate oldPosition = this->GetOldScreenPosition();
+		Coordinate below( 0, GetImage()->GetHalfHeight() );
+		snapshot->AddText( SansSerif, WHITE, stateMachine, position + below, oldPosition + below );
+		below += Coordinate( 0, 20 );
+		snapshot->AddText( SansSerif, WHITE, state, position + below, oldPosition + below );
 	//}
 }
 
@@ -356,14 +533,6 @@ bool NPC::CompareAI(Sprite* a, Sprite* b) {
 	}
 	//printf("finished Comp AI\n");
 }
-/**\fn AI::SetStateMachine(string _machine)
- * \brief Sets the state machine.
- */
-
-/**\fn AI::SetState(string _state)
- * \brief Sets the current state.
- */
-
 /**\fn AI::SetAlliance(Alliance* alliance)
  * \brief Sets the current alliance.
  */
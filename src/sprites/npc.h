@@ -15,14 +15,16 @@
 
 #define COMBAT_RANGE 1000 ///< Radius of ships involved in any specific battle
 #define COMBAT_RANGE_SQUARED (COMBAT_RANGE*COMBAT_RANGE) ///< Used for fast range checking.
+#define ALIGNED_ANGLE 1.0 ///< Degrees within which a ship is considered to be facing its heading.
 
 class NPC : public Ship {
 	public:
 		NPC(string name, string machine);
+		~NPC();
 
 		// Overloaded Sprite Mechanics:
 		void Update( lua_State *L );
-		void Draw();
+		void Capture( Snapshot *snapshot );
 
 		// Flavor Mechanics:
 
@@ -35,10 +37,10 @@ class NPC : public Ship {
 		// State Machine Mechanics:
 
 		string GetStateMachine() { return stateMachine; }
-		void SetStateMachine(string _machine) { stateMachine = _machine; }
+		void SetStateMachine(string _machine);
 
 		string GetState() { return state; }
-		void SetState(string _state)  { state = _state; }
+		void SetState(string _state);
 
 		// Combat Mechanics:
 
@@ -53,6 +55,14 @@ class NPC : public Ship {
 
 		void Killed( lua_State *L );
 
+		// Behavior Mechanics:
+
+		bool TravelTo( Coordinate destination, float arrivalRadius );
+		bool Dock();
+		void Orbit( Coordinate center, float nearRadius, float farRadius );
+		float Attack( Sprite* enemy, float standoff, bool fire );
+		bool Flee( Coordinate threat, float safeRadius );
+
 	private:
 		string name; ///< The AI's name.  This should be the name of the ship's pilot.
 		Alliance* allegiance; ///< Which Alliance this ship hails to.
@@ -61,7 +71,15 @@ class NPC : public Ship {
 		// The state machine is essentially a flow chart
 		string stateMachine; ///< The name of the State Machine.
 		string state; ///< The current state of the state machine.
+		lua_State *thread; ///< The coroutine running the state machine, NULL until the first Decide.
+		int threadReference; ///< Registry reference that keeps the coroutine alive.
+		bool running; ///< The coroutine is being resumed right now.
+		bool restart; ///< The coroutine asked for a new state or State Machine while it was running.
 		void Decide( lua_State *L );
+		bool StartThread( lua_State *L );
+		void StopThread( lua_State *L );
+
+		Uint32 dockedUntil; ///< Timestamp at which the current docking is complete, 0 when not docked.
 
 		// AI Combat Mechanics:
 
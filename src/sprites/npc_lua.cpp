@@ -21,6 +21,8 @@
 #include "engine/commodities.h"
 #include "engine/scenario_lua.h"
 
+static ResourceHandle<Sound> explosionSound( "data/audio/effects/18384__inferno__largex.wav.ogg" );
+
 /**\class NPC_Lua
  * \brief Lua bridge for NPC.*/
 
@@ -56,6 +58,13 @@ void NPC_Lua::RegisterAI(lua_State *L){
 		{"Jump", &NPC_Lua::ShipJump},
 		{"GetJumpableCoordinates", &NPC_Lua::ShipGetJumpableCoordinates},
 		{"SetLuaControlFunc", &NPC_Lua::ShipSetLuaControlFunc},
+
+		// Behaviors
+		{"TravelTo", &NPC_Lua::ShipTravelTo},
+		{"DockAndWait", &NPC_Lua::ShipDockAndWait},
+		{"Orbit", &NPC_Lua::ShipOrbit},
+		{"Attack", &NPC_Lua::ShipAttack},
+		{"Flee", &NPC_Lua::ShipFlee},
 		
 		// Power Distribution
 		{"GetShieldBooster", &NPC_Lua::ShipGetShieldBooster},
@@ -363,9 +372,8 @@ int NPC_Lua::ShipExplode(lua_State* L){
 		if(ai==NULL) return 0;
 		LogMsg(INFO,"A %s Exploded!",(ai)->GetModelName().c_str());
 		// Play explode sound
-		Sound *explodesnd = Sound::Get("data/audio/effects/18384__inferno__largex.wav.ogg");
 		if(OPTION(int, "options/sound/explosions"))
-			explodesnd->Play(
+			explosionSound->Play(
 				(ai)->GetWorldPosition() - Scenario_Lua::GetScenario(L)->GetCamera()->GetFocusCoordinate());
 		Scenario_Lua::GetScenario(L)->GetSpriteManager()->Add(
 			new Effect((ai)->GetWorldPosition(), "data/animations/explosion1.ani", 0) );
@@ -1822,6 +1830,149 @@ int NPC_Lua::ShipGetJumpableCoordinates(lua_State* L) {
 	return 2;
 }
 
+// Ship Behaviors
+//
+// These run a whole AI movement step natively so that the state machines in
+// npc.lua only need one call per tick. Positions may be given either as a
+// sprite ID or as an x, y pair.
+
+/**\brief Validates that a Ship is an NPC, since only NPCs have behaviors.
+ */
+NPC* NPC_Lua::checkNPC(lua_State *L, int index) {
+	NPC* ai = checkShip(L, index);
+	if( ai == NULL ) return NULL;
+	if( ai->GetDrawOrder() != DRAW_ORDER_SHIP ) {
+		luaL_error(L, "Only NPCs have AI behaviors");
+		return NULL;
+	}
+	return ai;
+}
+
+/**\brief Reads a position from either a sprite ID or an x, y pair.
+ * \return false if the sprite no longer exists
+ */
+bool NPC_Lua::checkPosition(lua_State *L, int index, bool pair, Coordinate *c) {
+	if( pair ) {
+		*c = Coordinate( luaL_checknumber(L, index), luaL_checknumber(L, index + 1) );
+		return true;
+	}
+
+	Sprite* s = Scenario_Lua::GetScenario(L)->GetSpriteManager()->GetSpriteByID( luaL_checkinteger(L, index) );
+	if( s == NULL ) return false;
+	*c = s->GetWorldPosition();
+	return true;
+}
+
+/**\brief Lua callable function to fly towards a point.
+ * \returns true once arrived, nil if the destination sprite is gone
+ * \sa NPC::TravelTo
+ */
+int NPC_Lua::ShipTravelTo(lua_State* L) {
+	int n = lua_gettop(L); // Number of arguments
+	if( (n != 3) && (n != 4) ) {
+		return luaL_error(L, "Got %d arguments expected 3 or 4 (ship, id or x and y, radius)", n);
+	}
+
+	NPC* ai = checkNPC(L, 1);
+	if( ai == NULL ) return 0;
+
+	Coordinate destination;
+	if( !checkPosition(L, 2, n == 4, &destination) ) return 0;
+	float radius = static_cast<float>( luaL_checknumber(L, n) );
+
+	lua_pushboolean(L, ai->TravelTo( destination, radius ) );
+	return 1;
+}
+
+/**\brief Lua callable function to stop and wait out a docking.
+ * \returns true once the docking is complete
+ * \sa NPC::Dock
+ */
+int NPC_Lua::ShipDockAndWait(lua_State* L) {
+	int n = lua_gettop(L); // Number of arguments
+	if( n != 1 ) {
+		return luaL_error(L, "Got %d arguments expected 1 (ship)", n);
+	}
+
+	NPC* ai = checkNPC(L, 1);
+	if( ai == NULL ) return 0;
+
+	lua_pushboolean(L, ai->Dock() );
+	return 1;
+}
+
+/**\brief Lua callable function to circle around a point.
+ * \returns the distance to the center, nil if the center sprite is gone
+ * \sa NPC::Orbit
+ */
+int NPC_Lua::ShipOrbit(lua_State* L) {
+	int n = lua_gettop(L); // Number of arguments
+	if( (n != 4) && (n != 5) ) {
+		return luaL_error(L, "Got %d arguments expected 4 or 5 (ship, id or x and y, near, far)", n);
+	}
+
+	NPC* ai = checkNPC(L, 1);
+	if( ai == NULL ) return 0;
+
+	Coordinate center;
+	if( !checkPosition(L, 2, n == 5, &center) ) return 0;
+	float nearRadius = static_cast<float>( luaL_checknumber(L, n - 1) );
+	float farRadius = static_cast<float>( luaL_checknumber(L, n) );
+
+	ai->Orbit( center, nearRadius, farRadius );
+
+	lua_pushnumber(L, (center - ai->GetWorldPosition()).GetMagnitude() );
+	return 1;
+}
+
+/**\brief Lua callable function to approach a ship and optionally fire at it.
+ * \returns the distance to the target, nil if the target is gone or destroyed
+ * \sa NPC::Attack
+ */
+int NPC_Lua::ShipAttack(lua_State* L) {
+	int n = lua_gettop(L); // Number of arguments
+	if( n != 4 ) {
+		return luaL_error(L, "Got %d arguments expected 4 (ship, target id, standoff, fire)", n);
+	}
+
+	NPC* ai = checkNPC(L, 1);
+	if( ai == NULL ) return 0;
+
+	Sprite* target = Scenario_Lua::GetScenario(L)->GetSpriteManager()->GetSpriteByID( luaL_checkinteger(L, 2) );
+	if( target == NULL ) return 0;
+	if( !(target->GetDrawOrder() & (DRAW_ORDER_SHIP | DRAW_ORDER_PLAYER)) ) {
+		return luaL_error(L, "Sprite ID %d is not a ship or player", target->GetID() );
+	}
+	if( ((Ship*)target)->GetHullIntegrityPct() <= 0 ) return 0;
+
+	float standoff = static_cast<float>( luaL_checknumber(L, 3) );
+	bool fire = lua_toboolean(L, 4) != 0;
+
+	lua_pushnumber(L, ai->Attack( target, standoff, fire ) );
+	return 1;
+}
+
+/**\brief Lua callable function to fly away from a point.
+ * \returns true once safe, nil if the threatening sprite is gone
+ * \sa NPC::Flee
+ */
+int NPC_Lua::ShipFlee(lua_State* L) {
+	int n = lua_gettop(L); // Number of arguments
+	if( (n != 3) && (n != 4) ) {
+		return luaL_error(L, "Got %d arguments expected 3 or 4 (ship, id or x and y, radius)", n);
+	}
+
+	NPC* ai = checkNPC(L, 1);
+	if( ai == NULL ) return 0;
+
+	Coordinate threat;
+	if( !checkPosition(L, 2, n == 4, &threat) ) return 0;
+	float radius = static_cast<float>( luaL_checknumber(L, n) );
+
+	lua_pushboolean(L, ai->Flee( threat, radius ) );
+	return 1;
+}
+
 /** \brief Add an escort to the list to be put into the XML saved game file
  *  \details Keeps track of a bare minimum of information, but not details like hull integrity or non-standard outfits.
  */
@@ -58,6 +58,13 @@ class NPC_Lua {
 		static int ShipJump(lua_State* L);
 		static int ShipGetJumpableCoordinates(lua_State* L);
 
+		// Behaviors
+		static int ShipTravelTo(lua_State* L);
+		static int ShipDockAndWait(lua_State* L);
+		static int ShipOrbit(lua_State* L);
+		static int ShipAttack(lua_State* L);
+		static int ShipFlee(lua_State* L);
+
 		// Power Distribution
 		static int ShipGetShieldBooster(lua_State* L);
 		static int ShipGetEngineBooster(lua_State* L);
@@ -118,6 +125,8 @@ class NPC_Lua {
 		static int ShipGetMerciful(lua_State* L);
 		static int ShipSetMerciful(lua_State* L);
 	private:
+		static NPC *checkNPC(lua_State *L, int index);
+		static bool checkPosition(lua_State *L, int index, bool pair, Coordinate *c);
 };
 
 #endif /* __H_NPC_LUA_ */
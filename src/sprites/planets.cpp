@@ -54,6 +54,7 @@ Planet& Planet::operator=(const Planet& other) {
 	name = other.name;
 	alliance = other.alliance;
 	landable = other.landable;
+	forbidden = other.forbidden;
 	technologies = other.technologies;
 	surface = other.surface;
 	summary = other.summary;
@@ -84,6 +85,7 @@ Planet::Planet(
 	):
 	alliance(_alliance),
 	landable(_landable),
+	forbidden(false),
 	surface(_surface),
 	summary(_summary),
 	technologies(_technologies)
@@ -115,12 +117,7 @@ bool Planet::FromXMLNode( xmlDocPtr doc, xmlNodePtr node ) {
 	Coordinate pos;
 
 	if( (attr = FirstChildNamed(node, "alliance")) ){
-		value = NodeToString(doc,attr);
-		alliance = Menu::GetCurrentScenario()->GetAlliances()->GetAlliance(value);
-		if(alliance == NULL) {
-			LogMsg(ERR, "Could not create Planet '%s'. Unknown Alliance '%s'.", this->GetName().c_str(), value.c_str());
-			return false;
-		}
+		allianceName = NodeToString(doc,attr);
 	} else return false;
 
 	if( (attr = FirstChildNamed(node, "x")) ){
@@ -147,7 +144,7 @@ bool Planet::FromXMLNode( xmlDocPtr doc, xmlNodePtr node ) {
 	} else return false;
 
 	if( (attr = FirstChildNamed(node,"surface-image")) ){
-		this->surface = Image::Get( NodeToString(doc,attr) );
+		this->surface = Image::Defer( NodeToString(doc,attr) );
 	} else return false;
 
 	if( (attr = FirstChildNamed(node,"summary")) ){
@@ -155,10 +152,36 @@ bool Planet::FromXMLNode( xmlDocPtr doc, xmlNodePtr node ) {
 	} else return false;
 
 	for( attr = FirstChildNamed(node,"technology"); attr!=NULL; attr = NextSiblingNamed(attr,"technology") ){
-		value = NodeToString(doc,attr);
-		Technology *tech = Menu::GetCurrentScenario()->GetTechnologies()->GetTechnology( value );
-		technologies.push_back(tech);
+		technologyNames.push_back( NodeToString(doc,attr) );
+	}
+
+	return true;
+}
+
+/**\brief Finds the Alliance and the Technologies that FromXMLNode named.
+ */
+bool Planet::Link( void ) {
+	Scenario *scenario = Menu::GetCurrentScenario();
+	list<string>::iterator i;
+
+	if( !allianceName.empty() ) {
+		alliance = scenario->GetAlliances()->GetAlliance( allianceName );
+		if(alliance == NULL) {
+			LogMsg(ERR, "Could not create Planet '%s'. Unknown Alliance '%s'.", this->GetName().c_str(), allianceName.c_str());
+			return false;
+		}
+		allianceName = "";
+	}
+
+	for( i = technologyNames.begin(); i != technologyNames.end(); ++i ) {
+		Technology *tech = scenario->GetTechnologies()->GetTechnology( *i );
+		if(tech == NULL) {
+			LogMsg(ERR, "Planet '%s' has an unknown Technology '%s'.", this->GetName().c_str(), i->c_str());
+		} else {
+			technologies.push_back(tech);
+		}
 	}
+	technologyNames.clear();
 	technologies.sort();
 	technologies.unique();
 
@@ -40,6 +40,7 @@ class Planet : public Sprite, public Component {
 		virtual int GetDrawOrder( void ) { return( DRAW_ORDER_PLANET ); }
 		
 		bool FromXMLNode( xmlDocPtr doc, xmlNodePtr node );
+		bool Link( void );
 		xmlNodePtr ToXMLNode(string componentName);
 		
 		~Planet();
@@ -65,6 +66,8 @@ class Planet : public Sprite, public Component {
 		Image* surface;
 		string summary;
 		list<Technology*> technologies;
+		string allianceName; ///< Until Link finds the Alliance
+		list<string> technologyNames; ///< Until Link finds the Technologies
 };
 
 // Class that holds list of all planets; manages them
@@ -7,6 +7,7 @@
  */
 
 #include "common.h"
+#include "engine/calendar.h"
 #include "engine/scenario_lua.h"
 #include "menu.h"
 #include "includes.h"
@@ -35,10 +36,11 @@ Player* Player::Load( string filename ) {
 
 	Player* newPlayer = new Player();
 
-	File xmlfile = File (filename);
+	File xmlfile(filename);
 	long filelen = xmlfile.GetLength();
-	char *buffer = xmlfile.Read();
+	const char *buffer = xmlfile.Map();
 	doc = xmlParseMemory( buffer, static_cast<int>(filelen) );
+	xmlfile.Unmap();
 	cur = xmlDocGetRootElement( doc );
 
 	newPlayer->FromXMLNode( doc, cur );
@@ -170,18 +172,10 @@ void Player::Land( lua_State *L, Planet* planet ){
 	SetMomentum( Coordinate(0,0) );
 
 	// Run Land function for each Mission
-	bool missionOver;
 	list<Mission*>::iterator i = missions.begin();
 
 	while( i != missions.end() ) {
-		missionOver = (*i)->Land();
-		if( missionOver ) {
-			LogMsg(INFO, "Completed the Mission '%s'", (*i)->GetName().c_str() );
-			// Remove this completed mission from the list
-			i = missions.erase( i );
-		} else {
-			++i;
-		}
+		i = FinishMission( i, (*i)->Land() );
 	}
 
 	lastPlanet = planet->GetName();
@@ -194,22 +188,31 @@ Player::Player() {
 	this->isPlayerFlag = true;
 	this->SetRadarColor( WHITE );
 	this->hasJumped = false;
+	this->lastDay = -1;
 }
 
 /**\brief Run the Player Update
  */
 void Player::Update( lua_State *L ) {
-	bool missionOver;
+	Scenario *scenario = Scenario_Lua::GetScenario(L);
 	list<Mission*>::iterator i;
 
-	for( i = missions.begin(); i != missions.end(); ++i ) {
-		missionOver = (*i)->Update();
-		if( missionOver ) {
-			LogMsg(INFO, "Completed the Mission %s", (*i)->GetName().c_str() );
+	// Tell the Missions when the day changes
+	Calendar *calendar = scenario->GetCalendar();
+	int today = calendar->GetEpoch() * PERIODS_PER_EPOCH + calendar->GetPeriod();
+	bool newDay = (lastDay != -1) && (today != lastDay);
+	lastDay = today;
+
+	Uint32 now = Timer::GetTicks();
+	SpriteManager *sprites = scenario->GetSpriteManager();
 
-			// Remove this completed mission from the list
-			i = missions.erase( i );
+	i = missions.begin();
+	while( i != missions.end() ) {
+		if( newDay && (*i)->NewDay() ) {
+			i = FinishMission( i, true );
+			continue;
 		}
+		i = FinishMission( i, (*i)->Update( now, GetWorldPosition(), sprites ) );
 	}
 
 	if(luaControlFunc != ""){
@@ -219,6 +222,39 @@ void Player::Update( lua_State *L ) {
 	Ship::Update( L );
 }
 
+/**\brief Tell the Missions that the Player has jumped into a new Sector.
+ */
+void Player::ArrivedInSector( string sectorName ) {
+	list<Mission*>::iterator i = missions.begin();
+
+	while( i != missions.end() ) {
+		i = FinishMission( i, (*i)->Jump( sectorName ) );
+	}
+}
+
+/**\brief Tell the Missions that a ship has been destroyed or has left the Sector.
+ */
+void Player::ShipRemoved( int spriteID ) {
+	list<Mission*>::iterator i = missions.begin();
+
+	while( i != missions.end() ) {
+		i = FinishMission( i, (*i)->Kill( spriteID ) );
+	}
+}
+
+/**\brief Remove a Mission from the list once it is over.
+ * \returns The next Mission in the list
+ */
+list<Mission*>::iterator Player::FinishMission( list<Mission*>::iterator i, bool missionOver ) {
+	if( !missionOver ) {
+		return ++i;
+	}
+
+	LogMsg(INFO, "Completed the Mission '%s'", (*i)->GetName().c_str() );
+	delete (*i);
+	return missions.erase( i );
+}
+
 string Player::GetFileName() {
 	return "saves/" + GetName() + ".xml";
 }
@@ -48,6 +48,8 @@ class Player : public Ship {
 		void AcceptMission( Mission *mission );
 		void RejectMission( string missionName );
 		list<Mission*>* GetMissions() { return &missions; }
+		void ArrivedInSector( string sectorName );
+		void ShipRemoved( int spriteID );
 
 		// Favor Related Functions
 		int GetFavor( Alliance* alliance );
@@ -69,10 +71,13 @@ class Player : public Ship {
 
 		bool ConfigureWeaponSlots(xmlDocPtr, xmlNodePtr);
 	private:
+		list<Mission*>::iterator FinishMission( list<Mission*>::iterator i, bool missionOver );
+
 		string name;
 		time_t lastLoadTime;
 		string lastPlanet;
 		list<Mission*> missions;
+		int lastDay; ///< The Calendar day that Missions were last told about
 		map<Alliance*,int> favor;
 		string luaControlFunc;
 		bool hasJumped;
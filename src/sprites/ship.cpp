@@ -12,6 +12,7 @@
 #include "sprites/ship.h"
 #include "engine/camera.h"
 #include "engine/scenario_lua.h"
+#include "engine/snapshot.h"
 #include "utilities/timer.h"
 #include "utilities/trig.h"
 #include "sprites/spritemanager.h"
@@ -32,6 +33,10 @@
 
 #define ACCELERATION_FLARE_FADEOUT_DURATION 50
 
+static ResourceHandle<Sound> jumpStartSound( "data/audio/engines/jump_start.ogg" );
+static ResourceHandle<Sound> jumpEndSound( "data/audio/engines/jump_end.ogg" );
+static ResourceHandle<Sound> explosionSound( "data/audio/effects/18384__inferno__largex.wav.ogg" );
+
 /**\class Ship
  * \brief A Ship Sprite that moves, Fires Weapons, has cargo, and ultimately explodes.
  * \details
@@ -362,7 +367,7 @@ void Ship::Decelerate( void ) {
 
 	Coordinate momentum = GetMomentum();
 
-	int logicalFramesToStop = SECONDS_TO_FULL_STOP * LOGIC_FPS;
+	int logicalFramesToStop = SECONDS_TO_FULL_STOP * Timer::GetLogicFPS();
 	float deceleration = (1.0 - (1.0 / logicalFramesToStop));
 
 	momentum *= deceleration;
@@ -518,7 +523,7 @@ void Ship::Update( lua_State *L ) {
 				Player *player = (Player *)this;
 				player->Jumped();
 
-				Sound *jumpSound = Sound::Get("data/audio/engines/jump_end.ogg");
+				Sound *jumpSound = jumpEndSound;
 				jumpSound->SetVolume(20);
  				if(jumpSound) { jumpSound->Play(); }
 
@@ -581,7 +586,7 @@ void Ship::Update( lua_State *L ) {
 
 				// Begin the jump SFX if player ...
 				if(isPlayer()) {
-					Sound *jumpSound = Sound::Get("data/audio/engines/jump_start.ogg");
+					Sound *jumpSound = jumpStartSound;
 					jumpSound->SetVolume(10);
  					if(jumpSound) { jumpSound->Play(); }
 				}
@@ -598,13 +603,14 @@ void Ship::Update( lua_State *L ) {
 	}
 }
 
-/**\brief Draw function.
- * \sa Sprite::Draw()
+/**\brief Capture function.
+ * \sa Sprite::Capture()
  */
-void Ship::Draw( void ) {
+void Ship::Capture( Snapshot *snapshot ) {
 	Trig *trig = Trig::Instance();
 	Coordinate position = GetWorldPosition();
 	Coordinate screenPosition = GetScreenPosition();
+	Coordinate oldScreenPosition = GetOldScreenPosition();
 	
     // // Shields
 	// Video::DrawFilledCircle(
@@ -618,7 +624,7 @@ void Ship::Draw( void ) {
 		//jumpDir *= ((float)Timer::GetRealTicks() - (float)status.jumpStartTime) / 1000.0;
 	}
 
-	Sprite::Draw();
+	Sprite::Capture( snapshot );
 
 	// Draw the flare animation, if required
 	Uint32 ticksAfterLastAccel = Timer::TicksSince(status.lastAccelerationAt);
@@ -632,8 +638,10 @@ void Ship::Draw( void ) {
 				static_cast<float>(screenPosition.GetX()),
 				static_cast<float>(screenPosition.GetY()), &tx, &ty,
 				static_cast<float>( trig->DegToRad( direction ) ));
-		
-		flareAnimation->Draw( (int)tx, (int)ty, direction, 1.0f );
+
+		// The flare keeps the same offset from the ship
+		Coordinate flare = Coordinate( tx, ty ) - screenPosition;
+		snapshot->AddImage( flareAnimation->GetFrame(), screenPosition + flare, oldScreenPosition + flare, direction, 1.0f );
 
 		status.isAccelerating = false;
 	}
@@ -649,7 +657,7 @@ void Ship::Draw( void ) {
 				static_cast<float>(position.GetScreenX()),
 				static_cast<float>(position.GetScreenY()), &tx, &ty,
 				static_cast<float>( trig->DegToRad( direction ) ));
-		flareAnimation->Draw( (int)tx, (int)ty, direction );
+		snapshot->AddImage( flareAnimation->GetFrame(), Coordinate( tx, ty ), Coordinate( tx, ty ), direction );
 
 		status.isRotatingLeft = false;
 		status.isRotatingRight = false;
@@ -784,8 +792,7 @@ void Ship::Explode( lua_State *L ) {
 
 	// Play explode sound
 	if(OPTION(int, "options/sound/explosions")) {
-		Sound *explodesnd = Sound::Get("data/audio/effects/18384__inferno__largex.wav.ogg");
-		explodesnd->Play( GetWorldPosition() - camera->GetFocusCoordinate());
+		explosionSound->Play( GetWorldPosition() - camera->GetFocusCoordinate());
 	}
 
 	// Create Explosion
@@ -31,7 +31,7 @@ class Ship : public Sprite {
 		
 		// Fundamental Sprite Mechanics
 		void Update( lua_State *L );
-		void Draw( void );
+		void Capture( Snapshot *snapshot );
 
 		// Movement Mechanics
 		void Rotate( float direction, bool rotatingToJump );
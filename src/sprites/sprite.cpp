@@ -10,6 +10,7 @@
 #include "includes.h"
 #include "common.h"
 #include "engine/camera.h"
+#include "engine/snapshot.h"
 #include "sprites/sprite.h"
 #include "utilities/log.h"
 #include "utilities/timer.h"
@@ -70,19 +71,34 @@ Coordinate Sprite::GetWorldPosition( void ) const {
 	return worldPosition;
 }
 
+/**\brief Moves this Sprite without flying it there.
+ * \details The Sprite won't be interpolated from where it was.
+ */
 void Sprite::SetWorldPosition( Coordinate coord ) {
 	worldPosition = coord;
+	interpolationUpdateCheck = 0;
 }
 
 Coordinate Sprite::GetScreenPosition( void ) const {
 	return screenPosition;
 }
 
+/**\brief The screen position before the last Update
+ * \details New Sprites don't have one yet, so they stay where they are.
+ */
+Coordinate Sprite::GetOldScreenPosition( void ) const {
+	if( interpolationUpdateCheck < 2 ) {
+		return screenPosition;
+	}
+	return oldScreenPosition;
+}
+
 /**\brief Move this Sprite in the direction of their current momentum.
  * \details Since this is a space simulation, there is no Friction; momentum does not decrease over time.
+ *          Momentum is per frame at LOGIC_FPS, so longer logical frames move further.
  */
 void Sprite::Update( lua_State *L ) {
-	worldPosition += momentum;
+	worldPosition += momentum * Timer::GetTimeScale();
 	acceleration = lastMomentum - momentum;
 	lastMomentum = momentum;
 }
@@ -96,35 +112,27 @@ void Sprite::UpdateScreenCoordinates( void ) {
 	if(interpolationUpdateCheck < 2) interpolationUpdateCheck++;
 }
 
-/**\brief Draw
- * \details The Sprite is drawn centered on wx,wy.
- *          This will attempt to Draw the sprite even if wx,wy are completely off the Screen.
- *          Avoid drawing sprites that are too far off the Screen.
- * \sa SpriteManager::Draw
+/**\brief Adds this Sprite to a Snapshot
+ * \details The Sprite is drawn centered on its screen position.
+ *          This will add the sprite even if it is completely off the Screen.
+ *          Avoid capturing sprites that are too far off the Screen.
+ * \sa SpriteManager::Capture
  */
-void Sprite::Draw( void ) {
-	// double fframe = Timer::GetFFrame();
-
+void Sprite::Capture( Snapshot *snapshot ) {
 	if( image ) {
-		// if(interpolateOn && (interpolationUpdateCheck >= 2)) {
-		// 	Coordinate interpolatedScreenPosition;
-
-		// 	interpolatedScreenPosition.SetX(oldScreenPosition.GetX() * (1.0f - fframe) + screenPosition.GetX() * fframe);
-		// 	interpolatedScreenPosition.SetY(oldScreenPosition.GetY() * (1.0f - fframe) + screenPosition.GetY() * fframe);
+		Coordinate oldPosition = GetOldScreenPosition();
+		Coordinate below( 0, GetImage()->GetHalfHeight() );
 
-		// 	image->DrawCentered( interpolatedScreenPosition.GetX(), interpolatedScreenPosition.GetY(), angle );
-		// } else {
-			image->DrawCentered( screenPosition.GetX(), screenPosition.GetY(), angle );
-		// }
+		snapshot->AddImage( image, screenPosition, oldPosition, angle );
 
-				SansSerif->SetColor( WHITE );
 		std::ostringstream stringStream;
   		stringStream << "(" << worldPosition.GetX() << "," << worldPosition.GetY() << ")";;
   		string coords = stringStream.str();
-		SansSerif->Render( screenPosition.GetX(), screenPosition.GetY() + GetImage()->GetHalfHeight(), coords);
+		snapshot->AddText( SansSerif, WHITE, coords, screenPosition + below, oldPosition + below );
 		std::ostringstream stringStream2;
 		stringStream2 << this->GetAngle();
-		SansSerif->Render( screenPosition.GetX(), screenPosition.GetY() + GetImage()->GetHalfHeight() + 50, stringStream2.str());
+		below += Coordinate( 0, 50 );
+		snapshot->AddText( SansSerif, WHITE, stringStream2.str(), screenPosition + below, oldPosition + below );
 
 	} else {
 		LogMsg(WARN, "Attempt to draw a sprite before an image was assigned." );
@@ -14,6 +14,8 @@
 #include "utilities/lua.h"
 #include "utilities/coordinate.h"
 
+class Snapshot;
+
 // With the draw order, higher numbers are drawn later (on top)
 // By using non-overlapping bits we can bit mask during searches
 #define DRAW_ORDER_PLANET              0x0001 ///< Draw order for Planet Sprites
@@ -32,10 +34,11 @@ class Sprite {
 		void SetWorldPosition( Coordinate coord );
 
 		Coordinate GetScreenPosition( void ) const;
+		Coordinate GetOldScreenPosition( void ) const;
 
 		virtual void Update( lua_State *L );
 		void UpdateScreenCoordinates( void );
-		virtual void Draw( void );
+		virtual void Capture( Snapshot *snapshot );
 
 		int GetID( void ) { return id; }
 
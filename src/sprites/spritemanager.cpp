@@ -14,6 +14,7 @@
 #include "utilities/log.h"
 #include "engine/camera.h"
 #include "engine/scenario_lua.h"
+#include "engine/snapshot.h"
 
 /** \defgroup Sprites Sprite Objects and their Management
  * @{
@@ -235,9 +236,9 @@ bool compareSpritePtrs(Sprite* a, Sprite* b){
 	}
 }
 
-/**\brief Draws the current sprites
+/**\brief Adds the sprites near the focus to a Snapshot, in drawing order
  */
-void SpriteManager::Draw( Coordinate focus ) {
+void SpriteManager::Capture( Snapshot *snapshot, Coordinate focus ) {
 	list<Sprite *>::iterator i;
 	float r = (Video::GetHalfHeight() < Video::GetHalfWidth() ? Video::GetHalfWidth() : Video::GetHalfHeight()) * V_SQRT2;
 	list<Sprite*> *onScreen = GetSpritesNear(focus, r, DRAW_ORDER_ALL);
@@ -245,7 +246,7 @@ void SpriteManager::Draw( Coordinate focus ) {
 	onScreen->sort(compareSpritePtrs);
 
 	for( i = onScreen->begin(); i != onScreen->end(); ++i ) {
-		(*i)->Draw();
+		(*i)->Capture( snapshot );
 	}
 
 	delete onScreen;
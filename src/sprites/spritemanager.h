@@ -25,7 +25,7 @@ class SpriteManager {
 
 		void Update( lua_State *L, bool lowFps);
 		void UpdateScreenCoordinates( void );
-		void Draw( Coordinate focus );
+		void Capture( Snapshot *snapshot, Coordinate focus );
 
 		int GetAIShipCount( void );
 
@@ -22,7 +22,7 @@ class Button : public Widget {
 		
 		void Draw( int relx = 0, int rely = 0 );
 
-		void SetText(string text) { this->name = text; }
+		void SetText(string text) { this->name = text; Invalidate(); }
 		string GetText() { return this->name; }
 
 		virtual string GetType( void ) {return string("Button");}
@@ -7,6 +7,8 @@
 
 #include "includes.h"
 #include "common.h"
+#include "graphics/spritebatch.h"
+#include "graphics/video.h"
 #include "utilities/xmlfile.h"
 #include "utilities/log.h"
 #include "ui/ui.h"
@@ -20,12 +22,15 @@
  * \brief Container is a container class for other widgets.
  */
 
+vector<SDL_Texture*> Container::retiredCaches;
+
 /**\brief Constructor, initializes default values.*/
 Container::Container( string _name, bool _mouseHandled ):
 	mouseHandled( _mouseHandled ), keyboardFocus( NULL ), mouseHover( NULL ),
 	lmouseDown( NULL ), mmouseDown( NULL ), rmouseDown( NULL ),
 	vscrollbar( NULL ),
-	formbutton( NULL )
+	formbutton( NULL ),
+	cache( NULL ), cacheW( 0 ), cacheH( 0 ), dirty( true )
 {
 	name = _name;
 	InnerRect.left = InnerRect.top = InnerRect.right = InnerRect.bottom = 0;
@@ -52,6 +57,16 @@ Container::~Container( void ) {
 
 	vscrollbar = NULL;
 	formbutton = NULL;
+
+	if( cache != NULL ) {
+		// Lua can close windows from the logic thread
+		if( Video::IsRenderThread() ) {
+			SDL_DestroyTexture( cache );
+		} else {
+			retiredCaches.push_back( cache );
+		}
+		cache = NULL;
+	}
 }
 
 /**\brief Adds a child to the current container.
@@ -65,6 +80,7 @@ Container *Container::AddChild( Widget *widget ) {
 		}
 		children.push_back( widget );
 		widget->parent = this;
+		Invalidate();
 		//LogMsg(INFO, "Adding %s %s %p to %s", widget->GetType().c_str(), widget->GetName().c_str(), widget, GetName().c_str() );
 		// Check to see if widget is past the bounds.
 		ResetScrollBars();
@@ -77,6 +93,7 @@ void Container::SetInnerRect( int left, int top, int right, int bottom ) {
 	InnerRect.top = top;
 	InnerRect.right = right;
 	InnerRect.bottom = bottom;
+	Invalidate();
 }
 
 /**\brief Deletes a child from the current container.
@@ -99,6 +116,7 @@ bool Container::DelChild( Widget *widget ){
 			delete (*i);
 			i = children.erase( i );
 			ResetInput();
+			Invalidate();
 
 			// Don't reset the Scrollbars when it is a scrollbar being deleted
 			// This will cause a stack overflow.
@@ -129,6 +147,7 @@ bool Container::Detach( Widget *widget ) {
 	for( i = children.begin(); i != children.end(); ++i ) {
 		if( (*i) == widget ) {
 			i = children.erase( i );
+			Invalidate();
 			return true;
 		}
 	}
@@ -146,6 +165,7 @@ void Container::Empty( void ){
 	children.clear();
 
 	ResetInput();
+	Invalidate();
 }
 
 /**\brief Reset focus and events.
@@ -608,6 +628,7 @@ Widget *Container::PrevChild( Widget* widget, int mask) {
 }
 
 /**\brief Draws this widget and all children widgets.
+ * \details The Windows and Frames on a screen are drawn from their caches.
  */
 void Container::Draw( int relx, int rely ) {
 	int x, y;
@@ -615,8 +636,13 @@ void Container::Draw( int relx, int rely ) {
 	x = GetX() + relx + InnerRect.left;
 	y = GetY() + rely + InnerRect.top;
 
+	// A screen covers the whole display, so it has nothing to crop
+	bool screen = ( parent == NULL );
+
 	// Crop to prevent child widgets from spilling
-	Video::SetCropRect(x, y, this->w - InnerRect.right - InnerRect.left, this->h - InnerRect.bottom - InnerRect.top);
+	if( !screen ) {
+		Video::SetCropRect(x, y, this->w - InnerRect.right - InnerRect.left, this->h - InnerRect.bottom - InnerRect.top);
+	}
 
 	// Draw any children
 	list<Widget *>::iterator i;
@@ -633,14 +659,106 @@ void Container::Draw( int relx, int rely ) {
 			yscroll = vscrollbar->GetPos();
 		}
 
-		(*i)->Draw( x, y - yscroll );
+		if( screen && ((*i)->GetMask() & WIDGET_CONTAINER) ) {
+			((Container*)(*i))->DrawCached( x, y - yscroll );
+		} else {
+			(*i)->Draw( x, y - yscroll );
+		}
 	}
 
-	Video::UnsetCropRect();
+	if( !screen ) {
+		Video::UnsetCropRect();
+	}
 
 	Widget::Draw(relx, rely);
 }
 
+/**\brief Marks this Container, and the Containers around it, as changed.
+ */
+void Container::Invalidate( void ) {
+	dirty = true;
+	Widget::Invalidate();
+}
+
+/**\brief A Container is static when all of its children are.
+ */
+bool Container::IsStatic( void ) {
+	list<Widget *>::iterator i;
+
+	for( i = children.begin(); i != children.end(); ++i ) {
+		if( !(*i)->IsStatic() ) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/**\brief Draws this Container from a texture that is only redrawn when it changes.
+ * \details Static screens full of widgets then cost one textured quad per
+ *          frame. Containers that are animated, that the renderer can't
+ *          draw into textures, or when options/video/ui-cache is off, are
+ *          drawn directly.
+ */
+void Container::DrawCached( int relx, int rely ) {
+	SDL_Renderer *renderer = Video::GetRenderer();
+
+	// Textures left by Containers that were deleted on the logic thread
+	while( !retiredCaches.empty() ) {
+		SDL_DestroyTexture( retiredCaches.back() );
+		retiredCaches.pop_back();
+	}
+
+	if( !OPTION(int, "options/video/ui-cache") || !SDL_RenderTargetSupported( renderer ) || !IsStatic() || w <= 0 || h <= 0 ) {
+		Draw( relx, rely );
+		// Whatever is in the cache is out of date by now
+		dirty = true;
+		return;
+	}
+
+	if( cache != NULL && ( cacheW != w || cacheH != h ) ) {
+		SDL_DestroyTexture( cache );
+		cache = NULL;
+	}
+
+	if( cache == NULL ) {
+		cache = SDL_CreateTexture( renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, w, h );
+		if( cache == NULL ) {
+			LogMsg(WARN, "Could not create the cache for %s: %s", GetName().c_str(), SDL_GetError() );
+			Draw( relx, rely );
+			return;
+		}
+
+		// The widgets are blended into a clear texture, which leaves its
+		// colors multiplied by their alpha already
+		if( SDL_SetTextureBlendMode( cache, SDL_ComposeCustomBlendMode(
+				SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD,
+				SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD ) ) != 0 ) {
+			SDL_SetTextureBlendMode( cache, SDL_BLENDMODE_BLEND );
+		}
+
+		cacheW = w;
+		cacheH = h;
+		dirty = true;
+	}
+
+	if( dirty ) {
+		Video::SetRenderTarget( cache );
+		SDL_SetRenderDrawColor( renderer, 0, 0, 0, 0 );
+		SDL_RenderClear( renderer );
+
+		// Draw this Container at the top left of the texture
+		Draw( -GetX(), -GetY() );
+
+		Video::SetRenderTarget( NULL );
+		dirty = false;
+	}
+
+	SpriteBatch::Draw( cache, 0.f, 0.f, 1.f, 1.f,
+	                   static_cast<float>( GetX() + relx ), static_cast<float>( GetY() + rely ),
+	                   static_cast<float>( w ), static_cast<float>( h ), 0.f, 1.f );
+}
+
 /**\brief Mouse is currently moving over the widget, without button down.
  */
 bool Container::MouseMotion( int xi, int yi ) {
@@ -969,6 +1087,8 @@ bool Container::KeyboardLeave( void ) {
 bool Container::KeyPress( SDL_Keycode key ) {
 	Widget *next = NULL;
 
+	Invalidate();
+
 	if( keyboardFocus ) {
 		// If this key is a TAB and the keyboard is currently focused on a Textbox,
 		// then move to the next textbox
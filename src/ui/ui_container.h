@@ -45,6 +45,10 @@ class Container : public Widget {
 		virtual Widget *PrevChild( Widget* widget, int mask = WIDGET_ALL );
 
 		virtual void Draw( int relx = 0, int rely = 0 );
+		void DrawCached( int relx = 0, int rely = 0 );
+
+		virtual void Invalidate( void );
+		virtual bool IsStatic( void );
 
 		xmlNodePtr ToNode();
 
@@ -88,6 +92,12 @@ class Container : public Widget {
 		struct _InnerRect {
 			int left, top, right, bottom;
 		} InnerRect;
+
+		SDL_Texture *cache; ///< This Container as it was last drawn, if it is cached.
+		int cacheW, cacheH; ///< The size of the cache texture.
+		bool dirty; ///< Has something changed since the cache was drawn?
+
+		static vector<SDL_Texture*> retiredCaches; ///< Caches of deleted Containers, freed on the render thread.
 };
 
 #endif//__H_UI_CONTAINER__
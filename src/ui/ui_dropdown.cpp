@@ -61,6 +61,7 @@ Dropdown* Dropdown::AddOption( string option ) {
 		if( options.size() == 1 ) {
 			selected = 0;
 		}
+		Invalidate();
 	}
 	return this;
 }
@@ -192,6 +193,7 @@ bool Dropdown::SetText(string text){
 	for(i = 0; i < options.size(); i++){
 		if(options[i] == text){
 			selected = i;
+			Invalidate();
 			return true;
 		}
 	}
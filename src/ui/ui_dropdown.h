@@ -22,6 +22,7 @@ class Dropdown : public Widget {
 		Dropdown* AddOptions( list<string> options );
 
 		void Draw( int relx = 0, int rely = 0 );
+		bool IsStatic( void ) { return !opened; } // Open Dropdowns are drawn above everything else
 	
 		virtual string GetType( void ) { return string("Dropdown"); }
 		virtual int GetMask( void ) { return WIDGET_DROPDOWN; }
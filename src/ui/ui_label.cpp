@@ -61,6 +61,7 @@ void Label::SetText(string newText) {
 	}
 	w = UI::font->TextWidth( text );
 	h = UI::font->TightHeight( );
+	Invalidate();
 }
 
 /**\brief Append some text to the current text
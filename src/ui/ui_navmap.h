@@ -22,6 +22,7 @@ class NavMap: public Container {
 		~NavMap();
 
 		void Draw( int relx = 0, int rely = 0 );
+		bool IsStatic( void ) { return false; } // The map follows the ships
 
 		void SetAlpha( float newAlpha ) { alpha = newAlpha; }
 		void SetCenter( Coordinate newCenter ) { center = newCenter; }
@@ -28,7 +28,7 @@ class Paragraph : public Widget {
 		string GetType( void ) {return string("Paragraph");}
 		virtual int GetMask( void ) { return WIDGET_PARAGRAPH; }
 
-		void SetH( int _h ){ h = _h + UI_PARAGRAPH_BOTTOM_PADDING; }
+		void SetH( int _h ){ h = _h + UI_PARAGRAPH_BOTTOM_PADDING; Invalidate(); }
 	
 	private:
 		bool centered;
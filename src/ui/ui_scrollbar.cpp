@@ -69,6 +69,7 @@ Scrollbar::~Scrollbar() {
 void Scrollbar::SetSize(int length) {
 	this->w = bitmaps[0]->GetWidth();
 	this->h = length;
+	Invalidate();
 }
 
 /**\brief Draws the scrollbar.
@@ -135,12 +136,14 @@ bool Scrollbar::MouseDrag( int xi, int yi ){
 void Scrollbar::ScrollUp( int pix ){
 	int newpos = pos-pix;
 	this->pos = this->CheckPos( newpos );
+	Invalidate();
 }
 
 /**\brief Scroll the scrollbar down.*/
 void Scrollbar::ScrollDown( int pix ){
 	int newpos = pos+pix;
 	this->pos = this->CheckPos( newpos );
+	Invalidate();
 }
 
 /**\brief Calculates marker size based on current dimensions.
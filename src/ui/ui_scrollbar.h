@@ -22,7 +22,7 @@ class Scrollbar : public Widget {
 		void Draw( int relx = 0, int rely = 0 );
 
 		// Use these when the encompassing window size changes
-		void SetPosition(int x, int y) { this->x = x; this->y = y; }
+		void SetPosition(int x, int y) { this->x = x; this->y = y; Invalidate(); }
 		void SetSize(int length);
 
 
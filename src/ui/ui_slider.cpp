@@ -130,6 +130,7 @@ void Slider::SetVal( float value ){
 			checkedval = minval;
 	}
 	this->val = checkedval;
+	Invalidate();
 }
 
 // Private functions
@@ -23,7 +23,7 @@ class Textarea : public Widget {
 		virtual int GetMask( void ) { return WIDGET_TEXTAREA; }
 
 		string GetText() { return lines.GetText(); }
-		void SetText(string s) { lines.SetText(s); }
+		void SetText(string s) { lines.SetText(s); Invalidate(); }
 
 	protected:
 		bool KeyPress( SDL_Keycode key );
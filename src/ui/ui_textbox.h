@@ -19,12 +19,13 @@ class Textbox : public Widget {
 		Textbox( int x, int y, int w, int rows, string text = "", string label = "");
 
 		void Draw( int relx, int rely = 0 );
+		bool IsStatic( void ) { return !IsActive() || disabled; } // The cursor blinks
 
 		string GetType( void ) {return string("Textbox");}
 		virtual int GetMask( void ) { return WIDGET_TEXTBOX; }
 
 		string GetText() { return text; }
-		void SetText(string s) { text = s; }
+		void SetText(string s) { text = s; Invalidate(); }
 
 	protected:
 		bool KeyPress( SDL_Keycode key );
@@ -148,6 +148,7 @@ bool Widget::Activate( action_type type, int xi, int yi ) {
 /**\brief Widget is currently being dragged.
  */
 bool Widget::MouseDrag( int xi,int yi ){
+	Invalidate();
 	Activate(Action_MouseDrag, xi, yi);
 	return true;
 }
@@ -164,6 +165,8 @@ bool Widget::MouseMotion( int xi, int yi ){
 bool Widget::MouseEnter( int xi, int yi ){
 	LogMsg(TRACE, "Mouse enter detect in %s named %s.", GetType().c_str(), GetName().c_str() );
 
+	Invalidate();
+
 	hovering = true;
 
 	Activate(Action_MouseEnter, xi, yi);
@@ -176,6 +179,8 @@ bool Widget::MouseEnter( int xi, int yi ){
 bool Widget::MouseLeave( void ){
 	LogMsg(TRACE, "Mouse leave detect in %s named %s.", GetType().c_str(), GetName().c_str() );
 
+	Invalidate();
+
 	hovering = false;
 
 	Activate(Action_MouseLeave, 0, 0);
@@ -188,6 +193,8 @@ bool Widget::MouseLeave( void ){
 bool Widget::MouseLUp( int xi, int yi ){
 	LogMsg(TRACE, "Mouse Left up detect in %s named %s.", GetType().c_str(), GetName().c_str() );
 
+	Invalidate();
+
 	Activate(Action_MouseLUp, xi, yi);
 
 	return true;
@@ -198,6 +205,8 @@ bool Widget::MouseLUp( int xi, int yi ){
 bool Widget::MouseLDown( int xi, int yi ) {
 	LogMsg(TRACE, "Mouse Left up detect in %s named %s.", GetType().c_str(), GetName().c_str() );
 
+	Invalidate();
+
 	// update drag coordinates in case this is draggable
 	dragX = xi-x;
 	dragY = yi-y;
@@ -212,6 +221,8 @@ bool Widget::MouseLDown( int xi, int yi ) {
 bool Widget::MouseLRelease( void ){
 	LogMsg(TRACE, "Left Mouse released in %s named %s.", GetType().c_str(), GetName().c_str() );
 
+	Invalidate();
+
 	Activate(Action_MouseLRelease, 0, 0);
 
 	return true;
@@ -222,6 +233,8 @@ bool Widget::MouseLRelease( void ){
 bool Widget::MouseMUp( int xi, int yi ){
 	LogMsg(TRACE, "Mouse Middle up detect in %s named %s.", GetType().c_str(), GetName().c_str() );
 
+	Invalidate();
+
 	Activate(Action_MouseMUp, xi, yi);
 
 	return true;
@@ -232,6 +245,8 @@ bool Widget::MouseMUp( int xi, int yi ){
 bool Widget::MouseMDown( int xi, int yi ){
 	LogMsg(TRACE, "Mouse Middle down detect in %s named %s.", GetType().c_str(), GetName().c_str() );
 
+	Invalidate();
+
 	Activate(Action_MouseMDown, xi, yi);
 
 	return true;
@@ -242,6 +257,8 @@ bool Widget::MouseMDown( int xi, int yi ){
 bool Widget::MouseMRelease( void ){
 	LogMsg(TRACE, "Middle Mouse released in %s named %s.", GetType().c_str(), GetName().c_str() );
 
+	Invalidate();
+
 	Activate(Action_MouseMRelease, 0, 0);
 
 	return true;
@@ -252,6 +269,8 @@ bool Widget::MouseMRelease( void ){
 bool Widget::MouseRUp( int xi, int yi ){
 	LogMsg(TRACE, "Mouse Right up detect in %s named %s.", GetType().c_str(), GetName().c_str() );
 
+	Invalidate();
+
 	Activate(Action_MouseRUp, xi, yi);
 
 	return true;
@@ -262,6 +281,8 @@ bool Widget::MouseRUp( int xi, int yi ){
 bool Widget::MouseRDown( int xi, int yi ){
 	LogMsg(TRACE, "Mouse Right down detect in %s named %s.", GetType().c_str(), GetName().c_str() );
 
+	Invalidate();
+
 	Activate(Action_MouseRDown, xi, yi);
 
 	return true;
@@ -272,6 +293,8 @@ bool Widget::MouseRDown( int xi, int yi ){
 bool Widget::MouseRRelease( void ){
 	LogMsg(TRACE, "Right Mouse released in %s named %s.", GetType().c_str(), GetName().c_str() );
 
+	Invalidate();
+
 	Activate(Action_MouseRRelease, 0, 0);
 
 	return true;
@@ -282,6 +305,8 @@ bool Widget::MouseRRelease( void ){
 bool Widget::MouseWUp( int xi, int yi ){
 	LogMsg(TRACE, "Mouse Wheel up detect in %s named %s.", GetType().c_str(), GetName().c_str() );
 
+	Invalidate();
+
 	Activate(Action_MouseWUp, xi, yi);
 
 	return false;
@@ -292,6 +317,8 @@ bool Widget::MouseWUp( int xi, int yi ){
 bool Widget::MouseWDown( int xi, int yi ){
 	LogMsg(TRACE, "Mouse Wheel down detect in %s named %s.", GetType().c_str(), GetName().c_str() );
 
+	Invalidate();
+
 	Activate(Action_MouseWDown, xi, yi);
 
 	return false;
@@ -302,6 +329,8 @@ bool Widget::MouseWDown( int xi, int yi ){
 bool Widget::KeyboardEnter( void ){
 	LogMsg(TRACE, "Keyboard enter detect in %s named %s.", GetType().c_str(), GetName().c_str() );
 
+	Invalidate();
+
 	Activate(Action_KeyboardEnter, 0, 0);
 
 	keyactivated = true;
@@ -314,6 +343,8 @@ bool Widget::KeyboardEnter( void ){
 bool Widget::KeyboardLeave( void ){
 	LogMsg(TRACE, "Keyboard leave detect in %s named %s.", GetType().c_str(), GetName().c_str() );
 
+	Invalidate();
+
 	Activate(Action_KeyboardLeave, 0, 0);
 
 	keyactivated = false;
@@ -326,6 +357,8 @@ bool Widget::KeyboardLeave( void ){
 bool Widget::KeyPress( SDL_Keycode key ) {
 	LogMsg(TRACE, "Key press detect in %s named %s.", GetType().c_str(), GetName().c_str() );
 
+	Invalidate();
+
 	return false;
 }
 
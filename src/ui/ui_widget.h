@@ -52,10 +52,10 @@ class Widget {
 		virtual int GetW( void ){ return this->w; }
 		virtual int GetH( void ){ return this->h; }
 
-		virtual void SetX( int _x ){ x = _x; }
-		virtual void SetY( int _y ){ y = _y; }
-		virtual void SetW( int _w ){ w = _w; }
-		virtual void SetH( int _h ){ h = _h; }
+		virtual void SetX( int _x ){ x = _x; Invalidate(); }
+		virtual void SetY( int _y ){ y = _y; Invalidate(); }
+		virtual void SetW( int _w ){ w = _w; Invalidate(); }
+		virtual void SetH( int _h ){ h = _h; Invalidate(); }
 
 		virtual int GetAbsX( void );
 		virtual int GetAbsY( void );
@@ -69,8 +69,13 @@ class Widget {
 		virtual void Draw( int relx = 0, int rely = 0 );
 		bool Contains( int relx, int rely );
 
-		void Show( void ) { hidden = false; }
-		void Hide( void ) { hidden = true; }
+		// Cached Containers are only redrawn after one of their widgets changes
+		virtual void Invalidate( void ) { if( parent ) parent->Invalidate(); }
+		// Widgets that look different every frame can't be drawn from a cache
+		virtual bool IsStatic( void ) { return true; }
+
+		void Show( void ) { hidden = false; Invalidate(); }
+		void Hide( void ) { hidden = true; Invalidate(); }
 
 		virtual xmlNodePtr ToNode();
 
@@ -33,6 +33,12 @@
  *
  **\fn FromXMLNode
  * \brief Parse an XML Node into a Component.
+ * \details Other Components are only named here, since the files that hold
+ *          them may be parsed at the same time on another thread.
+ *
+ **\fn Link
+ * \brief Find the other Components that FromXMLNode named.
+ * \details Runs once every file of the Scenario has been loaded.
  *
  **\fn ToXMLNode
  * \brief Create an XML Node from this Component.
@@ -191,11 +197,11 @@ bool Components::Load(string filename, bool fileoptional, bool skipcorrupt) {
 	int numObjs = 0;
 	bool success = true;
 
-	File xmlfile = File (filename);
+	File xmlfile(filename);
 	long filelen = xmlfile.GetLength();
-	char *buffer = xmlfile.Read();
-	doc = xmlParseMemory( buffer, static_cast<int>(filelen) );
-	delete [] buffer;
+	const char *buffer = xmlfile.Map();
+	doc = buffer ? xmlParseMemory( buffer, static_cast<int>(filelen) ) : NULL;
+	xmlfile.Unmap();
 
 	// This path will be used when saving the file later.
 	this->filename = filename;
@@ -263,6 +269,23 @@ bool Components::Load(string filename, bool fileoptional, bool skipcorrupt) {
 	return success;
 }
 
+/**\brief Links every Component to the other Components that it names
+ * \return false if any of them refers to a Component that doesn't exist
+ */
+bool Components::Link() {
+	map<string,Component*>::iterator i;
+	bool success = true;
+
+	for( i = components.begin(); i != components.end(); ++i ) {
+		if( !i->second->Link() ) {
+			LogMsg(ERR, "Failed to link the %s '%s'.", componentName.c_str(), i->first.c_str() );
+			success = false;
+		}
+	}
+
+	return success;
+}
+
 /**\brief Save all Components to an XML file
  */
 bool Components::Save() {
@@ -293,7 +316,7 @@ bool Components::Save() {
 
 	xmlDocDumpFormatMemory( doc, &xmlbuff, &buffersize, 1 );
 
-	File saved = File( filename.c_str(), true );
+	File saved( filename.c_str(), true );
 
 	if(saved.Write( (char *)xmlbuff, buffersize ) != true) {
 		LogMsg(ERR, "Could not save component\n");
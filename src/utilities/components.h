@@ -19,6 +19,7 @@ class Component {
 		string GetName() const { return name; }
 		void SetName(string _name) { name = _name; }
 		virtual bool FromXMLNode( xmlDocPtr doc, xmlNodePtr node ) = 0;
+		virtual bool Link( void ) { return true; }
 		virtual xmlNodePtr ToXMLNode(string componentName) = 0;
 
 	protected:
@@ -38,6 +39,7 @@ class Components {
 		int Size() { return (int)names.size(); }
 
 		virtual bool Load(string filename, bool fileoptional = false, bool skipcorrupt = false);
+		bool Link( void );
 		bool Save();
 
 		void SetFileName( const string& filename ) { this->filename = filename; }
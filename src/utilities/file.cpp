@@ -10,10 +10,27 @@
 #include "utilities/file.h"
 #include "utilities/log.h"
 
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #ifndef USE_PHYSICSFS
 #define PHYSFS_getLastError() "FAILED!"
 #endif
 
+// Buffers returned by Unmap are kept for the next file, up to this many bytes in all
+#define FILE_POOL_LIMIT (8 * 1024 * 1024)
+// Pooled buffers grow in steps of this many bytes, so that they fit more files
+#define FILE_POOL_STEP (64 * 1024)
+
+// Buffers for files that can't be mapped; shared by every thread
+static list< pair<char*,long> > pool;
+static long poolBytes = 0;
+static SDL_SpinLock poolLock = 0;
+
 
 /** \class File
  *  \brief Low level file access abstraction through PhysicsFS.
@@ -21,14 +38,16 @@
 
 /**Creates empty file instance.*/
 File::File( void ):
-	fp(NULL), contentSize(0),validName("")
+	fp(NULL), contentSize(0),validName(""),
+	view(NULL), mapping(NULL), pooled(NULL), pooledSize(0)
 {
 	
 }
 
 /**Creates file instance linked to filename. \sa Open.*/
 File::File( const string& filename, bool writable ):
-	fp(NULL), contentSize(0), validName("")
+	fp(NULL), contentSize(0), validName(""),
+	view(NULL), mapping(NULL), pooled(NULL), pooledSize(0)
 {
 	if( writable )
 		OpenWrite( filename );
@@ -168,6 +187,105 @@ char *File::Read( void ){
 	}
 }
 
+/**Gives read-only access to the whole file, without copying it.
+ * \details Files in a plain directory are mapped into memory. Files inside
+ *          of an archive are read into a buffer that is reused by the next
+ *          file once this one is done with it. Either way, the contents stay
+ *          valid until Unmap or Close, and are GetLength bytes long.
+ * \return Pointer to the contents, NULL otherwise.*/
+const char *File::Map( void ){
+	if ( fp == NULL )
+		return NULL;
+	if ( view != NULL )
+		return view;
+	if ( contentSize == 0 )
+		return view = "";
+
+#ifndef _WIN32
+	string path;
+#ifdef USE_PHYSICSFS
+	const char *realDir = PHYSFS_getRealDir( validName.c_str() );
+	struct stat dirStatus;
+	if ( realDir != NULL && stat( realDir, &dirStatus ) == 0 && S_ISDIR( dirStatus.st_mode ) ) {
+		path = GetAbsolutePath();
+	}
+#else
+	path = validName;
+#endif
+	if ( !path.empty() ) {
+		int fd = open( path.c_str(), O_RDONLY );
+		if ( fd >= 0 ) {
+			struct stat fileStatus;
+			if ( fstat( fd, &fileStatus ) == 0 && fileStatus.st_size == contentSize ) {
+				mapping = mmap( NULL, contentSize, PROT_READ, MAP_PRIVATE, fd, 0 );
+				if ( mapping == MAP_FAILED ) {
+					mapping = NULL;
+				}
+			}
+			close( fd );
+		}
+		if ( mapping != NULL ) {
+			return view = static_cast<const char*>( mapping );
+		}
+	}
+#endif
+
+	// Take the smallest pooled buffer that is big enough
+	SDL_AtomicLock( &poolLock );
+	list< pair<char*,long> >::iterator best = pool.end();
+	for ( list< pair<char*,long> >::iterator i = pool.begin(); i != pool.end(); ++i ) {
+		if ( i->second >= contentSize && ( best == pool.end() || i->second < best->second ) ) {
+			best = i;
+		}
+	}
+	if ( best != pool.end() ) {
+		pooled = best->first;
+		pooledSize = best->second;
+		poolBytes -= pooledSize;
+		pool.erase( best );
+	}
+	SDL_AtomicUnlock( &poolLock );
+
+	if ( pooled == NULL ) {
+		pooledSize = ( ( contentSize + FILE_POOL_STEP - 1 ) / FILE_POOL_STEP ) * FILE_POOL_STEP;
+		pooled = new char[ static_cast<Uint32>( pooledSize ) ];
+	}
+
+	Seek( 0 );
+	if ( !Read( contentSize, pooled ) ) {
+		Unmap();
+		return NULL;
+	}
+
+	return view = pooled;
+}
+
+/**Releases the contents given by Map. */
+void File::Unmap( void ){
+#ifndef _WIN32
+	if ( mapping != NULL ) {
+		munmap( mapping, contentSize );
+	}
+#endif
+
+	if ( pooled != NULL ) {
+		SDL_AtomicLock( &poolLock );
+		if ( poolBytes + pooledSize <= FILE_POOL_LIMIT ) {
+			pool.push_back( make_pair( pooled, pooledSize ) );
+			poolBytes += pooledSize;
+			pooled = NULL;
+		}
+		SDL_AtomicUnlock( &poolLock );
+
+		delete [] pooled;
+	}
+
+	view = NULL;
+	mapping = NULL;
+	pooled = NULL;
+	pooledSize = 0;
+}
+
 /**Writes buffer to file.
  * \param buffer The buffer to write
  * \param bufsize The size of the buffer in bytes
@@ -261,6 +379,8 @@ File::~File() {
 /**Closes the file handle and frees associated buffer.
  * \return true if successful, false otherwise*/
 bool File::Close() {
+	Unmap();
+
 	if ( validName.compare( "" ) == 0 )
 		return false;
 
@@ -279,6 +399,7 @@ bool File::Close() {
 			validName.c_str(), PHYSFS_getErrorByCode(PHYSFS_getLastErrorCode()));
 		return false;
 	}
+	fp = NULL;
 	contentSize = 0;
 
 	LogMsg(DEBUG, "File '%s' closed/saved successfully.", validName.c_str());
@@ -318,6 +439,26 @@ bool File::IsDir( const string& filename ) {
 	return false;
 }
 
+/**
+ * Returns when the file was last changed, in seconds since the epoch,
+ * or -1 if that isn't known.
+ */
+Sint64 File::GetModTime( const string& filename ) {
+#ifdef USE_PHYSICSFS
+	PHYSFS_Stat fileStatus;
+	if ( PHYSFS_stat( filename.c_str(), &fileStatus ) == 0 ) {
+		return -1;
+	}
+	return fileStatus.modtime;
+#else
+	struct stat fileStatus;
+	if ( stat( filename.c_str(), &fileStatus ) != 0 ) {
+		return -1;
+	}
+	return fileStatus.st_mtime;
+#endif
+}
+
 bool IsBigEndian() {
 	int test_var = 1;
 	unsigned char *test_array = (unsigned char*)&test_var;
@@ -1,7 +1,7 @@
 /**\file			file.h
  * \author			Christopher Thielen (chris@epiar.net)
  * \date			Created: Monday, April 21, 2008
- * \date			Modified: Saturday, November 21, 2009
+ * \date			Modified: Monday, October 19, 2026
  * \brief			Low level interface for file access.
  * \details
  * Use filesystem for higher level access.*/
@@ -29,6 +29,8 @@ class File {
 		bool OpenRead( const string& filename );
 		bool OpenWrite( const string& filename );
 		char *Read( void );
+		const char *Map( void );
+		void Unmap( void );
 		bool Write( char *buffer, const long bufsize );
 		long Tell( void );
 		bool Seek( long pos );
@@ -36,11 +38,16 @@ class File {
 
 		static bool Exists( const string& filename );
 		static bool IsDir( const string& filename );
+		static Sint64 GetModTime( const string& filename );
 
 		string GetRelativePath();
 		string GetAbsolutePath();
 
 	private:
+		// A File owns its handle and its view, so it can't be copied
+		File( const File& ) = delete;
+		File& operator=( const File& ) = delete;
+
 #ifdef USE_PHYSICSFS
 		PHYSFS_file *fp;		/** File pointer.  */
 #else
@@ -50,6 +57,11 @@ class File {
 
 		long contentSize;		/** Number of bytes in the file. */
 		string validName;		/** Name of the file referenced (exists).*/
+
+		const char *view;		/** The contents, while the file is mapped. */
+		void *mapping;			/** Set if view was mapped rather than read. */
+		char *pooled;			/** Set if view was read into a pooled buffer. */
+		long pooledSize;		/** How big the pooled buffer is. */
 };
 
 bool IsBigEndian();
@@ -0,0 +1,239 @@
+/**\file			loader.cpp
+ * \author			Christopher Thielen (chris@epiar.net)
+ * \date			Created: Monday, October 19, 2026
+ * \date			Modified: Monday, October 19, 2026
+ * \brief			Loads Resources on worker threads
+ * \details
+ */
+
+#include "includes.h"
+#include "common.h"
+#include "utilities/loader.h"
+#include "utilities/log.h"
+
+/**\class LoadJob
+ * \brief One Resource being loaded by the Loader.
+ * \details Run does the slow part (reading the file and decoding it) on a
+ *          worker thread, and must not touch anything but the job itself.
+ *          Finish then hands the result to the Resource on the thread that
+ *          owns the world, which is also where textures can be made.
+ */
+
+/**\class Loader
+ * \brief Pool of threads that read and decode Resources.
+ * \details Image::Get, Ani::Get and Sound::Get return their Resource right
+ *          away and queue a LoadJob for it. Until the job is finished the
+ *          Resource is a placeholder: Images and Animations draw nothing,
+ *          and Sounds don't play. Anything that can't wait calls Wait.
+ *
+ *          options/timing/loader-threads sets how many workers there are,
+ *          with -1 meaning one per core. With it set to 0, or before
+ *          Initialize, jobs are run as soon as they are queued.
+ * \sa LoadJob
+ */
+
+vector<SDL_Thread*> Loader::workers;
+list<LoadJob*> Loader::queued;
+list<LoadJob*> Loader::decoded;
+int Loader::running = 0;
+SDL_mutex *Loader::lock = NULL;
+SDL_cond *Loader::wake = NULL;
+SDL_cond *Loader::done = NULL;
+bool Loader::quitting = false;
+
+/**\brief Starts the worker threads.
+ */
+void Loader::Initialize( void ) {
+	int i, threads;
+
+	threads = OPTION( int, "options/timing/loader-threads" );
+	if( threads < 0 ) {
+		threads = SDL_GetCPUCount();
+	}
+	if( threads == 0 ) {
+		LogMsg(INFO, "Resources will be loaded as they are needed." );
+		return;
+	}
+
+	lock = SDL_CreateMutex();
+	wake = SDL_CreateCond();
+	done = SDL_CreateCond();
+	quitting = false;
+
+	for( i = 0; i < threads; i++ ) {
+		SDL_Thread *worker = SDL_CreateThread( Loader::Work, "Loader", NULL );
+		if( worker == NULL ) {
+			LogMsg(WARN, "Could not start a loader thread: %s", SDL_GetError() );
+			break;
+		}
+		workers.push_back( worker );
+	}
+
+	LogMsg(INFO, "Loading Resources with %d threads.", (int)workers.size() );
+}
+
+/**\brief Finishes every job and stops the worker threads.
+ */
+void Loader::Shutdown( void ) {
+	vector<SDL_Thread*>::iterator i;
+
+	if( lock == NULL ) {
+		return;
+	}
+
+	// Let the workers empty the queue, then tell them to stop
+	while( GetPending() > 0 ) {
+		Update();
+		SDL_Delay( 1 );
+	}
+
+	SDL_LockMutex( lock );
+	quitting = true;
+	SDL_CondBroadcast( wake );
+	SDL_UnlockMutex( lock );
+
+	for( i = workers.begin(); i != workers.end(); ++i ) {
+		SDL_WaitThread( *i, NULL );
+	}
+	workers.clear();
+
+	SDL_DestroyCond( done );
+	SDL_DestroyCond( wake );
+	SDL_DestroyMutex( lock );
+	done = NULL;
+	wake = NULL;
+	lock = NULL;
+}
+
+/**\brief Hands a job to the workers.
+ * \details The Loader deletes the job once it has been finished.
+ */
+void Loader::Queue( LoadJob *job ) {
+	if( workers.empty() ) {
+		job->Run();
+		job->Finish();
+		delete job;
+		return;
+	}
+
+	SDL_LockMutex( lock );
+	queued.push_back( job );
+	SDL_CondSignal( wake );
+	SDL_UnlockMutex( lock );
+}
+
+/**\brief Finishes the jobs that the workers have decoded.
+ * \details Call this once per frame from the thread that owns the world,
+ *          while holding the world lock so that no Wait runs at the same time.
+ *          Jobs that don't fit into LOADER_FINISH_MS wait for the next frame.
+ */
+void Loader::Update( void ) {
+	Uint32 start = SDL_GetTicks();
+
+	if( lock == NULL ) {
+		return;
+	}
+
+	for( ;; ) {
+		LoadJob *job;
+
+		SDL_LockMutex( lock );
+		if( decoded.empty() ) {
+			SDL_UnlockMutex( lock );
+			break;
+		}
+		job = decoded.front();
+		decoded.pop_front();
+		SDL_UnlockMutex( lock );
+
+		job->Finish();
+		delete job;
+
+		if( SDL_GetTicks() - start >= LOADER_FINISH_MS ) {
+			break;
+		}
+	}
+}
+
+/**\brief Finishes one job right now.
+ * \details If no worker has started the job yet, it is run on this thread.
+ *          Like Update, this must not run while Update is running.
+ */
+void Loader::Wait( LoadJob *job ) {
+	list<LoadJob*>::iterator i;
+
+	if( lock == NULL ) {
+		return; // Jobs were finished when they were queued
+	}
+
+	SDL_LockMutex( lock );
+
+	for( i = queued.begin(); i != queued.end(); ++i ) {
+		if( *i == job ) {
+			queued.erase( i );
+			SDL_UnlockMutex( lock );
+			job->Run();
+			job->Finish();
+			delete job;
+			return;
+		}
+	}
+
+	while( !job->decoded ) {
+		SDL_CondWait( done, lock );
+	}
+	decoded.remove( job );
+
+	SDL_UnlockMutex( lock );
+
+	job->Finish();
+	delete job;
+}
+
+/**\brief Counts the jobs that haven't been finished.
+ */
+int Loader::GetPending( void ) {
+	int pending;
+
+	if( lock == NULL ) {
+		return 0;
+	}
+
+	SDL_LockMutex( lock );
+	pending = queued.size() + running + decoded.size();
+	SDL_UnlockMutex( lock );
+
+	return pending;
+}
+
+/**\brief Runs queued jobs until the Loader shuts down.
+ */
+int Loader::Work( void *data ) {
+	SDL_LockMutex( lock );
+
+	while( !quitting ) {
+		LoadJob *job;
+
+		if( queued.empty() ) {
+			SDL_CondWait( wake, lock );
+			continue;
+		}
+
+		job = queued.front();
+		queued.pop_front();
+		running++;
+		SDL_UnlockMutex( lock );
+
+		job->Run();
+
+		SDL_LockMutex( lock );
+		running--;
+		job->decoded = true;
+		decoded.push_back( job );
+		SDL_CondBroadcast( done );
+	}
+
+	SDL_UnlockMutex( lock );
+
+	return 0;
+}
@@ -0,0 +1,53 @@
+/**\file			loader.h
+ * \author			Christopher Thielen (chris@epiar.net)
+ * \date			Created: Monday, October 19, 2026
+ * \date			Modified: Monday, October 19, 2026
+ * \brief			Loads Resources on worker threads
+ * \details
+ */
+
+#ifndef __H_LOADER__
+#define __H_LOADER__
+
+#include "includes.h"
+
+// Longest that Loader::Update may spend finishing Resources in one frame
+#define LOADER_FINISH_MS 4
+
+class LoadJob {
+	public:
+		LoadJob() : decoded(false) {}
+		virtual ~LoadJob() {}
+
+		// Reads and decodes the file, on a worker thread
+		virtual void Run( void ) = 0;
+		// Hands the result to the Resource, on the thread that owns the world
+		virtual void Finish( void ) = 0;
+
+		bool decoded; ///< Run has returned, guarded by the Loader lock
+};
+
+class Loader {
+	public:
+		static void Initialize( void );
+		static void Shutdown( void );
+
+		static void Queue( LoadJob *job );
+		static void Update( void );
+		static void Wait( LoadJob *job );
+		static int GetPending( void );
+
+	private:
+		static int Work( void *data );
+
+		static vector<SDL_Thread*> workers;
+		static list<LoadJob*> queued; ///< Waiting for a worker
+		static list<LoadJob*> decoded; ///< Waiting for Finish
+		static int running; ///< Jobs that a worker is running right now
+		static SDL_mutex *lock;
+		static SDL_cond *wake; ///< Signalled when a job is queued, or when quitting
+		static SDL_cond *done; ///< Signalled when a job has been decoded
+		static bool quitting;
+};
+
+#endif // __H_LOADER__
@@ -14,8 +14,9 @@
 /**\class Log
  * \brief Main logging facilities for the code base. */
 
-/**\brief Empty destructor.*/
+/**\brief Destructor.*/
 Log::~Log() {
+	SDL_DestroyMutex( lock );
 }
 
 /**\brief Retrieves the current instance of the log class.*/
@@ -108,6 +109,8 @@ void Log::realLog( LogLevel messageLevel, const string& func, const char *messag
 	time_t rawtime;
 	char logBuffer[1024] = {0};
 
+	SDL_LockMutex( lock );
+
 	time( &rawtime );
 
 	timestamp = ctime( &rawtime );
@@ -128,6 +131,8 @@ void Log::realLog( LogLevel messageLevel, const string& func, const char *messag
 	} else {
 		processLogEntry( entry );
 	}
+
+	SDL_UnlockMutex( lock );
 }
 
 /**
@@ -226,6 +231,7 @@ Log::Log()
 	logFilename = string("epiar-") + GetTimestamp() + string(".log.xml");
 
 	fp = NULL;
+	lock = SDL_CreateMutex();
 }
 
 string Log::GetTimestamp( void ) {
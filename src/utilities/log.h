@@ -104,6 +104,7 @@ class Log {
 		char *timestamp;
 		string logFilename;
 		FILE *fp; // pointer to the log
+		SDL_mutex *lock; // messages come from both the render and logic threads
 
 		// If useBuffer is true, messages are buffered and not processed for
 		// filtering or printing. This is useful when the program is starting up
@@ -20,6 +20,13 @@
 bool Lua::luaInitialized = false;
 lua_State *Lua::L = NULL;
 
+float Lua::gcBudget = 1.0f;
+int Lua::gcPause = 200;
+bool Lua::gcCollecting = false;
+int Lua::gcThresholdKB = 0;
+float Lua::gcTime = 0.0f;
+int Lua::gcHeapKB = 0;
+
 bool Lua::Load( const string& filename ) {
 	File pathTranslator; // use this to determine the physfs-resolved path, e.g. absolute/full path
 
@@ -191,8 +198,10 @@ bool Lua::Init() {
 	luaL_openlibs( L );
 
 	RegisterFunctions();
-	
+
 	luaInitialized = true;
+
+	SetupGC();
 	
 	return( true );
 }
@@ -210,6 +219,69 @@ bool Lua::Close() {
 	return( true );
 }
 
+/**\brief Hand control of the garbage collector over to the engine.
+ * \details Lua's own collector runs whenever the allocation debt triggers
+ * it, which can be right in the middle of an AI decision.  Instead the
+ * collector is stopped here and StepGC advances it a little each frame.
+ *
+ * The pause and stepmul options mirror Lua's own collector settings: pause
+ * is how much the heap may grow (in percent) after a completed cycle before
+ * a new cycle starts, stepmul is how much work each incremental step does.
+ */
+void Lua::SetupGC() {
+	gcBudget = OPTION(float, "options/lua/gc-budget");
+	gcPause = OPTION(int, "options/lua/gc-pause");
+	if( gcPause < 100 ) gcPause = 100;
+
+	lua_gc(L, LUA_GCSETPAUSE, gcPause);
+	lua_gc(L, LUA_GCSETSTEPMUL, OPTION(int, "options/lua/gc-stepmul"));
+	lua_gc(L, LUA_GCSTOP, 0);
+
+	gcCollecting = false;
+	gcHeapKB = lua_gc(L, LUA_GCCOUNT, 0);
+	gcThresholdKB = gcHeapKB * gcPause / 100;
+	gcTime = 0.0f;
+
+	LogMsg(INFO, "Lua GC: %.2f ms per frame, pause %d, stepmul %d", gcBudget, gcPause, OPTION(int, "options/lua/gc-stepmul"));
+}
+
+/**\brief Run incremental garbage collection steps for this frame.
+ * \details Steps are run until the millisecond budget is used up or the
+ * current cycle completes.  At least one step is always made while a cycle
+ * is in progress so that collection keeps up even with a tiny budget.
+ * \note Call this once per frame, outside of any Lua call.
+ */
+void Lua::StepGC() {
+	if( ! luaInitialized ) {
+		return;
+	}
+
+	Uint64 start = SDL_GetPerformanceCounter();
+	Uint64 budget = static_cast<Uint64>( gcBudget * SDL_GetPerformanceFrequency() / 1000.0 );
+
+	gcHeapKB = lua_gc(L, LUA_GCCOUNT, 0);
+	if( !gcCollecting && (gcHeapKB >= gcThresholdKB) ) {
+		gcCollecting = true;
+	}
+
+	while( gcCollecting ) {
+		if( lua_gc(L, LUA_GCSTEP, 0) ) {
+			// This cycle is finished, wait for the heap to grow before the next one.
+			gcCollecting = false;
+			gcThresholdKB = lua_gc(L, LUA_GCCOUNT, 0) * gcPause / 100;
+		}
+		if( SDL_GetPerformanceCounter() - start >= budget ) {
+			break;
+		}
+	}
+
+	// A completed step re-arms Lua's own threshold, so stop it again.
+	lua_gc(L, LUA_GCSTOP, 0);
+
+	gcHeapKB = lua_gc(L, LUA_GCCOUNT, 0);
+	gcTime = static_cast<float>( (SDL_GetPerformanceCounter() - start) * 1000.0 / SDL_GetPerformanceFrequency() );
+}
+
 void Lua::RegisterFunctions() {
 	lua_atpanic(L, &Lua::ErrorCatch);
 }
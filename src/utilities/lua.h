@@ -56,12 +56,26 @@ class Lua {
 
 		static void stackDump(lua_State *L);
 
+		// Garbage Collection
+		static void SetupGC();
+		static void StepGC();
+		static float GetGCTime() { return gcTime; }
+		static int GetMemoryKB() { return gcHeapKB; }
+
 	private:
 		static int ErrorCatch(lua_State *L);
 
 		// Internal variables
 		static lua_State *L;
 		static bool luaInitialized;
+
+		// Garbage Collection state
+		static float gcBudget;
+		static int gcPause;
+		static bool gcCollecting;
+		static int gcThresholdKB;
+		static float gcTime;
+		static int gcHeapKB;
 };
 
 #endif // __H_LUA__
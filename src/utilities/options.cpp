@@ -68,6 +68,12 @@ void Options::Initialize( void ) {
 	defaults.insert( std::pair<string,string>("options/video/bpp", "32") );
 	defaults.insert( std::pair<string,string>("options/video/fullscreen", "0") );
 	defaults.insert( std::pair<string,string>("options/video/fps", "60") );
+	defaults.insert( std::pair<string,string>("options/video/atlas", "1") );
+	defaults.insert( std::pair<string,string>("options/video/atlas-size", "2048") );
+	defaults.insert( std::pair<string,string>("options/video/atlas-max-image", "512") );
+	defaults.insert( std::pair<string,string>("options/video/text-cache", "128") );
+	defaults.insert( std::pair<string,string>("options/video/radar-fps", "15") );
+	defaults.insert( std::pair<string,string>("options/video/ui-cache", "1") );
 
 	// Sound
 	defaults.insert( std::pair<string,string>("options/sound/disable-audio", "0") );
@@ -81,12 +87,28 @@ void Options::Initialize( void ) {
 
 	// Simultaion
 	defaults.insert( std::pair<string,string>("options/scenario/automatic-load", "0") );
+	defaults.insert( std::pair<string,string>("options/scenario/compiled", "1") );
+
+	// Memory
+	defaults.insert( std::pair<string,string>("options/memory/resource-budget", "256") ); // MB; 0 for no budget
+	defaults.insert( std::pair<string,string>("options/memory/lazy-assets", "1") ); // Components load their Images and Sounds when first used
+	defaults.insert( std::pair<string,string>("options/memory/sound-budget", "32") ); // MB of decoded sound; 0 for no budget
+	defaults.insert( std::pair<string,string>("options/memory/sound-stream-size", "256") ); // KB; longer sounds are dropped first once played
 
 	// Timing
 	defaults.insert( std::pair<string,string>("options/timing/mouse-fade", "500") );
 	defaults.insert( std::pair<string,string>("options/timing/target-zoom", "500") );
 	defaults.insert( std::pair<string,string>("options/timing/alert-drop", "7500") );
 	defaults.insert( std::pair<string,string>("options/timing/alert-fade", "4500") );
+	defaults.insert( std::pair<string,string>("options/timing/logic-thread", "1") );
+	defaults.insert( std::pair<string,string>("options/timing/logic-fps", "30") );
+	defaults.insert( std::pair<string,string>("options/timing/logic-fps-min", "15") );
+	defaults.insert( std::pair<string,string>("options/timing/loader-threads", "-1") );
+
+	// Lua
+	defaults.insert( std::pair<string,string>("options/lua/gc-budget", "1.0") );
+	defaults.insert( std::pair<string,string>("options/lua/gc-pause", "200") );
+	defaults.insert( std::pair<string,string>("options/lua/gc-stepmul", "200") );
 
 	// Development
 	defaults.insert( std::pair<string,string>("options/development/debug-ai", "0") );
@@ -0,0 +1,515 @@
+/**\file			profiler.cpp
+ * \author			Christopher Thielen (chris@epiar.net)
+ * \date			Created: Sunday, October 18, 2026
+ * \date			Modified: Monday, October 19, 2026
+ * \brief			Profiler for Lua scripts
+ * \details
+ * The profiler uses Lua's call and return hooks to keep a shadow call stack
+ * for every lua_State, so coroutines are handled too.  Time is measured
+ * with the performance counter and accumulated into a call tree, which is
+ * then folded into per function and per call site totals when reported.
+ *
+ * Time while a coroutine is suspended is not counted against its open calls,
+ * and the time it runs is not counted as self time of whoever resumed it.
+ */
+
+#include "includes.h"
+#include "common.h"
+#include "utilities/file.h"
+#include "utilities/log.h"
+#include "utilities/lua.h"
+#include "utilities/profiler.h"
+
+/**\class Profiler
+ * \brief Measures where the time spent in Lua goes.
+ * \details Start it from the console with Profiler.start() or
+ * Profiler.toggle(). Stopping it with Profiler.stop() or Profiler.toggle()
+ * writes a report sorted by self time to the write directory.
+ */
+
+bool Profiler::running = false;
+vector<ProfileNode> Profiler::nodes;
+map<lua_State*,ProfileThread> Profiler::threads;
+lua_State *Profiler::active = NULL;
+const void *Profiler::yield = NULL;
+map<const void*,string> Profiler::names;
+
+/**\class ProfileNode
+ * \brief One call path in the profiler's call tree.
+ */
+ProfileNode::ProfileNode( int _parent, const void *_function, int _line )
+	:parent(_parent)
+	,function(_function)
+	,line(_line)
+	,calls(0)
+	,selfTime(0)
+	,totalTime(0)
+{
+}
+
+/**\class ProfileFrame
+ * \brief An active call on a shadow stack.
+ */
+
+/**\class ProfileThread
+ * \brief The shadow stack of one lua_State.
+ */
+
+/**\brief Begin profiling all Lua code run on this state.
+ * \details Coroutines created while the profiler is running inherit the hook.
+ */
+void Profiler::Start( lua_State *L ) {
+	if( running ) {
+		return;
+	}
+
+	if( nodes.empty() ) {
+		Reset();
+	}
+
+	threads.clear();
+	active = NULL;
+
+	// Remember coroutine.yield so that suspended coroutines can be recognized.
+	lua_getglobal( L, "coroutine" );
+	if( lua_istable( L, -1 ) ) {
+		lua_getfield( L, -1, "yield" );
+		yield = lua_topointer( L, -1 );
+		lua_pop( L, 1 );
+	}
+	lua_pop( L, 1 );
+
+	running = true;
+	lua_sethook( L, &Profiler::Hook, LUA_MASKCALL | LUA_MASKRET, 0 );
+
+	LogMsg(INFO, "Lua profiler started.");
+}
+
+/**\brief Stop profiling. The collected data is kept until Reset.
+ * \details This doesn't write a report; call Report for that.
+ */
+void Profiler::Stop( lua_State *L ) {
+	if( !running ) {
+		return;
+	}
+
+	running = false;
+	lua_sethook( L, NULL, 0, 0 );
+
+	// Calls that are still active are not counted.
+	threads.clear();
+	active = NULL;
+
+	LogMsg(INFO, "Lua profiler stopped.");
+}
+
+/**\brief Discard all collected data.
+ */
+void Profiler::Reset() {
+	nodes.clear();
+	names.clear();
+	threads.clear();
+	active = NULL;
+
+	// The root of the call tree
+	nodes.push_back( ProfileNode(-1, NULL, 0) );
+	names[NULL] = "root";
+}
+
+/**\brief How many calls deep the hooked function is on this lua_State.
+ * \details Only lua_getstack is used, so this doesn't depend on how any
+ * one version of Lua lays out its call stack. The deepest valid level is
+ * found with a binary search.
+ */
+static int StackDepth( lua_State *L ) {
+	lua_Debug ar;
+	int low = 0, high = 1;
+
+	// Level 0 is the hooked function itself, which always exists
+	while( lua_getstack( L, high, &ar ) ) {
+		low = high;
+		high *= 2;
+	}
+
+	while( high - low > 1 ) {
+		int mid = (low + high) / 2;
+		if( lua_getstack( L, mid, &ar ) ) {
+			low = mid;
+		} else {
+			high = mid;
+		}
+	}
+
+	return low + 1;
+}
+
+/**\brief Lua hook function.
+ * \details The depth of the call is measured rather than counted from the
+ * hooks, as errors skip the return hooks. Any shadow frame at or below that
+ * depth was skipped by an error, so those are closed before the new call is
+ * opened.
+ */
+void Profiler::Hook( lua_State *L, lua_Debug *ar ) {
+	if( !running ) {
+		return;
+	}
+
+	Uint64 now = SDL_GetPerformanceCounter();
+	if( L != active ) {
+		Switch( L, now );
+	}
+
+	ProfileThread &thread = threads[L];
+	vector<ProfileFrame> &stack = thread.frames;
+	int depth = StackDepth( L );
+
+	if( ar->event == LUA_HOOKCALL ) {
+		lua_Debug caller;
+		const void *callerFunction = NULL;
+		int line = 0;
+		if( lua_getstack( L, 1, &caller ) ) {
+			lua_getinfo( L, "fl", &caller );
+			callerFunction = lua_topointer( L, -1 );
+			lua_pop( L, 1 );
+			line = caller.currentline;
+		}
+
+		// A tail call is reported one level deeper than where it ends up
+		// running, so a frame at this depth that is really the caller was
+		// tail called. Keep it open as part of the function that called it.
+		if( !stack.empty() && (stack.back().depth == depth) && (nodes[stack.back().node].function == callerFunction) ) {
+			stack.back().depth = depth - 1;
+		}
+
+		Unwind( stack, depth, now );
+
+		lua_getinfo( L, "f", ar );
+		const void *function = lua_topointer( L, -1 );
+		lua_pop( L, 1 );
+
+		if( names.find( function ) == names.end() ) {
+			names[function] = FunctionName( L, ar );
+		}
+
+		int parent = stack.empty() ? 0 : stack.back().node;
+		pair<const void*,int> key( function, line );
+		map<pair<const void*,int>,int>::iterator child = nodes[parent].children.find( key );
+		int node;
+		if( child == nodes[parent].children.end() ) {
+			node = nodes.size();
+			nodes.push_back( ProfileNode(parent, function, line) );
+			nodes[parent].children[key] = node;
+		} else {
+			node = child->second;
+		}
+
+		nodes[node].calls++;
+		thread.yielding = (function == yield);
+		stack.push_back( ProfileFrame(node, depth, SDL_GetPerformanceCounter()) );
+	} else if( ar->event == LUA_HOOKRET ) {
+		Unwind( stack, depth + 1, now );
+		if( !stack.empty() && (stack.back().depth == depth) ) {
+			Unwind( stack, depth, now );
+		}
+	}
+	// LUA_HOOKTAILRET is ignored, tail calls are closed along with their caller.
+}
+
+/**\brief Called when the hooks move from one lua_State to another.
+ * \details Either the previous thread resumed L, or it yielded or finished
+ * and control went back to whoever resumed it (possibly the engine).
+ */
+void Profiler::Switch( lua_State *L, Uint64 now ) {
+	lua_State *resumer = NULL;
+
+	if( active != NULL ) {
+		ProfileThread &previous = threads[active];
+
+		// The previous thread ran inside the resume calls of every thread that resumed it.
+		Uint64 segment = now - previous.activeSince;
+		for( lua_State *r = previous.resumer; r != NULL; r = threads[r].resumer ) {
+			if( !threads[r].frames.empty() ) {
+				threads[r].frames.back().childTime += segment;
+			}
+		}
+
+		if( previous.yielding || previous.frames.empty() ) {
+			previous.suspendedAt = now;
+			previous.resumer = NULL;
+		} else {
+			resumer = active;
+		}
+	}
+
+	ProfileThread &next = threads[L];
+	if( next.suspendedAt != 0 ) {
+		// Don't count the time this coroutine spent suspended.
+		for( vector<ProfileFrame>::iterator f = next.frames.begin(); f != next.frames.end(); ++f ) {
+			f->start += now - next.suspendedAt;
+		}
+		next.suspendedAt = 0;
+		next.yielding = false;
+		next.resumer = resumer;
+	} else if( next.frames.empty() ) {
+		next.resumer = resumer;
+	}
+
+	next.activeSince = now;
+	active = L;
+}
+
+/**\brief Close every frame at or deeper than depth.
+ */
+void Profiler::Unwind( vector<ProfileFrame> &stack, int depth, Uint64 now ) {
+	while( !stack.empty() && (stack.back().depth >= depth) ) {
+		ProfileFrame &frame = stack.back();
+		Uint64 total = now - frame.start;
+
+		nodes[frame.node].totalTime += total;
+		nodes[frame.node].selfTime += total - min(total, frame.childTime);
+
+		stack.pop_back();
+		if( !stack.empty() ) {
+			stack.back().childTime += total;
+		}
+	}
+}
+
+/**\brief Readable name of the function being called
+ */
+string Profiler::FunctionName( lua_State *L, lua_Debug *ar ) {
+	char buffer[256];
+
+	lua_getinfo( L, "Sn", ar );
+
+	if( ar->what != NULL && strcmp(ar->what, "C") == 0 ) {
+		snprintf( buffer, sizeof(buffer), "[C] %s", ar->name ? ar->name : "?" );
+	} else {
+		snprintf( buffer, sizeof(buffer), "%s (%s:%d)", ar->name ? ar->name : "?", ar->short_src, ar->linedefined );
+	}
+
+	return string( buffer );
+}
+
+/**\brief The path from the root to this node in flamegraph's folded format
+ */
+string Profiler::Folded( int node ) {
+	string path;
+
+	for( ; node > 0; node = nodes[node].parent ) {
+		string name = names[nodes[node].function];
+		replace( name.begin(), name.end(), ';', ',' );
+		replace( name.begin(), name.end(), ' ', '_' );
+		path = path.empty() ? name : (name + ";" + path);
+	}
+
+	return path;
+}
+
+// Caller function and line, and the function that was called
+typedef pair<pair<const void*,int>,const void*> CallSite;
+
+/**\brief Compare two report lines by time, largest first.
+ */
+static bool CompareTime( const pair<Uint64,string>& a, const pair<Uint64,string>& b ) {
+	return a.first > b.first;
+}
+
+/**\brief Write the collected data to the write directory.
+ * \param filename Report sorted by self time, plus the heaviest call sites
+ * \param foldedname Optional folded stacks for flamegraph.pl (in microseconds)
+ * \return true if the reports could be written
+ */
+bool Profiler::Report( const string& filename, const string& foldedname ) {
+	double toMS = 1000.0 / SDL_GetPerformanceFrequency();
+	char line[512];
+
+	// Aggregate the call tree by function and by call site.
+	// Recursive calls are only counted once in the total times.
+	map<const void*,ProfileNode> functions;
+	map<CallSite,ProfileNode> callsites;
+	Uint64 allTime = 0;
+
+	for( unsigned int n = 1; n < nodes.size(); ++n ) {
+		ProfileNode &node = nodes[n];
+
+		map<const void*,ProfileNode>::iterator func = functions.find( node.function );
+		if( func == functions.end() ) {
+			func = functions.insert( make_pair(node.function, ProfileNode(-1, node.function, 0)) ).first;
+		}
+		func->second.calls += node.calls;
+		func->second.selfTime += node.selfTime;
+		allTime += node.selfTime;
+
+		// Look for the same function, and the same call site, further up the tree.
+		bool recursive = false, recursiveSite = false;
+		for( int p = node.parent; p > 0; p = nodes[p].parent ) {
+			if( nodes[p].function == node.function ) {
+				recursive = true;
+				if( (nodes[p].line == node.line) && (nodes[nodes[p].parent].function == nodes[node.parent].function) ) {
+					recursiveSite = true;
+					break;
+				}
+			}
+		}
+		if( !recursive ) {
+			func->second.totalTime += node.totalTime;
+		}
+
+		// A call site is the caller's function and line, plus the function called there.
+		CallSite site( make_pair(nodes[node.parent].function, node.line), node.function );
+		map<CallSite,ProfileNode>::iterator cs = callsites.find( site );
+		if( cs == callsites.end() ) {
+			cs = callsites.insert( make_pair(site, ProfileNode(-1, node.function, node.line)) ).first;
+		}
+		cs->second.calls += node.calls;
+		cs->second.selfTime += node.selfTime;
+		if( !recursiveSite ) {
+			cs->second.totalTime += node.totalTime;
+		}
+	}
+
+	vector<pair<Uint64,string> > functionLines;
+	for( map<const void*,ProfileNode>::iterator i = functions.begin(); i != functions.end(); ++i ) {
+		snprintf( line, sizeof(line), "%10.3f %10.3f %6.2f%% %9u  %s\n",
+			i->second.selfTime * toMS,
+			i->second.totalTime * toMS,
+			allTime ? (100.0 * i->second.selfTime / allTime) : 0.0,
+			i->second.calls,
+			names[i->first].c_str() );
+		functionLines.push_back( make_pair(i->second.selfTime, string(line)) );
+	}
+	sort( functionLines.begin(), functionLines.end(), CompareTime );
+
+	vector<pair<Uint64,string> > callsiteLines;
+	for( map<CallSite,ProfileNode>::iterator i = callsites.begin(); i != callsites.end(); ++i ) {
+		snprintf( line, sizeof(line), "%10.3f %10.3f %9u  %s line %d -> %s\n",
+			i->second.selfTime * toMS,
+			i->second.totalTime * toMS,
+			i->second.calls,
+			names[i->first.first.first].c_str(),
+			i->first.first.second,
+			names[i->second.function].c_str() );
+		callsiteLines.push_back( make_pair(i->second.totalTime, string(line)) );
+	}
+	sort( callsiteLines.begin(), callsiteLines.end(), CompareTime );
+
+	string report = "Lua profile (times in milliseconds)\n\n";
+	report += "Functions by self time:\n";
+	report += "      self      total  self%     calls  function\n";
+	for( vector<pair<Uint64,string> >::iterator i = functionLines.begin(); i != functionLines.end(); ++i ) {
+		report += i->second;
+	}
+	report += "\nCall sites by total time:\n";
+	report += "      self      total     calls  caller -> callee\n";
+	for( vector<pair<Uint64,string> >::iterator i = callsiteLines.begin(); i != callsiteLines.end(); ++i ) {
+		report += i->second;
+	}
+
+	File reportFile;
+	if( !reportFile.OpenWrite( filename ) || !reportFile.Write( const_cast<char*>(report.c_str()), report.size() ) ) {
+		LogMsg(ERR, "Could not write the Lua profile to '%s'.", filename.c_str() );
+		return false;
+	}
+	LogMsg(INFO, "Wrote the Lua profile to '%s'.", filename.c_str() );
+
+	if( !foldedname.empty() ) {
+		string folded;
+		for( unsigned int n = 1; n < nodes.size(); ++n ) {
+			Uint64 us = static_cast<Uint64>( nodes[n].selfTime * toMS * 1000.0 );
+			if( us == 0 ) continue;
+			snprintf( line, sizeof(line), " %lu\n", static_cast<unsigned long>(us) );
+			folded += Folded( n ) + line;
+		}
+
+		File foldedFile;
+		if( !foldedFile.OpenWrite( foldedname ) || !foldedFile.Write( const_cast<char*>(folded.c_str()), folded.size() ) ) {
+			LogMsg(ERR, "Could not write the folded Lua stacks to '%s'.", foldedname.c_str() );
+			return false;
+		}
+		LogMsg(INFO, "Wrote the folded Lua stacks to '%s'.", foldedname.c_str() );
+	}
+
+	return true;
+}
+
+/**\brief Register Lua functions for the profiler.
+ */
+void Profiler::RegisterProfiler( lua_State *L ) {
+	// Call these like:
+	// Profiler.toggle()
+	static const luaL_Reg profilerFunctions[] = {
+		{"start", &Profiler::start},
+		{"stop", &Profiler::stop},
+		{"toggle", &Profiler::toggle},
+		{"reset", &Profiler::reset},
+		{"report", &Profiler::report},
+		{NULL, NULL}
+	};
+
+	luaL_openlib(L, EPIAR_PROFILER, profilerFunctions, 0);
+
+	lua_pop(L, 1);
+}
+
+/**\brief Starts the profiler (Lua callable).
+ */
+int Profiler::start( lua_State *L ) {
+	Start( Lua::CurrentState() );
+	return 0;
+}
+
+/**\brief Stops the profiler and writes the reports (Lua callable).
+ * \details Returns whether the reports could be written.
+ */
+int Profiler::stop( lua_State *L ) {
+	if( !running ) {
+		lua_pushboolean(L, false);
+		return 1;
+	}
+
+	Stop( Lua::CurrentState() );
+	lua_pushboolean(L, Report( PROFILER_REPORT, PROFILER_FOLDED ) );
+	return 1;
+}
+
+/**\brief Starts or stops the profiler, writing the reports when stopped (Lua callable).
+ * \details Returns a status line so that the Console can show it.
+ */
+int Profiler::toggle( lua_State *L ) {
+	if( running ) {
+		Stop( Lua::CurrentState() );
+		if( Report( PROFILER_REPORT, PROFILER_FOLDED ) ) {
+			lua_pushstring(L, "Profiler stopped. Wrote " PROFILER_REPORT " and " PROFILER_FOLDED ".");
+		} else {
+			lua_pushstring(L, "Profiler stopped. Could not write the report.");
+		}
+	} else {
+		Start( Lua::CurrentState() );
+		lua_pushstring(L, "Profiler started.");
+	}
+	return 1;
+}
+
+/**\brief Discards all profiling data (Lua callable).
+ */
+int Profiler::reset( lua_State *L ) {
+	Reset();
+	return 0;
+}
+
+/**\brief Writes the report (Lua callable).
+ * \details Profiler.report( [filename], [foldedFilename] )
+ */
+int Profiler::report( lua_State *L ) {
+	int n = lua_gettop(L);  // Number of arguments
+	if( n > 2 ) {
+		return luaL_error(L, "Got %d arguments expected 0, 1 or 2 (filename, foldedFilename)", n);
+	}
+
+	string filename = (n >= 1) ? luaL_checkstring(L, 1) : PROFILER_REPORT;
+	string foldedname = (n >= 2) ? luaL_checkstring(L, 2) : "";
+
+	lua_pushboolean(L, Report( filename, foldedname ) );
+	return 1;
+}
@@ -0,0 +1,89 @@
+/**\file			profiler.h
+ * \author			Christopher Thielen (chris@epiar.net)
+ * \date			Created: Sunday, October 18, 2026
+ * \date			Modified: Sunday, October 18, 2026
+ * \brief			Profiler for Lua scripts
+ * \details
+ */
+
+#ifndef __H_PROFILER__
+#define __H_PROFILER__
+
+#include "includes.h"
+#include "utilities/lua.h"
+
+#define EPIAR_PROFILER "Profiler"
+
+// Default names of the reports, relative to the PhysFS write directory
+#define PROFILER_REPORT "profile.txt"
+#define PROFILER_FOLDED "profile.folded"
+
+class ProfileNode {
+	public:
+		ProfileNode( int _parent, const void *_function, int _line );
+
+		int parent; ///< Index of the calling node, -1 for the root
+		const void *function; ///< Identity of the Lua or C function
+		int line; ///< Line in the caller that made this call
+		Uint32 calls;
+		Uint64 selfTime;
+		Uint64 totalTime;
+		map<pair<const void*,int>,int> children;
+};
+
+class ProfileFrame {
+	public:
+		ProfileFrame( int _node, int _depth, Uint64 _start )
+			:node(_node), depth(_depth), start(_start), childTime(0) {}
+
+		int node;
+		int depth;
+		Uint64 start;
+		Uint64 childTime;
+};
+
+class ProfileThread {
+	public:
+		ProfileThread()
+			:resumer(NULL), activeSince(0), suspendedAt(0), yielding(false) {}
+
+		vector<ProfileFrame> frames;
+		lua_State *resumer; ///< Thread that resumed this coroutine, if it is still running
+		Uint64 activeSince;
+		Uint64 suspendedAt;
+		bool yielding;
+};
+
+class Profiler {
+	public:
+		static void Start( lua_State *L );
+		static void Stop( lua_State *L );
+		static void Reset();
+		static bool IsRunning() { return running; }
+
+		static bool Report( const string& filename = PROFILER_REPORT, const string& foldedname = "" );
+
+		// Lua functionality
+		static void RegisterProfiler( lua_State *L );
+		static int start( lua_State *L );
+		static int stop( lua_State *L );
+		static int toggle( lua_State *L );
+		static int reset( lua_State *L );
+		static int report( lua_State *L );
+
+	private:
+		static void Hook( lua_State *L, lua_Debug *ar );
+		static void Switch( lua_State *L, Uint64 now );
+		static void Unwind( vector<ProfileFrame> &stack, int depth, Uint64 now );
+		static string FunctionName( lua_State *L, lua_Debug *ar );
+		static string Folded( int node );
+
+		static bool running;
+		static vector<ProfileNode> nodes;
+		static map<lua_State*,ProfileThread> threads;
+		static lua_State *active;
+		static const void *yield;
+		static map<const void*,string> names;
+};
+
+#endif // __H_PROFILER__
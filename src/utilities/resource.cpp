@@ -1,21 +1,26 @@
 /**\file			resource.cpp
  * \author			Matt Zweig
  * \date			Created: Saturday, December 19, 2009
- * \date			Modified: Saturday, December 19, 2009
+ * \date			Modified: Monday, October 19, 2026
  * \brief
  * \details
  */
 
 #include "includes.h"
+#include "common.h"
+#include "utilities/log.h"
 #include "utilities/resource.h"
 
+// Resources used this recently are never evicted, even when over budget
+#define RESOURCE_MIN_AGE 5000
+
 /** \class Resource
  *  \brief Memory Management Superclass used to prevent duplications
  *  \details The Resource class provides a simple way to use Memory efficiently
  *  without having duplicate instances of the same object.  Resources are
  *  stored using a key (usually a path) and a pointer to the concrete object
  *  allocated on the heap.  This key is then stored into a master lookup table
- *  (an STL map) so that it can be retrieved later.  From then on, any attempt
+ *  (a hash table) so that it can be retrieved later.  From then on, any attempt
  *  to access that object will not have to load the object.
  *
  *  All Resource subclasses should implement their own static "Get" function.
@@ -29,9 +34,17 @@
  *  can point to the same Resource.  For example, a model image might be stored
  *  as both the relative path and the model's name.
  *
- *  \note Currently, Resources are never freed.  The assumption here is that
- *  all Resouces will be used again in the lifetime of the game.  This may
- *  change in later versions of Epiar.
+ *  Subclasses report how much memory they hold with SetBytes. When all of it
+ *  together is over "options/memory/resource-budget" megabytes, Trim lets go
+ *  of the memory of the Resources that were used the longest time ago, by
+ *  calling their Evict. The Resource objects themselves are never freed, as
+ *  pointers to them are kept everywhere; an evicted Resource loads itself
+ *  again the next time that it is used. Resources that have been Acquired,
+ *  or that were used in the last few seconds, are never evicted. Decoded
+ *  sounds also have a budget of their own, "options/memory/sound-budget".
+ *
+ *  Code that uses the same Resource every frame should keep a ResourceHandle
+ *  to it rather than Get it by name each time.
  *
  *  \warning There is only one main resource lookup table.  If different
  *  Resource subclasses attempt to use the same key for different objects then
@@ -43,31 +56,226 @@
 /** \brief The Master Resource Map.
  *  \warning This map is shared by all Resource subclasses.
  */
-map<string, Resource*> Resource::values;
+unordered_map<string, Resource*> Resource::values;
+
+/** \brief Every stored Resource, once each.
+ */
+vector<Resource*> Resource::stored;
+
+/** \brief Guards the Master Resource Map, and the memory accounting.
+ */
+SDL_SpinLock Resource::lock = 0;
+
+ResourceStats Resource::stats;
 
 /** \brief Empty Resource constructor.
  */
-Resource::Resource() {
+Resource::Resource()
+	:references(0)
+	,lastUsed(0)
+	,bytes(0)
+	,type(RESOURCE_TEXTURE)
+	,counted(true)
+	,isStored(false)
+	,transient(false)
+{
+}
+
+/** \brief Forgets the memory of the Resource.
+ */
+Resource::~Resource() {
+	SetBytes( type, 0 );
 }
 
 /** \brief Store a Resource given a Key and pointer.
- *  \warning, attempting to store multiple resources using the same key will
- *  cause the previous object to be lost.
- *  \TODO Ensure that keys are not reused for different Resource objects.
- *  \TODO Fix potential memory leak.
+ *  \details A key keeps the first Resource that was stored under it. When two
+ *  threads load the same missing key, the one that stores second gets the
+ *  other's Resource back, and should delete its own.
+ *  \returns The Resource stored under the key.
  */
-void Resource::Store(string key,Resource *res) {
+Resource* Resource::Store(const string& key,Resource *res) {
 	assert(key != ""); // No Empty Keys!
-	values.insert(make_pair(key,res));
+	SDL_AtomicLock( &lock );
+	pair<unordered_map<string,Resource*>::iterator,bool> inserted = values.insert(make_pair(key,res));
+	if( !inserted.second ) {
+		res = inserted.first->second;
+	} else if( !res->isStored ) {
+		res->isStored = true;
+		stored.push_back( res );
+		stats.count++;
+	}
+	SDL_AtomicUnlock( &lock );
+
+	return res;
 }
 
 /** \brief Retrieve a stored Resource
  *  \returns The Resource pointer or NULL.
  */
-Resource* Resource::Get(string path) {
-	map<string,Resource*>::iterator val = values.find( path );
+Resource* Resource::Get(const string& path) {
+	Resource *res = NULL;
+
+	SDL_AtomicLock( &lock );
+	unordered_map<string,Resource*>::iterator val = values.find( path );
 	if( val != values.end() ){
-		return val->second;
-	} 
-	return NULL;
+		res = val->second;
+		stats.hits++;
+	} else {
+		stats.misses++;
+	}
+	SDL_AtomicUnlock( &lock );
+
+	if( res ) {
+		res->Touch();
+	}
+
+	return res;
+}
+
+/** \brief Keeps the Resource from being evicted, until it is Released.
+ */
+void Resource::Acquire( void ) {
+	SDL_AtomicLock( &lock );
+	references++;
+	SDL_AtomicUnlock( &lock );
+}
+
+/** \brief Lets the Resource be evicted again, once nothing else has Acquired it.
+ */
+void Resource::Release( void ) {
+	SDL_AtomicLock( &lock );
+	assert( references > 0 );
+	references--;
+	SDL_AtomicUnlock( &lock );
+}
+
+/** \brief Sets how much memory this Resource holds.
+ */
+void Resource::SetBytes( ResourceType _type, Sint64 _bytes ) {
+	SDL_AtomicLock( &lock );
+	if( counted ) {
+		stats.bytes[type] -= bytes;
+	}
+	type = _type;
+	bytes = _bytes;
+	counted = true;
+	stats.bytes[type] += bytes;
+	SDL_AtomicUnlock( &lock );
+}
+
+/** \brief Sets how much memory this Resource uses, without counting it.
+ *  \details For memory that several Resources share, which whatever owns it
+ *  counts once with Account. The bytes still let Trim pick this Resource,
+ *  and Trim only counts what evicting it actually let go of.
+ */
+void Resource::SetShare( ResourceType _type, Sint64 _bytes ) {
+	SDL_AtomicLock( &lock );
+	if( counted ) {
+		stats.bytes[type] -= bytes;
+	}
+	type = _type;
+	bytes = _bytes;
+	counted = false;
+	SDL_AtomicUnlock( &lock );
+}
+
+/** \brief Counts memory that isn't held by any one Resource, such as the
+ *  texture Atlas or the SoundBank's buffers.
+ */
+void Resource::Account( ResourceType type, Sint64 bytes ) {
+	SDL_AtomicLock( &lock );
+	stats.bytes[type] += bytes;
+	SDL_AtomicUnlock( &lock );
+}
+
+/** \brief Counts an evicted Resource that had to be loaded again.
+ */
+void Resource::CountReload( void ) {
+	SDL_AtomicLock( &lock );
+	stats.reloads++;
+	SDL_AtomicUnlock( &lock );
+}
+
+/** \brief Sorts the least recently used Resources first.
+ */
+static bool LeastRecentlyUsed( const pair<Uint32,Resource*>& a, const pair<Uint32,Resource*>& b ) {
+	return a.first < b.first;
+}
+
+/** \brief Evicts the least recently used Resources until the memory is within budget.
+ *  \details Textures can only be destroyed on the render thread, and Sounds
+ *  must not be played meanwhile, so call this from the render thread while
+ *  the world is locked. Transient Resources go first.
+ */
+void Resource::Trim( void ) {
+	Sint64 budget = static_cast<Sint64>( OPTION( int, "options/memory/resource-budget" ) ) * 1024 * 1024;
+	Sint64 soundBudget = static_cast<Sint64>( OPTION( int, "options/memory/sound-budget" ) ) * 1024 * 1024;
+	Sint64 total = 0, sounds;
+	Uint32 now = SDL_GetTicks();
+	vector< pair<Uint32,Resource*> > candidates;
+	vector< pair<Uint32,Resource*> >::iterator i;
+	vector<Resource*>::iterator r;
+	int t;
+
+	SDL_AtomicLock( &lock );
+	stats.budget = budget;
+	stats.soundBudget = soundBudget;
+	for( t = 0; t < RESOURCE_TYPES; t++ ) {
+		total += stats.bytes[t];
+	}
+	sounds = stats.bytes[RESOURCE_PCM];
+	if( ( budget <= 0 || total <= budget ) && ( soundBudget <= 0 || sounds <= soundBudget ) ) {
+		SDL_AtomicUnlock( &lock );
+		return;
+	}
+
+	for( r = stored.begin(); r != stored.end(); ++r ) {
+		if( (*r)->references == 0 && (*r)->bytes > 0
+		    && ( (*r)->transient || now - (*r)->lastUsed > RESOURCE_MIN_AGE ) ) {
+			candidates.push_back( make_pair( (*r)->transient ? 0 : (*r)->lastUsed, *r ) );
+		}
+	}
+	SDL_AtomicUnlock( &lock );
+
+	sort( candidates.begin(), candidates.end(), LeastRecentlyUsed );
+
+	for( i = candidates.begin(); i != candidates.end(); ++i ) {
+		bool overall = budget > 0 && total > budget;
+		bool sound = soundBudget > 0 && sounds > soundBudget;
+
+		if( !overall && !sound ) {
+			break;
+		}
+		if( !overall && i->second->type != RESOURCE_PCM ) {
+			continue; // Only the sounds are over budget
+		}
+
+		if( i->second->Evict() ) {
+			// A shared buffer is only let go of by the last Sound that used it
+			SDL_AtomicLock( &lock );
+			stats.evictions++;
+			total = 0;
+			for( t = 0; t < RESOURCE_TYPES; t++ ) {
+				total += stats.bytes[t];
+			}
+			sounds = stats.bytes[RESOURCE_PCM];
+			SDL_AtomicUnlock( &lock );
+		}
+	}
+
+	if( budget > 0 && total > budget ) {
+		LogMsg(DEBUG, "Resources use %d KB, over the budget of %d KB.", (int)( total / 1024 ), (int)( budget / 1024 ) );
+	}
+}
+
+/** \brief How well the Resources are being reused, and how much memory they hold.
+ */
+ResourceStats Resource::GetStats( void ) {
+	ResourceStats copy;
+
+	SDL_AtomicLock( &lock );
+	copy = stats;
+	SDL_AtomicUnlock( &lock );
+
+	return copy;
 }
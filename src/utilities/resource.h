@@ -2,8 +2,8 @@
  * Filename      : resource.h
  * Author(s)     : Matt Zweig
  * Date Created  : Saturday, December 19, 2009
- * Last Modified : Saturday, December 19, 2009
- * Purpose       : 
+ * Last Modified : Monday, October 19, 2026
+ * Purpose       :
  * Notes         :
  */
 
@@ -12,13 +12,91 @@
 #ifndef __H_RESOURCE_CLASS
 #define __H_RESOURCE_CLASS
 
+// What the memory of a Resource is spent on
+typedef enum {
+	RESOURCE_TEXTURE, ///< Texture memory
+	RESOURCE_PCM,     ///< Decoded sound
+	RESOURCE_TYPES
+} ResourceType;
+
+typedef struct {
+	Uint32 hits;       ///< Gets that found the Resource
+	Uint32 misses;     ///< Gets that had to load it
+	Uint32 evictions;  ///< Resources that were let go to stay within the budget
+	Uint32 reloads;    ///< Evicted Resources that were needed again
+	int count;         ///< Resources stored
+	Sint64 bytes[RESOURCE_TYPES];
+	Sint64 budget;     ///< 0 if there is no budget
+	Sint64 soundBudget; ///< For the RESOURCE_PCM alone; 0 if there is no budget
+} ResourceStats;
+
 class Resource{
 	public:
 		Resource();
-		static void Store(string key, Resource* res);
-		static Resource* Get(string path);
+		virtual ~Resource();
+		static Resource* Store(const string& key, Resource* res);
+		static Resource* Get(const string& path);
+
+		void Acquire( void );
+		void Release( void );
+		void Touch( void ) { lastUsed = SDL_GetTicks(); }
+
+		// Start loading whatever isn't loaded yet, without waiting for it
+		virtual void Prefetch( void ) {}
+
+		static void Trim( void );
+		static void Account( ResourceType type, Sint64 bytes );
+		static ResourceStats GetStats( void );
+
+	protected:
+		void SetBytes( ResourceType type, Sint64 bytes );
+		// Like SetBytes, for memory that is counted by whatever shares it
+		void SetShare( ResourceType type, Sint64 bytes );
+		// Transient Resources are evicted first, however recently they were used
+		void SetTransient( bool _transient ) { transient = _transient; }
+		static void CountReload( void );
+
+		// Let go of whatever can be loaded again; false if nothing could be
+		virtual bool Evict( void ) { return false; }
+
+	private:
+		static unordered_map<string,Resource*> values;
+		static vector<Resource*> stored; ///< Each Resource once, however many keys it has
+		static SDL_SpinLock lock; ///< Components are parsed on several threads at once
+		static ResourceStats stats;
+
+		int references; ///< Resources that are referenced are never evicted
+		Uint32 lastUsed;
+		Sint64 bytes;
+		ResourceType type;
+		bool counted; ///< false if the bytes are counted elsewhere, such as by the SoundBank
+		bool isStored;
+		bool transient;
+};
+
+/**\brief A Resource that is looked up the first time that it is used.
+ * \details Keep one as a static wherever the same Resource is used every
+ *          frame, so that using it doesn't build a string or search the
+ *          Resource table. Resources are never freed, so the pointer stays
+ *          good; evicted Resources load themselves again.
+ */
+template<class T> class ResourceHandle {
+	public:
+		ResourceHandle( const char *_path ) :path(_path), resource(NULL) {}
+
+		T* Get( void ) {
+			if( resource == NULL ) {
+				resource = T::Get( path );
+			}
+			return resource;
+		}
+
+		T* operator->( void ) { return Get(); }
+		operator T*( void ) { return Get(); }
+
 	private:
-		static map<string,Resource*> values;
+		const char *path;
+		T* resource;
 };
 
 #endif // __H_RESOURCE__
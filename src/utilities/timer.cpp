@@ -17,6 +17,7 @@ Uint32 Timer::lastLoopLength = 0;
 Uint32 Timer::lastLoopTick = SDL_GetTicks();
 double Timer::frames = 0.;
 double Timer::fframe = 0.;
+double Timer::logicFPS = LOGIC_FPS;
 Uint32 Timer::logicalFrameCount = 0;
 int Timer::lastLogicalLoops = 0;
 int Timer::delayMS = INITIAL_DELAY;
@@ -31,6 +32,7 @@ void Timer::Initialize( void ) {
 	lastLoopTick = SDL_GetTicks();
 	Uint32 fps = OPTION( Uint32, "options/video/fps" );
 	if( fps > 0 ) desiredFPS = fps;
+	SetLogicFPS( OPTION( double, "options/timing/logic-fps" ) );
 }
 
 // Updates the Timer class and returns the number of logical loops to run.
@@ -43,7 +45,7 @@ int Timer::Update( void ) {
 	if(pausedAt > 0) { pauseDelay += lastLoopLength; }
 
 	double dt = (double)lastLoopLength / 1000.0f;
-	double new_frames = dt * LOGIC_FPS;
+	double new_frames = dt * logicFPS;
 
 	int logical_loops = static_cast<int>(floor(frames + new_frames) - floor(frames));
 	frames += new_frames;
@@ -101,7 +103,28 @@ void Timer::Delay() {
 }
 
 double Timer::GetDelta( void ) {
-	return LOGIC_FPS * 0.001f;
+	return LOGIC_FPS * 0.001f * GetTimeScale();
+}
+
+// Returns the number of logical frames run per second.
+double Timer::GetLogicFPS( void ) {
+	return logicFPS;
+}
+
+// Changes the number of logical frames run per second.
+// Fewer logical frames save CPU; the screen is still drawn at the video
+// frame rate, in between the logical frames.
+void Timer::SetLogicFPS( double fps ) {
+	if( fps < LOGIC_FPS_MIN ) fps = LOGIC_FPS_MIN;
+	if( fps > LOGIC_FPS_MAX ) fps = LOGIC_FPS_MAX;
+
+	logicFPS = fps;
+}
+
+// Returns how much longer a logical frame is than one at LOGIC_FPS.
+// Velocities are per LOGIC_FPS frame, so movement is multiplied by this.
+double Timer::GetTimeScale( void ) {
+	return LOGIC_FPS / logicFPS;
 }
 
 Uint32 Timer::GetLogicalFrameCount( void ) {
@@ -10,8 +10,12 @@
 #define __h_timer__
 
 /* DO NOT CHANGE LOGIC_FPS. THE VELOCITIES IN THIS GAME ARE BASED ON A LOGICAL FPS of 30 / s.
- * THIS IS THE GAME LOGIC RATE, NOT THE VIDEO FRAME RATE! */
+ * THIS IS THE GAME LOGIC RATE, NOT THE VIDEO FRAME RATE!
+ * To run the logic at another rate use Timer::SetLogicFPS, which scales
+ * movement by Timer::GetTimeScale so that velocities keep their meaning. */
 #define LOGIC_FPS     30.0
+#define LOGIC_FPS_MIN 10.0
+#define LOGIC_FPS_MAX 120.0
 #define INITIAL_DELAY 5
 
 #include "includes.h"
@@ -25,6 +29,9 @@ class Timer {
 		static Uint32 GetRealTicks( void );
 		static double GetFFrame( void );
 		static double GetDelta( void );
+		static double GetLogicFPS( void );
+		static void SetLogicFPS( double fps );
+		static double GetTimeScale( void );
 		static Uint32 GetLogicalFrameCount( void );
 		static void Pause( void );
 		static void Unpause( void );
@@ -37,6 +44,7 @@ class Timer {
 		static Uint32 logicalFrameCount;
 		static double frames; // running count of total logic frames that should have occurred
 		static double fframe;
+		static double logicFPS; // the rate that the logic is actually run at
 		static int lastLogicalLoops;
 		static int delayMS;
 		static Uint32 desiredFPS;
@@ -45,7 +45,7 @@ bool XMLFile::New( const string& rootName ) {
 }
 
 bool XMLFile::Open( const string& filename ) {
-	char *buf = NULL;
+	const char *buf = NULL;
 	long bufSize = 0;
 	File xmlfile;
 
@@ -54,7 +54,7 @@ bool XMLFile::Open( const string& filename ) {
 		return( false );
 	}
 
-	buf = xmlfile.Read();
+	buf = xmlfile.Map();
 	bufSize = xmlfile.GetLength();
 	if( buf == NULL ) {
 		LogMsg(ERR, "Could not load XML from archive. Buffer failed to allocate." );
@@ -62,7 +62,6 @@ bool XMLFile::Open( const string& filename ) {
 	}
 
 	xmlPtr = xmlParseMemory( buf, bufSize );
-	delete [] buf;
 
 	this->filename.assign( filename );
 
@@ -79,7 +78,7 @@ bool XMLFile::Save() {
 	xmlChar *xmlbuff;
 	int buffersize;
 	xmlDocDumpFormatMemory( xmlPtr, &xmlbuff, &buffersize, 1 );
-	File saved = File( filename.c_str(), true );
+	File saved( filename.c_str(), true );
 	if(saved.Write( (char *)xmlbuff, buffersize ) != true) {
 		LogMsg(ERR, "Could not save XML\n");
 	}
@@ -94,7 +93,7 @@ bool XMLFile::Save( const string& filename ) {
 	xmlChar *xmlbuff;
 	int buffersize;
 	xmlDocDumpFormatMemory( xmlPtr, &xmlbuff, &buffersize, 1 );
-	File saved = File( filename.c_str(), true );
+	File saved( filename.c_str(), true );
 	if(saved.Write( (char *)xmlbuff, buffersize ) != true) {
 		LogMsg(ERR, "Could not save XML\n");
 	}